@@ -0,0 +1,166 @@
+#include "BindException.hpp"
+#include "IllegalArgumentException.hpp"
+
+namespace midnight
+{
+    template<typename T, GLenum PolyType>
+    ArenaVertexBuffer<T, PolyType>::ArenaVertexBuffer(BufferArena& arena, const T* data, std::size_t count, std::size_t stride) :
+        VertexBuffer<T>(std::vector<T>()),
+        arena(arena),
+        stride(stride),
+        range(0),
+        count(0),
+        recorded(0)
+    {
+        allocate(data, count);
+    }
+
+    template<typename T, GLenum PolyType>
+    ArenaVertexBuffer<T, PolyType>::ArenaVertexBuffer(BufferArena& arena, const std::vector<T>& data, std::size_t stride) :
+        ArenaVertexBuffer(arena, data.data(), data.size(), stride)
+    {
+
+    }
+
+    template<typename T, GLenum PolyType>
+    void ArenaVertexBuffer<T, PolyType>::allocate(const T* data, std::size_t count)
+    {
+        const BufferArena::Handle range = arena.allocate(sizeof(T) * count, stride);
+        arena.upload(range, data, sizeof(T) * count);
+        this->range = range;
+        this->count = count;
+    }
+
+    template<typename T, GLenum PolyType>
+    BufferArena::Handle ArenaVertexBuffer<T, PolyType>::getRange() const noexcept
+    {
+        return range;
+    }
+
+    template<typename T, GLenum PolyType>
+    GLint ArenaVertexBuffer<T, PolyType>::getBaseVertex() const noexcept
+    {
+        return arena.getBaseVertex(range, stride);
+    }
+
+    template<typename T, GLenum PolyType>
+    std::size_t ArenaVertexBuffer<T, PolyType>::vertexCount()
+    {
+        return count / detail::PolySize<PolyType>::size();
+    }
+
+    template<typename T, GLenum PolyType>
+    void ArenaVertexBuffer<T, PolyType>::setVertexData(std::vector<T>&& data)
+    {
+        setVertexData(static_cast<const std::vector<T>&>(data));
+    }
+
+    template<typename T, GLenum PolyType>
+    void ArenaVertexBuffer<T, PolyType>::setVertexData(const std::vector<T>& data)
+    {
+        if(vertexArrays.contains(GLState::current().getVertexArray()))
+        {
+            throw midnight::glsl::BindException("Unable to rebuffer arena vertex buffer, as it actively bound");
+        }
+        if(data.size() == count)
+        {
+            arena.upload(range, data.data(), sizeof(T) * count);
+            return;
+        }
+
+        /// The new range is allocated before the old one is released, so a failure leaves the old data intact
+        const BufferArena::Handle previous = range;
+        allocate(data.data(), data.size());
+        arena.release(previous);
+    }
+
+    template<typename T, GLenum PolyType>
+    void ArenaVertexBuffer<T, PolyType>::updateVertexData(std::size_t offset, const T* data, std::size_t count)
+    {
+        if(offset > this->count || count > this->count - offset)
+        {
+            throw IllegalArgumentException("Unable to update arena vertex buffer, as the range exceeds its size");
+        }
+        if(count != 0)
+        {
+            arena.upload(range, data, sizeof(T) * count, sizeof(T) * offset);
+        }
+    }
+
+    template<typename T, GLenum PolyType>
+    void ArenaVertexBuffer<T, PolyType>::flush(bool /*orphan*/)
+    {
+    }
+
+    template<typename T, GLenum PolyType>
+    void ArenaVertexBuffer<T, PolyType>::bind()
+    {
+        const GLuint programHandle = GLState::current().getProgram();
+        if(programHandle == 0)
+        {
+            throw midnight::glsl::BindException("A program must first be bound before binding an ArenaVertexBuffer");
+        }
+
+        /// The range has been reallocated in another buffer object
+        const GLuint buffer = arena.getBuffer(range);
+        if(buffer != recorded)
+        {
+            vertexArrays.clear();
+            recorded = buffer;
+        }
+        vertexArrays.bind(programHandle, buffer, attributes);
+    }
+
+    template<typename T, GLenum PolyType>
+    void ArenaVertexBuffer<T, PolyType>::unbind() noexcept
+    {
+        /// Our attribute state lives in the vertex arrays, so restoring the default one undoes all of it
+        GLState::current().bindVertexArray(0);
+    }
+
+    template<typename T, GLenum PolyType>
+    void ArenaVertexBuffer<T, PolyType>::resetAttributes() noexcept
+    {
+        attributes.clear();
+        vertexArrays.clear();
+    }
+
+    template<typename T, GLenum PolyType>
+    void ArenaVertexBuffer<T, PolyType>::addAttributePointer(const std::string& name,
+        GLint size,
+        GLenum type,
+        GLboolean normalized,
+        GLsizei stride,
+        const GLvoid* offset)
+    {
+        attributes.push_back(std::unique_ptr<detail::AttributePointerBase>(new detail::AttributePointer(name, size, type, normalized, stride, offset)));
+        vertexArrays.clear();
+    }
+
+    template<typename T, GLenum PolyType>
+    void ArenaVertexBuffer<T, PolyType>::addAttributeIPointer(const std::string& name,
+        GLint size,
+        GLenum type,
+        GLsizei stride,
+        const GLvoid* offset)
+    {
+        attributes.push_back(std::unique_ptr<detail::AttributePointerBase>(new detail::AttributeIPointer(name, size, type, stride, offset)));
+        vertexArrays.clear();
+    }
+
+    template<typename T, GLenum PolyType>
+    void ArenaVertexBuffer<T, PolyType>::addAttributeLPointer(const std::string& name,
+        GLint size,
+        GLsizei stride,
+        const GLvoid* offset)
+    {
+        attributes.push_back(std::unique_ptr<detail::AttributePointerBase>(new detail::AttributeLPointer(name, size, GL_DOUBLE, stride, offset)));
+        vertexArrays.clear();
+    }
+
+    template<typename T, GLenum PolyType>
+    ArenaVertexBuffer<T, PolyType>::~ArenaVertexBuffer()
+    {
+        arena.release(range);
+    }
+}
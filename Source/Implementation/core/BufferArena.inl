@@ -0,0 +1,258 @@
+#include <algorithm>
+
+#include "GLState.hpp"
+#include "IllegalArgumentException.hpp"
+#include "ResourceException.hpp"
+
+namespace midnight
+{
+    namespace detail
+    {
+        /**
+         * A helper class utilizing RAII to bind a buffer object to one of the copy targets, which leaves the
+         * vertex and element bindings of the caller untouched
+         *
+         */
+        struct CopyBufferBindHelper
+        {
+            GLenum target;
+            GLuint preserved;
+
+            CopyBufferBindHelper(GLenum target, GLuint handle) :
+                target(target),
+                preserved(GLState::current().getBuffer(target))
+            {
+                /// Call should never fail
+                GLState::current().bindBuffer(target, handle);
+            }
+
+            ~CopyBufferBindHelper()
+            {
+                /// Call should never fail
+                GLState::current().bindBuffer(target, preserved);
+            }
+        };
+    }
+
+    inline BufferArena::BufferArena(std::size_t arenaSize, GLenum usage) :
+        usage(usage),
+        arenaSize(arenaSize)
+    {
+        if(arenaSize == 0)
+        {
+            throw IllegalArgumentException("The buffer objects of a BufferArena can not be empty");
+        }
+    }
+
+    inline GLuint BufferArena::createBuffer(std::size_t size) const
+    {
+        GLuint buffer;
+        glGenBuffers(1, &buffer);
+        detail::CopyBufferBindHelper helper(GL_COPY_WRITE_BUFFER, buffer);
+
+        /// Can set GL_OUT_OF_MEMORY
+        /// https://www.opengl.org/sdk/docs/man4/xhtml/glBufferData.xml
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(size), nullptr, usage);
+        if(glGetError() == GL_OUT_OF_MEMORY)
+        {
+            GLState::current().deleteBuffer(buffer);
+            throw ResourceException("Unable to allocate GPU memory for BufferArena");
+        }
+        return buffer;
+    }
+
+    inline BufferArena::Handle BufferArena::allocate(std::size_t size, std::size_t alignment)
+    {
+        /// Checked before any buffer object is created for the allocation
+        if(size == 0 || alignment == 0)
+        {
+            throw IllegalArgumentException("A BufferArena can not allocate an empty or unaligned range");
+        }
+
+        Allocation allocation{0, 0, size, alignment};
+        bool placed = false;
+        for(std::size_t i = 0; i < arenas.size() && !placed; ++i)
+        {
+            placed = arenas[i].allocator.allocate(size, alignment, allocation.offset);
+            allocation.arena = i;
+        }
+        if(!placed)
+        {
+            /// An allocation larger than the usual buffer object gets one of its own (at offset 0, which any 
+            /// alignment divides)
+            const std::size_t capacity = std::max(arenaSize, size);
+            Arena arena{0, RangeAllocator(capacity)};
+            if(!arena.allocator.allocate(size, alignment, allocation.offset))
+            {
+                throw ResourceException("Unable to place an allocation in a new buffer object of BufferArena");
+            }
+            arena.buffer = createBuffer(capacity);
+            arenas.push_back(std::move(arena));
+            allocation.arena = arenas.size() - 1;
+        }
+
+        if(!releasedHandles.empty())
+        {
+            const Handle handle = releasedHandles.back();
+            releasedHandles.pop_back();
+            allocations[handle] = allocation;
+            return handle;
+        }
+        allocations.push_back(allocation);
+        return allocations.size() - 1;
+    }
+
+    inline void BufferArena::release(Handle handle)
+    {
+        Allocation& allocation = allocations[handle];
+        if(allocation.size == 0)
+        {
+            return;
+        }
+        arenas[allocation.arena].allocator.release(allocation.offset, allocation.size);
+        allocation.size = 0;
+        releasedHandles.push_back(handle);
+    }
+
+    inline void BufferArena::upload(Handle handle, const void* data, std::size_t size, std::size_t offset)
+    {
+        const Allocation& allocation = allocations[handle];
+        if(offset > allocation.size || size > allocation.size - offset)
+        {
+            throw IllegalArgumentException("Unable to upload to BufferArena, as the data exceeds its range");
+        }
+        detail::CopyBufferBindHelper helper(GL_COPY_WRITE_BUFFER, arenas[allocation.arena].buffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(allocation.offset + offset), static_cast<GLsizeiptr>(size), data);
+    }
+
+    inline void BufferArena::moveWithin(GLuint buffer, std::size_t from, std::size_t to, std::size_t size, GLuint scratch) const
+    {
+        detail::CopyBufferBindHelper read(GL_COPY_READ_BUFFER, buffer);
+        detail::CopyBufferBindHelper write(GL_COPY_WRITE_BUFFER, buffer);
+        if(from - to >= size)
+        {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(from), static_cast<GLintptr>(to), 
+                static_cast<GLsizeiptr>(size));
+            return;
+        }
+
+        /// Overlapping ranges of one buffer object may not be copied between, so they go through the scratch buffer
+        GLState::current().bindBuffer(GL_COPY_WRITE_BUFFER, scratch);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(from), 0, static_cast<GLsizeiptr>(size));
+        GLState::current().bindBuffer(GL_COPY_READ_BUFFER, scratch);
+        GLState::current().bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, static_cast<GLintptr>(to), static_cast<GLsizeiptr>(size));
+    }
+
+    inline bool BufferArena::defragment()
+    {
+        /// The live allocations of each buffer object, in the order of their offsets
+        std::vector<std::vector<Handle>> residents(arenas.size());
+        for(Handle handle = 0; handle < allocations.size(); ++handle)
+        {
+            if(allocations[handle].size != 0)
+            {
+                residents[allocations[handle].arena].push_back(handle);
+            }
+        }
+
+        /// Every buffer object is repacked before anything is changed, so that a failure leaves this BufferArena 
+        /// as it was
+        std::vector<RangeAllocator> allocators;
+        std::vector<std::vector<std::size_t>> offsets(arenas.size());
+        std::size_t scratchSize = 0;
+        for(std::size_t i = 0; i < arenas.size(); ++i)
+        {
+            std::sort(residents[i].begin(), residents[i].end(), [this](Handle a, Handle b)
+            {
+                return allocations[a].offset < allocations[b].offset;
+            });
+
+            /// Repacked in order of offset, every allocation lands at or below where it was, so all of them fit
+            allocators.emplace_back(arenas[i].allocator.getCapacity());
+            for(Handle handle : residents[i])
+            {
+                const Allocation& allocation = allocations[handle];
+                std::size_t offset = 0;
+                allocators.back().allocate(allocation.size, allocation.alignment, offset);
+                offsets[i].push_back(offset);
+                if(offset != allocation.offset && allocation.offset - offset < allocation.size)
+                {
+                    scratchSize = std::max(scratchSize, allocation.size);
+                }
+            }
+        }
+
+        /// The allocations move within their buffer object, so only the largest one that overlaps its new range 
+        /// needs to be copied aside, rather than a whole buffer object.  GL executes the copies in order, after 
+        /// the draws that were issued before.
+        const GLuint scratch = scratchSize != 0 ? createBuffer(scratchSize) : 0;
+        bool moved = false;
+        std::vector<Arena> compacted;
+        for(std::size_t i = 0; i < arenas.size(); ++i)
+        {
+            if(residents[i].empty())
+            {
+                GLState::current().deleteBuffer(arenas[i].buffer);
+                continue;
+            }
+            for(std::size_t j = 0; j < residents[i].size(); ++j)
+            {
+                Allocation& allocation = allocations[residents[i][j]];
+                if(offsets[i][j] != allocation.offset)
+                {
+                    moveWithin(arenas[i].buffer, allocation.offset, offsets[i][j], allocation.size, scratch);
+                    allocation.offset = offsets[i][j];
+                    moved = true;
+                }
+                allocation.arena = compacted.size();
+            }
+            compacted.push_back(Arena{arenas[i].buffer, std::move(allocators[i])});
+        }
+        arenas.swap(compacted);
+        if(scratch != 0)
+        {
+            GLState::current().deleteBuffer(scratch);
+        }
+        return moved;
+    }
+
+    inline GLuint BufferArena::getBuffer(Handle handle) const noexcept
+    {
+        return arenas[allocations[handle].arena].buffer;
+    }
+
+    inline std::size_t BufferArena::getOffset(Handle handle) const noexcept
+    {
+        return allocations[handle].offset;
+    }
+
+    inline std::size_t BufferArena::getSize(Handle handle) const noexcept
+    {
+        return allocations[handle].size;
+    }
+
+    inline GLint BufferArena::getBaseVertex(Handle handle, std::size_t stride) const noexcept
+    {
+        return static_cast<GLint>(allocations[handle].offset / stride);
+    }
+
+    inline std::size_t BufferArena::getArenaCount() const noexcept
+    {
+        return arenas.size();
+    }
+
+    inline std::size_t BufferArena::getFreeSize(std::size_t arena) const noexcept
+    {
+        return arenas[arena].allocator.getFreeSize();
+    }
+
+    inline BufferArena::~BufferArena()
+    {
+        for(Arena& arena : arenas)
+        {
+            /// Call should never fail
+            GLState::current().deleteBuffer(arena.buffer);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+
+namespace midnight
+{
+    inline void DirtyRangeSet::add(std::size_t first, std::size_t last)
+    {
+        if(first >= last)
+        {
+            return;
+        }
+
+        /// The ranges that overlap or touch [first, last) are [begin, end)
+        auto begin = std::lower_bound(ranges.begin(), ranges.end(), first, [](const Range& range, std::size_t value)
+        {
+            return range.last < value;
+        });
+        auto end = std::upper_bound(begin, ranges.end(), last, [](std::size_t value, const Range& range)
+        {
+            return value < range.first;
+        });
+        if(begin == end)
+        {
+            ranges.insert(begin, Range{first, last});
+            return;
+        }
+        begin->first = std::min(begin->first, first);
+        begin->last = std::max((end - 1)->last, last);
+        ranges.erase(begin + 1, end);
+    }
+
+    inline void DirtyRangeSet::coalesce(std::size_t gap)
+    {
+        if(ranges.empty())
+        {
+            return;
+        }
+        std::size_t merged = 0;
+        for(std::size_t i = 1; i < ranges.size(); ++i)
+        {
+            if(ranges[i].first - ranges[merged].last <= gap)
+            {
+                ranges[merged].last = ranges[i].last;
+            }
+            else
+            {
+                ranges[++merged] = ranges[i];
+            }
+        }
+        ranges.resize(merged + 1);
+    }
+
+    inline const std::vector<DirtyRangeSet::Range>& DirtyRangeSet::getRanges() const noexcept
+    {
+        return ranges;
+    }
+
+    inline std::size_t DirtyRangeSet::getSize() const noexcept
+    {
+        std::size_t size = 0;
+        for(const Range& range : ranges)
+        {
+            size += range.last - range.first;
+        }
+        return size;
+    }
+
+    inline bool DirtyRangeSet::isEmpty() const noexcept
+    {
+        return ranges.empty();
+    }
+
+    inline void DirtyRangeSet::clear() noexcept
+    {
+        ranges.clear();
+    }
+
+    namespace detail
+    {
+        template<typename T>
+        void uploadDirtyRanges(GLenum target, const std::vector<T>& data, DirtyRangeSet& dirty, GLenum usage, bool orphan)
+        {
+            if(dirty.isEmpty())
+            {
+                return;
+            }
+            if(orphan || dirty.getSize() > data.size() / 2)
+            {
+                glBufferData(target, sizeof(T) * data.size(), data.data(), usage);
+            }
+            else
+            {
+                dirty.coalesce(std::max<std::size_t>(DIRTY_RANGE_GAP / sizeof(T), 1));
+                for(const DirtyRangeSet::Range& range : dirty.getRanges())
+                {
+                    glBufferSubData(target, sizeof(T) * range.first, sizeof(T) * (range.last - range.first), data.data() + range.first);
+                }
+            }
+            dirty.clear();
+        }
+    }
+}
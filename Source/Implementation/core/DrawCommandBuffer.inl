@@ -0,0 +1,117 @@
+#include "GLState.hpp"
+
+/// Utility Headers
+#include "dynamic_assert.hpp"
+
+namespace midnight
+{
+    inline DrawCommandBuffer::DrawCommandBuffer() :
+        handle(0)
+    {
+    }
+
+    inline void DrawCommandBuffer::add(GLuint count, GLuint firstIndex, GLint baseVertex, GLuint instanceCount, GLuint baseInstance)
+    {
+        if(count == 0 || instanceCount == 0)
+        {
+            return;
+        }
+        if(!commands.empty())
+        {
+            Command& last = commands.back();
+            if(last.firstIndex + last.count == firstIndex && last.baseVertex == baseVertex &&
+                last.instanceCount == instanceCount && last.baseInstance == baseInstance)
+            {
+                last.count += count;
+                return;
+            }
+        }
+        commands.push_back(Command{count, instanceCount, firstIndex, baseVertex, baseInstance});
+    }
+
+    inline void DrawCommandBuffer::clear() noexcept
+    {
+        commands.clear();
+    }
+
+    inline const std::vector<DrawCommandBuffer::Command>& DrawCommandBuffer::getCommands() const noexcept
+    {
+        return commands;
+    }
+
+    inline bool DrawCommandBuffer::isIndirect() noexcept
+    {
+        return GLEW_ARB_multi_draw_indirect;
+    }
+
+    inline void DrawCommandBuffer::submit(GLenum mode, GLenum type)
+    {
+        if(commands.empty())
+        {
+            return;
+        }
+
+        if(isIndirect())
+        {
+            if(handle == 0)
+            {
+                glGenBuffers(1, &handle);
+            }
+            GLState::current().bindBuffer(GL_DRAW_INDIRECT_BUFFER, handle);
+
+            /// Respecified every submission, so that the implementation need not wait for the previous draws
+            /// https://www.opengl.org/sdk/docs/man4/html/glBufferData.xhtml
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(sizeof(Command) * commands.size()), commands.data(), GL_STREAM_DRAW);
+            glMultiDrawElementsIndirect(mode, type, nullptr, static_cast<GLsizei>(commands.size()), 0);
+            return;
+        }
+
+        const std::size_t indexSize = type == GL_UNSIGNED_BYTE ? 1 : type == GL_UNSIGNED_SHORT ? 2 : 4;
+        for(const Command& command : commands)
+        {
+            const GLvoid* offset = reinterpret_cast<const GLvoid*>(command.firstIndex * indexSize);
+            if(command.instanceCount == 1 && command.baseInstance == 0)
+            {
+                counts.push_back(static_cast<GLsizei>(command.count));
+                offsets.push_back(offset);
+                baseVertices.push_back(command.baseVertex);
+                continue;
+            }
+
+            /// The draws before an instanced one are submitted first, so that they are drawn in the order added
+            submitPending(mode, type);
+            if(GLEW_ARB_base_instance)
+            {
+                glDrawElementsInstancedBaseVertexBaseInstance(mode, static_cast<GLsizei>(command.count), type, offset,
+                    static_cast<GLsizei>(command.instanceCount), command.baseVertex, command.baseInstance);
+            }
+            else
+            {
+                dynamic_assert(command.baseInstance == 0, "A base instance may not be used without ARB_base_instance");
+                glDrawElementsInstancedBaseVertex(mode, static_cast<GLsizei>(command.count), type, offset,
+                    static_cast<GLsizei>(command.instanceCount), command.baseVertex);
+            }
+        }
+        submitPending(mode, type);
+    }
+
+    inline void DrawCommandBuffer::submitPending(GLenum mode, GLenum type)
+    {
+        if(!counts.empty())
+        {
+            glMultiDrawElementsBaseVertex(mode, &counts[0], type, &offsets[0], static_cast<GLsizei>(counts.size()), &baseVertices[0]);
+        }
+        counts.clear();
+        offsets.clear();
+        baseVertices.clear();
+    }
+
+    inline DrawCommandBuffer::~DrawCommandBuffer()
+    {
+        if(handle != 0)
+        {
+            /// Call should never fail
+            GLState::current().deleteBuffer(handle);
+        }
+    }
+}
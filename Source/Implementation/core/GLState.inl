@@ -0,0 +1,320 @@
+/// Utility Headers
+#include "dynamic_assert.hpp"
+
+namespace midnight
+{
+    namespace detail
+    {
+        /// A binding that GLState does not know, as no handle is ever this large
+        constexpr GLuint UNKNOWN_BINDING = ~static_cast<GLuint>(0);
+
+        /**
+         * Queries an integer state of the implementation - only for bindings that GLState does not know, or to
+         * verify those that it does
+         *
+         */
+        inline GLuint queryBinding(GLenum name)
+        {
+            GLint value;
+            /// Call should never fail
+            glGetIntegerv(name, &value);
+            return static_cast<GLuint>(value);
+        }
+
+        /**
+         * Retrieves the name of the state that holds the binding of the provided buffer target
+         *
+         */
+        inline GLenum bufferBindingName(GLenum target)
+        {
+            switch(target)
+            {
+                case GL_ARRAY_BUFFER: return GL_ARRAY_BUFFER_BINDING;
+                case GL_ELEMENT_ARRAY_BUFFER: return GL_ELEMENT_ARRAY_BUFFER_BINDING;
+                case GL_COPY_READ_BUFFER: return GL_COPY_READ_BUFFER_BINDING;
+                case GL_COPY_WRITE_BUFFER: return GL_COPY_WRITE_BUFFER_BINDING;
+                case GL_PIXEL_PACK_BUFFER: return GL_PIXEL_PACK_BUFFER_BINDING;
+                case GL_PIXEL_UNPACK_BUFFER: return GL_PIXEL_UNPACK_BUFFER_BINDING;
+                case GL_UNIFORM_BUFFER: return GL_UNIFORM_BUFFER_BINDING;
+                case GL_DRAW_INDIRECT_BUFFER: return GL_DRAW_INDIRECT_BUFFER_BINDING;
+                case GL_SHADER_STORAGE_BUFFER: return GL_SHADER_STORAGE_BUFFER_BINDING;
+                default:
+                    dynamic_assert(false, "GLState does not track the buffer target " << target);
+                    return GL_ARRAY_BUFFER_BINDING;
+            }
+        }
+
+        /**
+         * Retrieves the name of the state that holds the binding of the provided texture target
+         *
+         */
+        inline GLenum textureBindingName(GLenum target)
+        {
+            switch(target)
+            {
+                case GL_TEXTURE_1D: return GL_TEXTURE_BINDING_1D;
+                case GL_TEXTURE_2D: return GL_TEXTURE_BINDING_2D;
+                case GL_TEXTURE_3D: return GL_TEXTURE_BINDING_3D;
+                case GL_TEXTURE_1D_ARRAY: return GL_TEXTURE_BINDING_1D_ARRAY;
+                case GL_TEXTURE_2D_ARRAY: return GL_TEXTURE_BINDING_2D_ARRAY;
+                case GL_TEXTURE_RECTANGLE: return GL_TEXTURE_BINDING_RECTANGLE;
+                case GL_TEXTURE_CUBE_MAP: return GL_TEXTURE_BINDING_CUBE_MAP;
+                default:
+                    dynamic_assert(false, "GLState does not track the texture target " << target);
+                    return GL_TEXTURE_BINDING_2D;
+            }
+        }
+    }
+
+    inline GLState::GLState() :
+        program(0),
+        vertexArray(0),
+        activeTexture(GL_TEXTURE0),
+        fallback(0),
+        counters{0, 0}
+    {
+    }
+
+    inline GLState& GLState::current()
+    {
+        static thread_local GLState state;
+        return state;
+    }
+
+    inline bool GLState::change(bool redundant) noexcept
+    {
+        if(redundant)
+        {
+            ++counters.elided;
+            return false;
+        }
+        ++counters.issued;
+        return true;
+    }
+
+    inline bool GLState::useProgram(GLuint program)
+    {
+        if(!change(this->program == program))
+        {
+            dynamic_assert(detail::queryBinding(GL_CURRENT_PROGRAM) == program, "GLState is out of sync with the implementation");
+            return false;
+        }
+        glUseProgram(program);
+        this->program = program;
+        return true;
+    }
+
+    inline GLuint GLState::getProgram()
+    {
+        if(program == detail::UNKNOWN_BINDING)
+        {
+            program = detail::queryBinding(GL_CURRENT_PROGRAM);
+        }
+        return program;
+    }
+
+    inline void GLState::bindVertexArray(GLuint vertexArray)
+    {
+        if(!change(this->vertexArray == vertexArray))
+        {
+            dynamic_assert(detail::queryBinding(GL_VERTEX_ARRAY_BINDING) == vertexArray, "GLState is out of sync with the implementation");
+            return;
+        }
+        /// Call should never fail
+        glBindVertexArray(vertexArray);
+        this->vertexArray = vertexArray;
+    }
+
+    inline GLuint GLState::getVertexArray()
+    {
+        if(vertexArray == detail::UNKNOWN_BINDING)
+        {
+            vertexArray = detail::queryBinding(GL_VERTEX_ARRAY_BINDING);
+        }
+        return vertexArray;
+    }
+
+    inline void GLState::deleteVertexArray(GLuint vertexArray)
+    {
+        /// Call should never fail
+        glDeleteVertexArrays(1, &vertexArray);
+        if(this->vertexArray == vertexArray)
+        {
+            this->vertexArray = 0;
+        }
+
+        /// A vertex array that later reuses the handle starts out with no element buffer
+        elementBuffers.erase(vertexArray);
+    }
+
+    inline void GLState::bindBuffer(GLenum target, GLuint buffer)
+    {
+        std::map<GLenum, GLuint>& bindings = target == GL_ELEMENT_ARRAY_BUFFER ? elementBuffers : buffers;
+        const GLenum key = target == GL_ELEMENT_ARRAY_BUFFER ? getVertexArray() : target;
+        auto binding = bindings.find(key);
+        if(!change((binding != bindings.end() ? binding->second : fallback) == buffer))
+        {
+            dynamic_assert(detail::queryBinding(detail::bufferBindingName(target)) == buffer, "GLState is out of sync with the implementation");
+            return;
+        }
+        /// Call should never fail
+        glBindBuffer(target, buffer);
+        bindings[key] = buffer;
+    }
+
+    inline GLuint GLState::getBuffer(GLenum target)
+    {
+        std::map<GLenum, GLuint>& bindings = target == GL_ELEMENT_ARRAY_BUFFER ? elementBuffers : buffers;
+        const GLenum key = target == GL_ELEMENT_ARRAY_BUFFER ? getVertexArray() : target;
+        auto binding = bindings.find(key);
+        if(binding != bindings.end() && binding->second != detail::UNKNOWN_BINDING)
+        {
+            return binding->second;
+        }
+        if(binding == bindings.end() && fallback != detail::UNKNOWN_BINDING)
+        {
+            return fallback;
+        }
+        return bindings[key] = detail::queryBinding(detail::bufferBindingName(target));
+    }
+
+    inline void GLState::unbindDeleted(std::map<GLenum, GLuint>& bindings, GLuint handle) noexcept
+    {
+        for(std::pair<const GLenum, GLuint>& binding : bindings)
+        {
+            if(binding.second == handle)
+            {
+                binding.second = 0;
+            }
+        }
+    }
+
+    inline void GLState::deleteBuffer(GLuint buffer)
+    {
+        /// Call should never fail
+        glDeleteBuffers(1, &buffer);
+        if(buffer == 0)
+        {
+            return;
+        }
+        unbindDeleted(buffers, buffer);
+
+        /// Only the bound vertex array lets go of the buffer - the others keep it alive, but its handle may be
+        /// reused, after which they no longer hold the buffer of that handle
+        for(std::pair<const GLuint, GLuint>& binding : elementBuffers)
+        {
+            if(binding.second == buffer)
+            {
+                binding.second = binding.first == vertexArray ? 0 : detail::UNKNOWN_BINDING;
+            }
+        }
+    }
+
+    inline void GLState::setActiveTexture(GLenum unit)
+    {
+        if(!change(activeTexture == unit))
+        {
+            dynamic_assert(detail::queryBinding(GL_ACTIVE_TEXTURE) == unit, "GLState is out of sync with the implementation");
+            return;
+        }
+        /// Call should never fail
+        glActiveTexture(unit);
+        activeTexture = unit;
+    }
+
+    inline void GLState::bindTexture(GLenum target, GLuint texture)
+    {
+        if(activeTexture == detail::UNKNOWN_BINDING)
+        {
+            activeTexture = detail::queryBinding(GL_ACTIVE_TEXTURE);
+        }
+        auto binding = textures.find(std::make_pair(activeTexture, target));
+        const GLuint bound = binding != textures.end() ? binding->second : fallback;
+        if(!change(bound == texture))
+        {
+            dynamic_assert(detail::queryBinding(detail::textureBindingName(target)) == texture, "GLState is out of sync with the implementation");
+            return;
+        }
+        /// Call should never fail
+        glBindTexture(target, texture);
+        textures[std::make_pair(activeTexture, target)] = texture;
+    }
+
+    inline GLuint GLState::getTexture(GLenum target)
+    {
+        if(activeTexture == detail::UNKNOWN_BINDING)
+        {
+            activeTexture = detail::queryBinding(GL_ACTIVE_TEXTURE);
+        }
+        auto binding = textures.find(std::make_pair(activeTexture, target));
+        if(binding != textures.end())
+        {
+            return binding->second;
+        }
+        if(fallback != detail::UNKNOWN_BINDING)
+        {
+            return fallback;
+        }
+        return textures[std::make_pair(activeTexture, target)] = detail::queryBinding(detail::textureBindingName(target));
+    }
+
+    inline void GLState::setTextureParameter(GLenum target, GLenum name, GLint value)
+    {
+        const std::pair<GLuint, GLenum> key(getTexture(target), name);
+        auto parameter = textureParameters.find(key);
+        if(!change(parameter != textureParameters.end() && parameter->second == value))
+        {
+#if defined(MIDNIGHT_RUNTIME_ASSERTIONS)
+            GLint current;
+            glGetTexParameteriv(target, name, &current);
+            dynamic_assert(current == value, "GLState is out of sync with the implementation");
+#endif
+            return;
+        }
+        /// Can set GL_INVALID_ENUM or GL_INVALID_VALUE, for a parameter that does not suit the target
+        /// https://www.opengl.org/sdk/docs/man4/xhtml/glTexParameter.xml
+        glTexParameteri(target, name, value);
+        textureParameters[key] = value;
+    }
+
+    inline void GLState::deleteTexture(GLuint texture)
+    {
+        /// Call should never fail
+        glDeleteTextures(1, &texture);
+        if(texture == 0)
+        {
+            return;
+        }
+        for(std::pair<const std::pair<GLenum, GLenum>, GLuint>& binding : textures)
+        {
+            if(binding.second == texture)
+            {
+                binding.second = 0;
+            }
+        }
+        textureParameters.erase(textureParameters.lower_bound(std::make_pair(texture, static_cast<GLenum>(0))),
+            textureParameters.lower_bound(std::make_pair(texture + 1, static_cast<GLenum>(0))));
+    }
+
+    inline void GLState::invalidate() noexcept
+    {
+        program = detail::UNKNOWN_BINDING;
+        vertexArray = detail::UNKNOWN_BINDING;
+        activeTexture = detail::UNKNOWN_BINDING;
+        buffers.clear();
+        elementBuffers.clear();
+        textures.clear();
+        textureParameters.clear();
+        fallback = detail::UNKNOWN_BINDING;
+    }
+
+    inline const GLState::Counters& GLState::getCounters() const noexcept
+    {
+        return counters;
+    }
+
+    inline void GLState::resetCounters() noexcept
+    {
+        counters = Counters{0, 0};
+    }
+}
@@ -1,3 +1,11 @@
+#include <algorithm>
+#include <limits>
+
+#include "BindException.hpp"
+#include "GLState.hpp"
+#include "IllegalArgumentException.hpp"
+#include "ResourceException.hpp"
+
 namespace midnight
 {
     
@@ -5,78 +13,400 @@ namespace midnight
     {
         struct IndexBufferBindHelper
         {
-            GLint preserved;
-            IndexBufferBindHelper(GLuint handle)
+            GLuint preserved;
+            IndexBufferBindHelper(GLuint handle) :
+                preserved(GLState::current().getBuffer(GL_ELEMENT_ARRAY_BUFFER))
             {
-                glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER, &preserved);
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, handle);
+                GLState::current().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, handle);
             }
             
             ~IndexBufferBindHelper()
             {
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, preserved);
+                GLState::current().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, preserved);
             }
         };
+        
+        /**
+         * Unbinds the element buffer, unless a vertex array is bound - the element buffer is then part of its 
+         * state, and is left in place so that the next bind with that vertex array is elided by GLState
+         * 
+         */
+        inline void unbindElementBuffer()
+        {
+            if(GLState::current().getVertexArray() == 0)
+            {
+                /// Call should never fail
+                GLState::current().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+            }
+        }
+
+        /**
+         * Finds the largest index in the provided lists of indices, and counts them
+         * 
+         * @param lists the lists of indices, as pairs of the first index and the number of indices
+         * 
+         * @param count receives the number of indices in every list
+         * 
+         * @return the largest index, or 0 if there are none
+         * 
+         */
+        template<typename S>
+        std::size_t maxIndex(const std::vector<std::pair<const S*, std::size_t>>& lists, std::size_t& count) noexcept
+        {
+            std::size_t result = 0;
+            count = 0;
+            for(const std::pair<const S*, std::size_t>& list : lists)
+            {
+                if(list.second != 0)
+                {
+                    result = std::max(result, static_cast<std::size_t>(*std::max_element(list.first, list.first + list.second)));
+                }
+                count += list.second;
+            }
+            return result;
+        }
+
+        /**
+         * Writes the provided lists of indices one after another to the provided destination, narrowed to U 
+         * (which must hold the largest of them)
+         * 
+         * @return the end of the written indices
+         * 
+         */
+        template<typename U, typename S>
+        U* narrowIndices(const std::vector<std::pair<const S*, std::size_t>>& lists, U* destination) noexcept
+        {
+            for(const std::pair<const S*, std::size_t>& list : lists)
+            {
+                destination = std::transform(list.first, list.first + list.second, destination, 
+                    [](S index) { return static_cast<U>(index); });
+            }
+            return destination;
+        }
     }
     
-    template<typename T, GLenum Usage>
-    IndexBuffer<T, Usage>::IndexBuffer(const std::vector<T>& data) : 
-        data(data)
+    template<typename T, GLenum Usage, BufferRetention Retention>
+    void IndexBuffer<T, Usage, Retention>::upload(const std::vector<T>& indices)
     {
         glGenBuffers(1, &handle);
         detail::IndexBufferBindHelper binder(handle);
         /// Can set GL_OUT_OF_MEMORY
         /// https://www.opengl.org/sdk/docs/man4/xhtml/glBufferData.xml
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(T) * data.size(), &data[0], Usage);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(T) * indices.size(), indices.data(), Usage);
 
         if(glGetError() == GL_OUT_OF_MEMORY)
         {
             throw ResourceException("Unable to allocate GPU memory for VertexBuffer");
         }
+        if(Retention != BufferRetention::Discard && !indices.empty())
+        {
+            auto bounds = std::minmax_element(indices.begin(), indices.end());
+            minIndex = *bounds.first;
+            maxIndex = *bounds.second;
+        }
+    }
+    
+    template<typename T, GLenum Usage, BufferRetention Retention>
+    IndexBuffer<T, Usage, Retention>::IndexBuffer(const std::vector<T>& data) : 
+        count(data.size()),
+        minIndex(0),
+        maxIndex(0)
+    {
+        upload(data);
+        if(Retention == BufferRetention::Keep)
+        {
+            this->data = data;
+        }
+    }
+    
+    template<typename T, GLenum Usage, BufferRetention Retention>
+    IndexBuffer<T, Usage, Retention>::IndexBuffer(std::vector<T>&& data) : 
+        count(data.size()),
+        minIndex(0),
+        maxIndex(0)
+    {
+        upload(data);
+        if(Retention == BufferRetention::Keep)
+        {
+            this->data = std::move(data);
+        }
+    }
+    
+    template<typename T, GLenum Usage, BufferRetention Retention>
+    void IndexBuffer<T, Usage, Retention>::updateIndices(std::size_t offset, const T* indices, std::size_t count)
+    {
+        if(offset > this->count || count > this->count - offset)
+        {
+            throw IllegalArgumentException("Unable to update index buffer, as the range exceeds its size");
+        }
+        if(count == 0)
+        {
+            return;
+        }
+        if(Retention != BufferRetention::Discard)
+        {
+            auto bounds = std::minmax_element(indices, indices + count);
+            minIndex = std::min(minIndex, *bounds.first);
+            maxIndex = std::max(maxIndex, *bounds.second);
+        }
+        if(Retention == BufferRetention::Keep)
+        {
+            std::copy(indices, indices + count, data.begin() + offset);
+            dirty.add(offset, offset + count);
+        }
+        else
+        {
+            detail::IndexBufferBindHelper binder(handle);
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, sizeof(T) * offset, sizeof(T) * count, indices);
+        }
+    }
+    
+    template<typename T, GLenum Usage, BufferRetention Retention>
+    void IndexBuffer<T, Usage, Retention>::flush(bool orphan)
+    {
+        if(dirty.isEmpty())
+        {
+            return;
+        }
+        detail::IndexBufferBindHelper binder(handle);
+        detail::uploadDirtyRanges(GL_ELEMENT_ARRAY_BUFFER, data, dirty, Usage, orphan);
+    }
+    
+    template<typename T, GLenum Usage, BufferRetention Retention>
+    void IndexBuffer<T, Usage, Retention>::bind()
+    {
+           const GLuint programHandle = GLState::current().getProgram();
+            if(programHandle == 0)
+            {
+                throw midnight::glsl::BindException("A program must first be bound before binding an IndexBuffer");
+            }
+            /// Call should never fail
+            GLState::current().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, handle);
+            detail::uploadDirtyRanges(GL_ELEMENT_ARRAY_BUFFER, data, dirty, Usage, false);
+    }
+    
+    template<typename T, GLenum Usage, BufferRetention Retention>
+    void IndexBuffer<T, Usage, Retention>::unbind()
+    {
+        detail::unbindElementBuffer();
+    }
+    
+    template<typename T, GLenum Usage, BufferRetention Retention>
+    IndexBuffer<T, Usage, Retention>::~IndexBuffer()
+    {
+        /// Call should never fail
+        GLState::current().deleteBuffer(handle);
+    }
+    
+    template<GLenum Usage>
+    GLenum AdaptiveIndexBuffer<Usage>::selectType(std::size_t maxIndex)
+    {
+        if(maxIndex <= std::numeric_limits<uint8_t>::max())
+        {
+            return GL_UNSIGNED_BYTE;
+        }
+        if(maxIndex <= std::numeric_limits<uint16_t>::max())
+        {
+            return GL_UNSIGNED_SHORT;
+        }
+        if(maxIndex <= std::numeric_limits<uint32_t>::max())
+        {
+            return GL_UNSIGNED_INT;
+        }
+        throw IllegalArgumentException("OpenGL indices can not exceed 32 bits");
     }
     
-    template<typename T, GLenum Usage>
-    IndexBuffer<T, Usage>::IndexBuffer(std::vector<T>&& data) : 
-        data(data)
+    template<GLenum Usage>
+    template<typename U, typename S>
+    void AdaptiveIndexBuffer<Usage>::upload(const std::vector<std::pair<const S*, std::size_t>>& lists)
     {
         glGenBuffers(1, &handle);
         detail::IndexBufferBindHelper binder(handle);
         /// Can set GL_OUT_OF_MEMORY
         /// https://www.opengl.org/sdk/docs/man4/xhtml/glBufferData.xml
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(T) * data.size(), &data[0], Usage);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(U) * count, nullptr, Usage);
 
         if(glGetError() == GL_OUT_OF_MEMORY)
         {
-            throw ResourceException("Unable to allocate GPU memory for VertexBuffer");
+            GLState::current().deleteBuffer(handle);
+            throw ResourceException("Unable to allocate GPU memory for AdaptiveIndexBuffer");
+        }
+        if(count == 0)
+        {
+            return;
+        }
+        
+        /// The indices are narrowed straight into the buffer object, rather than into a copy that is then uploaded
+        U* mapping = static_cast<U*>(glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(U) * count, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+        if(mapping == nullptr)
+        {
+            GLState::current().deleteBuffer(handle);
+            throw ResourceException("Unable to map GPU memory for AdaptiveIndexBuffer");
+        }
+        detail::narrowIndices(lists, mapping);
+        
+        /// The contents are lost (and GL_FALSE returned) only if the display mode changes while mapped
+        /// https://www.opengl.org/sdk/docs/man4/html/glUnmapBuffer.xhtml
+        if(glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER) == GL_FALSE)
+        {
+            GLState::current().deleteBuffer(handle);
+            throw ResourceException("The GPU memory of AdaptiveIndexBuffer was corrupted while it was written");
         }
     }
     
-    template<typename T, GLenum Usage>
-    void IndexBuffer<T, Usage>::bind()
+    template<GLenum Usage>
+    template<typename S>
+    AdaptiveIndexBuffer<Usage>::AdaptiveIndexBuffer(const S* indices, std::size_t count) :
+        AdaptiveIndexBuffer(std::vector<std::pair<const S*, std::size_t>>(1, std::make_pair(indices, count)))
     {
-           GLint programHandle;
-            /// Call should never fail
-            glGetIntegerv(GL_CURRENT_PROGRAM, &programHandle);
-            if(programHandle == 0)
-            {
-                throw midnight::glsl::BindException("A program must first be bound before binding an IndexBuffer");
-            }
-            /// Call should never fail
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, handle);
+        
+    }
+    
+    template<GLenum Usage>
+    template<typename S>
+    AdaptiveIndexBuffer<Usage>::AdaptiveIndexBuffer(const std::vector<S>& indices) :
+        AdaptiveIndexBuffer(indices.data(), indices.size())
+    {
+        
+    }
+    
+    template<GLenum Usage>
+    template<typename S>
+    AdaptiveIndexBuffer<Usage>::AdaptiveIndexBuffer(const std::vector<std::pair<const S*, std::size_t>>& lists) :
+        handle(0),
+        count(0)
+    {
+        static_assert(std::is_integral<S>::value, "Only integral indices may be uploaded to an AdaptiveIndexBuffer");
+        
+        type = selectType(detail::maxIndex(lists, count));
+        switch(type)
+        {
+            case GL_UNSIGNED_BYTE:
+                upload<uint8_t>(lists);
+                break;
+            case GL_UNSIGNED_SHORT:
+                upload<uint16_t>(lists);
+                break;
+            default:
+                upload<uint32_t>(lists);
+                break;
+        }
+    }
+    
+    template<GLenum Usage>
+    void AdaptiveIndexBuffer<Usage>::bind()
+    {
+        const GLuint programHandle = GLState::current().getProgram();
+        if(programHandle == 0)
+        {
+            throw midnight::glsl::BindException("A program must first be bound before binding an AdaptiveIndexBuffer");
+        }
+        /// Call should never fail
+        GLState::current().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, handle);
+    }
+    
+    template<GLenum Usage>
+    void AdaptiveIndexBuffer<Usage>::unbind()
+    {
+        detail::unbindElementBuffer();
+    }
+    
+    template<GLenum Usage>
+    GLenum AdaptiveIndexBuffer<Usage>::getType() const noexcept
+    {
+        return type;
     }
     
-    template<typename T, GLenum Usage>
-    void IndexBuffer<T, Usage>::unbind()
+    template<GLenum Usage>
+    std::size_t AdaptiveIndexBuffer<Usage>::getCount() const noexcept
     {
-           /// Call should never fail
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        return count;
     }
     
-    template<typename T, GLenum Usage>
-    IndexBuffer<T, Usage>::~IndexBuffer()
+    template<GLenum Usage>
+    AdaptiveIndexBuffer<Usage>::~AdaptiveIndexBuffer()
     {
         /// Call should never fail
-        glDeleteBuffers(1, &handle);
+        GLState::current().deleteBuffer(handle);
     }
     
-}
\ No newline at end of file
+    template<typename U, typename S>
+    void ArenaIndexBuffer::upload(const S* indices)
+    {
+        std::vector<U> narrowed(indices, indices + count);
+        range = arena.allocate(sizeof(U) * narrowed.size(), sizeof(U));
+        arena.upload(range, narrowed.data(), sizeof(U) * narrowed.size());
+    }
+    
+    template<typename S>
+    ArenaIndexBuffer::ArenaIndexBuffer(BufferArena& arena, const S* indices, std::size_t count) :
+        arena(arena),
+        range(0),
+        count(count)
+    {
+        static_assert(std::is_integral<S>::value, "Only integral indices may be uploaded to an ArenaIndexBuffer");
+        
+        const std::size_t maxIndex = count == 0 ? 0 : static_cast<std::size_t>(*std::max_element(indices, indices + count));
+        type = AdaptiveIndexBuffer<GL_STATIC_DRAW>::selectType(maxIndex);
+        switch(type)
+        {
+            case GL_UNSIGNED_BYTE:
+                upload<uint8_t>(indices);
+                break;
+            case GL_UNSIGNED_SHORT:
+                upload<uint16_t>(indices);
+                break;
+            default:
+                upload<uint32_t>(indices);
+                break;
+        }
+    }
+    
+    template<typename S>
+    ArenaIndexBuffer::ArenaIndexBuffer(BufferArena& arena, const std::vector<S>& indices) :
+        ArenaIndexBuffer(arena, indices.data(), indices.size())
+    {
+        
+    }
+    
+    inline BufferArena::Handle ArenaIndexBuffer::getRange() const noexcept
+    {
+        return range;
+    }
+    
+    inline std::size_t ArenaIndexBuffer::getFirstIndex() const noexcept
+    {
+        return arena.getOffset(range) / AdaptiveIndexBuffer<GL_STATIC_DRAW>::sizeOf(type);
+    }
+    
+    inline void ArenaIndexBuffer::bind()
+    {
+        const GLuint programHandle = GLState::current().getProgram();
+        if(programHandle == 0)
+        {
+            throw midnight::glsl::BindException("A program must first be bound before binding an ArenaIndexBuffer");
+        }
+        /// Call should never fail
+        GLState::current().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, arena.getBuffer(range));
+    }
+    
+    inline void ArenaIndexBuffer::unbind()
+    {
+        detail::unbindElementBuffer();
+    }
+    
+    inline GLenum ArenaIndexBuffer::getType() const noexcept
+    {
+        return type;
+    }
+    
+    inline std::size_t ArenaIndexBuffer::getCount() const noexcept
+    {
+        return count;
+    }
+    
+    inline ArenaIndexBuffer::~ArenaIndexBuffer()
+    {
+        arena.release(range);
+    }
+}
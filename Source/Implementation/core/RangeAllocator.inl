@@ -0,0 +1,118 @@
+#include <iterator>
+
+#include "IllegalArgumentException.hpp"
+
+namespace midnight
+{
+    inline RangeAllocator::RangeAllocator(std::size_t capacity) :
+        capacity(capacity),
+        freeSize(0)
+    {
+        if(capacity != 0)
+        {
+            insertFree(0, capacity);
+        }
+    }
+
+    inline void RangeAllocator::insertFree(std::size_t offset, std::size_t size)
+    {
+        freeByOffset.emplace(offset, size);
+        freeBySize.emplace(size, offset);
+        freeSize += size;
+    }
+
+    inline void RangeAllocator::eraseFree(std::map<std::size_t, std::size_t>::iterator range)
+    {
+        auto bySize = freeBySize.equal_range(range->second);
+        for(auto i = bySize.first; i != bySize.second; ++i)
+        {
+            if(i->second == range->first)
+            {
+                freeBySize.erase(i);
+                break;
+            }
+        }
+        freeSize -= range->second;
+        freeByOffset.erase(range);
+    }
+
+    inline bool RangeAllocator::allocate(std::size_t size, std::size_t alignment, std::size_t& offset)
+    {
+        if(size == 0 || alignment == 0)
+        {
+            throw IllegalArgumentException("A RangeAllocator can not allocate an empty or unaligned range");
+        }
+
+        /// The smallest free range that holds the allocation once aligned
+        for(auto i = freeBySize.lower_bound(size); i != freeBySize.end(); ++i)
+        {
+            const std::size_t first = i->second;
+            const std::size_t last = first + i->first;
+            const std::size_t aligned = (first + alignment - 1) / alignment * alignment;
+            if(aligned > last || last - aligned < size)
+            {
+                continue;
+            }
+
+            /// Whatever precedes and follows the allocation remains free
+            eraseFree(freeByOffset.find(first));
+            if(aligned > first)
+            {
+                insertFree(first, aligned - first);
+            }
+            if(last > aligned + size)
+            {
+                insertFree(aligned + size, last - aligned - size);
+            }
+            offset = aligned;
+            return true;
+        }
+        return false;
+    }
+
+    inline void RangeAllocator::release(std::size_t offset, std::size_t size)
+    {
+        std::size_t first = offset;
+        std::size_t last = offset + size;
+
+        /// Merge with the free ranges on either side
+        auto next = freeByOffset.lower_bound(offset);
+        if(next != freeByOffset.end() && next->first == last)
+        {
+            last += next->second;
+            auto following = std::next(next);
+            eraseFree(next);
+            next = following;
+        }
+        if(next != freeByOffset.begin())
+        {
+            auto previous = std::prev(next);
+            if(previous->first + previous->second == first)
+            {
+                first = previous->first;
+                eraseFree(previous);
+            }
+        }
+        insertFree(first, last - first);
+    }
+
+    inline std::size_t RangeAllocator::getCapacity() const noexcept
+    {
+        return capacity;
+    }
+
+    inline std::size_t RangeAllocator::getFreeSize() const noexcept
+    {
+        return freeSize;
+    }
+
+    inline std::size_t RangeAllocator::getLargestFreeSize() const noexcept
+    {
+        return freeBySize.empty() ? 0 : freeBySize.rbegin()->first;
+    }
+
+    inline std::size_t RangeAllocator::getFreeRangeCount() const noexcept
+    {
+        return freeByOffset.size();
+    }
+}
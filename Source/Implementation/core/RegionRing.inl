@@ -0,0 +1,73 @@
+#include <algorithm>
+
+#include "IllegalArgumentException.hpp"
+
+namespace midnight
+{
+    inline RegionRing::RegionRing(std::size_t regionCapacity, std::size_t regionCount) :
+        regionCapacity(regionCapacity),
+        regionCount(regionCount),
+        region(0),
+        cursor(0)
+    {
+        if(regionCapacity == 0 || regionCount < 2)
+        {
+            throw IllegalArgumentException("A RegionRing needs at least two regions of at least one element");
+        }
+    }
+
+    inline bool RegionRing::allocate(std::size_t count, std::size_t alignment, std::size_t& offset)
+    {
+        if(alignment == 0)
+        {
+            throw IllegalArgumentException("The alignment of a write must be at least one element");
+        }
+        const std::size_t base = region * regionCapacity;
+        const std::size_t first = (base + cursor + alignment - 1) / alignment * alignment;
+        if(first - base > regionCapacity || count > regionCapacity - (first - base))
+        {
+            return false;
+        }
+        cursor = first + count - base;
+        offset = first;
+        return true;
+    }
+
+    inline void RegionRing::advance() noexcept
+    {
+        region = (region + 1) % regionCount;
+        cursor = 0;
+    }
+
+    inline void RegionRing::grow(std::size_t required) noexcept
+    {
+        regionCapacity = std::max(required, regionCapacity * 2);
+        region = 0;
+        cursor = 0;
+    }
+
+    inline std::size_t RegionRing::getRegion() const noexcept
+    {
+        return region;
+    }
+
+    inline std::size_t RegionRing::getRegionCapacity() const noexcept
+    {
+        return regionCapacity;
+    }
+
+    inline std::size_t RegionRing::getRegionCount() const noexcept
+    {
+        return regionCount;
+    }
+
+    inline std::size_t RegionRing::getCapacity() const noexcept
+    {
+        return regionCapacity * regionCount;
+    }
+
+    inline bool RegionRing::isRegionEmpty() const noexcept
+    {
+        return cursor == 0;
+    }
+}
@@ -0,0 +1,285 @@
+#include <algorithm>
+
+#include "BindException.hpp"
+#include "GLException.hpp"
+#include "IllegalArgumentException.hpp"
+#include "ResourceException.hpp"
+
+namespace midnight
+{
+    template<typename T, GLenum PolyType>
+    StreamingVertexBuffer<T, PolyType>::StreamingVertexBuffer(std::size_t regionCapacity, std::size_t regionCount) :
+        VertexBuffer<T>(std::vector<T>()),
+        handle(0),
+        mapping(nullptr),
+        stagedFirst(0),
+        stagedLast(0),
+        ring(regionCapacity, regionCount),
+        fences(regionCount, nullptr),
+        offset(0),
+        count(0)
+    {
+        allocateRing();
+    }
+
+    template<typename T, GLenum PolyType>
+    void StreamingVertexBuffer<T, PolyType>::allocateRing()
+    {
+        const GLsizeiptr size = static_cast<GLsizeiptr>(sizeof(T) * ring.getCapacity());
+        glGenBuffers(1, &handle);
+        detail::VertexBufferBindHelper helper(handle);
+        if(GLEW_ARB_buffer_storage)
+        {
+            /// Coherent, so that writes need neither a flush nor a barrier before the draws that read them
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            /// Can set GL_OUT_OF_MEMORY
+            /// https://www.opengl.org/sdk/docs/man4/html/glBufferStorage.xhtml
+            glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+            mapping = glGetError() != GL_OUT_OF_MEMORY ? static_cast<T*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags)) : nullptr;
+            if(mapping == nullptr)
+            {
+                GLState::current().deleteBuffer(handle);
+                handle = 0;
+                throw ResourceException("Unable to allocate GPU memory for StreamingVertexBuffer");
+            }
+        }
+        else
+        {
+            /// Can set GL_OUT_OF_MEMORY
+            /// https://www.opengl.org/sdk/docs/man4/xhtml/glBufferData.xml
+            glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+            if(glGetError() == GL_OUT_OF_MEMORY)
+            {
+                GLState::current().deleteBuffer(handle);
+                handle = 0;
+                throw ResourceException("Unable to allocate GPU memory for StreamingVertexBuffer");
+            }
+            staging.resize(ring.getCapacity());
+        }
+    }
+
+    template<typename T, GLenum PolyType>
+    void StreamingVertexBuffer<T, PolyType>::releaseRing() noexcept
+    {
+        for(GLsync& fence : fences)
+        {
+            if(fence != nullptr)
+            {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+
+        /// Deleting the buffer object unmaps it - draws that are still in flight keep its storage alive
+        GLState::current().deleteBuffer(handle);
+        handle = 0;
+        mapping = nullptr;
+        stagedFirst = stagedLast = 0;
+        vertexArrays.clear();
+    }
+
+    template<typename T, GLenum PolyType>
+    void StreamingVertexBuffer<T, PolyType>::acquireRegion()
+    {
+        GLsync& fence = fences[ring.getRegion()];
+        if(fence == nullptr)
+        {
+            return;
+        }
+
+        /// The first wait flushes the fence, so that it is sure to be signalled eventually
+        GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        while(status == GL_TIMEOUT_EXPIRED)
+        {
+            status = glClientWaitSync(fence, 0, 1000000);
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+        if(status == GL_WAIT_FAILED)
+        {
+            throw GLException("Unable to wait for a region of a StreamingVertexBuffer");
+        }
+    }
+
+    template<typename T, GLenum PolyType>
+    T* StreamingVertexBuffer<T, PolyType>::allocate(std::size_t count, std::size_t alignment)
+    {
+        if(alignment == 0)
+        {
+            throw IllegalArgumentException("The alignment of a write must be at least one element");
+        }
+
+        /// A write that could not fit in a region even when aligned grows every region, which is only safe while
+        /// the current region holds no writes that have yet to be drawn
+        if(count + alignment - 1 > ring.getRegionCapacity())
+        {
+            if(!ring.isRegionEmpty())
+            {
+                throw ResourceException("Unable to grow a StreamingVertexBuffer before the current frame is finished");
+            }
+            releaseRing();
+            ring.grow(count + alignment - 1);
+            allocateRing();
+        }
+
+        std::size_t first;
+        if(!ring.allocate(count, alignment, first))
+        {
+            throw ResourceException("Unable to allocate from a StreamingVertexBuffer, as the current region is full");
+        }
+        acquireRegion();
+
+        this->offset = first;
+        this->count = count;
+        if(mapping != nullptr)
+        {
+            return mapping + first;
+        }
+        if(stagedFirst == stagedLast)
+        {
+            stagedFirst = first;
+        }
+        stagedLast = first + count;
+        return staging.data() + first;
+    }
+
+    template<typename T, GLenum PolyType>
+    void StreamingVertexBuffer<T, PolyType>::finishFrame()
+    {
+        /// Staged writes must reach the buffer object before the region is fenced
+        flush();
+
+        /// Staged writes are uploaded with glBufferSubData, which the implementation already orders after the
+        /// draws that read the region, so only a mapped region needs a fence
+        if(mapping != nullptr && !ring.isRegionEmpty())
+        {
+            fences[ring.getRegion()] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+        ring.advance();
+    }
+
+    template<typename T, GLenum PolyType>
+    std::size_t StreamingVertexBuffer<T, PolyType>::getOffset() const noexcept
+    {
+        return offset;
+    }
+
+    template<typename T, GLenum PolyType>
+    std::size_t StreamingVertexBuffer<T, PolyType>::vertexCount()
+    {
+        return count / detail::PolySize<PolyType>::size();
+    }
+
+    template<typename T, GLenum PolyType>
+    void StreamingVertexBuffer<T, PolyType>::setVertexData(std::vector<T>&& data)
+    {
+        setVertexData(static_cast<const std::vector<T>&>(data));
+    }
+
+    template<typename T, GLenum PolyType>
+    void StreamingVertexBuffer<T, PolyType>::setVertexData(const std::vector<T>& data)
+    {
+        std::copy(data.begin(), data.end(), allocate(data.size()));
+    }
+
+    template<typename T, GLenum PolyType>
+    void StreamingVertexBuffer<T, PolyType>::updateVertexData(std::size_t offset, const T* data, std::size_t count)
+    {
+        if(offset > this->count || count > this->count - offset)
+        {
+            throw IllegalArgumentException("Unable to update streaming vertex buffer, as the range exceeds the latest write");
+        }
+        const std::size_t first = this->offset + offset;
+        if(mapping != nullptr)
+        {
+            std::copy(data, data + count, mapping + first);
+            return;
+        }
+        std::copy(data, data + count, staging.begin() + first);
+        if(stagedFirst == stagedLast)
+        {
+            stagedFirst = first;
+            stagedLast = first + count;
+        }
+        stagedFirst = std::min(stagedFirst, first);
+        stagedLast = std::max(stagedLast, first + count);
+    }
+
+    template<typename T, GLenum PolyType>
+    void StreamingVertexBuffer<T, PolyType>::flush(bool /*orphan*/)
+    {
+        /// Writes to a persistent mapping are coherent, and regions are never respecified
+        if(stagedFirst == stagedLast)
+        {
+            return;
+        }
+        detail::VertexBufferBindHelper helper(handle);
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(T) * stagedFirst, sizeof(T) * (stagedLast - stagedFirst), staging.data() + stagedFirst);
+        stagedFirst = stagedLast = 0;
+    }
+
+    template<typename T, GLenum PolyType>
+    void StreamingVertexBuffer<T, PolyType>::bind()
+    {
+        const GLuint programHandle = GLState::current().getProgram();
+        if(programHandle == 0)
+        {
+            throw midnight::glsl::BindException("A program must first be bound before binding a StreamingVertexBuffer");
+        }
+        flush();
+        vertexArrays.bind(programHandle, handle, attributes);
+    }
+
+    template<typename T, GLenum PolyType>
+    void StreamingVertexBuffer<T, PolyType>::unbind() noexcept
+    {
+        /// Our attribute state lives in the vertex arrays, so restoring the default one undoes all of it
+        GLState::current().bindVertexArray(0);
+    }
+
+    template<typename T, GLenum PolyType>
+    void StreamingVertexBuffer<T, PolyType>::resetAttributes() noexcept
+    {
+        attributes.clear();
+        vertexArrays.clear();
+    }
+
+    template<typename T, GLenum PolyType>
+    void StreamingVertexBuffer<T, PolyType>::addAttributePointer(const std::string& name,
+        GLint size,
+        GLenum type,
+        GLboolean normalized,
+        GLsizei stride,
+        const GLvoid* offset)
+    {
+        attributes.push_back(std::unique_ptr<detail::AttributePointerBase>(new detail::AttributePointer(name, size, type, normalized, stride, offset)));
+        vertexArrays.clear();
+    }
+
+    template<typename T, GLenum PolyType>
+    void StreamingVertexBuffer<T, PolyType>::addAttributeIPointer(const std::string& name,
+        GLint size,
+        GLenum type,
+        GLsizei stride,
+        const GLvoid* offset)
+    {
+        attributes.push_back(std::unique_ptr<detail::AttributePointerBase>(new detail::AttributeIPointer(name, size, type, stride, offset)));
+        vertexArrays.clear();
+    }
+
+    template<typename T, GLenum PolyType>
+    void StreamingVertexBuffer<T, PolyType>::addAttributeLPointer(const std::string& name,
+        GLint size,
+        GLsizei stride,
+        const GLvoid* offset)
+    {
+        attributes.push_back(std::unique_ptr<detail::AttributePointerBase>(new detail::AttributeLPointer(name, size, GL_DOUBLE, stride, offset)));
+        vertexArrays.clear();
+    }
+
+    template<typename T, GLenum PolyType>
+    StreamingVertexBuffer<T, PolyType>::~StreamingVertexBuffer()
+    {
+        releaseRing();
+    }
+}
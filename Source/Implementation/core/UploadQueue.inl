@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+namespace midnight
+{
+    template<typename T>
+    std::size_t uploadSize(const std::vector<T>& data) noexcept
+    {
+        return sizeof(T) * data.size();
+    }
+
+    template<typename T>
+    std::size_t uploadSize(const T& /*data*/) noexcept
+    {
+        return 0;
+    }
+
+    namespace detail
+    {
+        /**
+         * Fulfils a promise with the result of the provided callable, or with the exception that it throws
+         *
+         */
+        template<typename R>
+        struct UploadFulfil
+        {
+            template<typename F>
+            static void apply(std::promise<R>& promise, F&& f)
+            {
+                try
+                {
+                    promise.set_value(f());
+                }
+                catch(...)
+                {
+                    promise.set_exception(std::current_exception());
+                }
+            }
+        };
+
+        template<>
+        struct UploadFulfil<void>
+        {
+            template<typename F>
+            static void apply(std::promise<void>& promise, F&& f)
+            {
+                try
+                {
+                    f();
+                    promise.set_value();
+                }
+                catch(...)
+                {
+                    promise.set_exception(std::current_exception());
+                }
+            }
+        };
+
+        /**
+         * The state that is shared between the prepare and upload steps of a submission
+         *
+         */
+        template<typename Prepare, typename Upload, typename P, typename R>
+        struct UploadState
+        {
+            Prepare prepare;
+            Upload upload;
+
+            /// The prepared data, once it is prepared
+            std::unique_ptr<P> data;
+
+            std::promise<R> promise;
+
+            UploadState(Prepare&& prepare, Upload&& upload) :
+                prepare(std::move(prepare)),
+                upload(std::move(upload))
+            {
+            }
+        };
+    }
+
+    inline UploadQueue::UploadQueue(std::size_t threadCount) :
+        preparing(0),
+        stopping(false)
+    {
+        const std::size_t hardware = std::thread::hardware_concurrency();
+        const std::size_t threads = threadCount != 0 ? threadCount : std::max<std::size_t>(hardware, 2) - 1;
+        workers.reserve(threads);
+        for(std::size_t i = 0; i < threads; ++i)
+        {
+            workers.emplace_back(&UploadQueue::work, this);
+        }
+    }
+
+    inline void UploadQueue::work()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while(true)
+        {
+            submitted.wait(lock, [this]
+            {
+                return stopping || !pending.empty();
+            });
+            if(stopping)
+            {
+                return;
+            }
+            Job job = std::move(pending.front());
+            pending.pop_front();
+            ++preparing;
+
+            lock.unlock();
+            bool succeeded = true;
+            try
+            {
+                job.bytes = job.prepare();
+            }
+            catch(...)
+            {
+                job.fail(std::current_exception());
+                succeeded = false;
+            }
+            lock.lock();
+
+            --preparing;
+            if(succeeded)
+            {
+                ready.push_back(std::move(job));
+            }
+            prepared.notify_all();
+        }
+    }
+
+    inline void UploadQueue::submit(Job&& job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.push_back(std::move(job));
+        }
+        submitted.notify_one();
+    }
+
+    template<typename Prepare, typename Upload>
+    std::future<typename std::result_of<Upload(typename std::result_of<Prepare()>::type&&)>::type> UploadQueue::submit(Prepare prepare, Upload upload)
+    {
+        typedef typename std::result_of<Prepare()>::type P;
+        typedef typename std::result_of<Upload(P&&)>::type R;
+        typedef detail::UploadState<Prepare, Upload, P, R> State;
+
+        std::shared_ptr<State> state = std::make_shared<State>(std::move(prepare), std::move(upload));
+        std::future<R> future = state->promise.get_future();
+
+        Job job;
+        job.prepare = [state]() -> std::size_t
+        {
+            state->data.reset(new P(state->prepare()));
+            return uploadSize(*state->data);
+        };
+        job.upload = [state]
+        {
+            detail::UploadFulfil<R>::apply(state->promise, [&state]() -> R
+            {
+                return state->upload(std::move(*state->data));
+            });
+            state->data.reset();
+        };
+        job.fail = [state](std::exception_ptr exception)
+        {
+            state->promise.set_exception(exception);
+        };
+        job.bytes = 0;
+        submit(std::move(job));
+        return future;
+    }
+
+    inline std::size_t UploadQueue::drain(std::size_t byteBudget, std::chrono::microseconds timeBudget)
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::size_t bytes = 0;
+        std::size_t count = 0;
+        while(true)
+        {
+            Job job;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if(ready.empty())
+                {
+                    break;
+                }
+                /// The budget is checked before each upload, so at least one is always run
+                if(count != 0 && (bytes + ready.front().bytes > byteBudget || std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start) >= timeBudget))
+                {
+                    break;
+                }
+                job = std::move(ready.front());
+                ready.pop_front();
+            }
+            job.upload();
+            bytes += job.bytes;
+            ++count;
+        }
+        return count;
+    }
+
+    inline std::size_t UploadQueue::finish()
+    {
+        std::size_t count = 0;
+        while(true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                prepared.wait(lock, [this]
+                {
+                    return !ready.empty() || (pending.empty() && preparing == 0);
+                });
+                if(ready.empty())
+                {
+                    return count;
+                }
+            }
+            count += drain(static_cast<std::size_t>(-1), std::chrono::microseconds::max());
+        }
+    }
+
+    inline std::size_t UploadQueue::getPendingCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return pending.size() + preparing + ready.size();
+    }
+
+    inline std::size_t UploadQueue::getReadyCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return ready.size();
+    }
+
+    inline UploadQueue::~UploadQueue()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        submitted.notify_all();
+        for(std::thread& worker : workers)
+        {
+            worker.join();
+        }
+    }
+}
@@ -1,10 +1,16 @@
+#include <algorithm>
 #include <string>
 #include <list>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "AttributeNotFoundException.hpp"
 #include "BindException.hpp"
+#include "BufferRetention.hpp"
+#include "DirtyRangeSet.hpp"
+#include "GLState.hpp"
+#include "IllegalArgumentException.hpp"
 #include "Platform.hpp"
 #include "ResourceException.hpp"
 
@@ -43,7 +49,7 @@ namespace detail
      * @throw AttributeNotFoundException if no such attribute exists
      * 
      */
-    GLint getAttribLocation(GLuint handle, const std::string& name)
+    inline GLint getAttribLocation(GLuint handle, const std::string& name)
     {
         dynamic_assert(handle != 0, "No program is currently bound, and as such attribute lookup has failed");
         /// Call should never fail
@@ -165,21 +171,6 @@ namespace detail
          */
         virtual void postBind(GLint index) = 0;
 
-        /**
-         * Unbinds this AttributePointer from the implementation state
-         * 
-         */
-        void unbind()
-        {
-            GLint handle;
-
-            /// Call should never fail
-            glGetIntegerv(GL_CURRENT_PROGRAM, &handle);
-
-            /// Call should never fail
-            glDisableVertexAttribArray(getAttribLocation(static_cast<GLuint>(handle), name));
-        }
-
         virtual ~AttributePointerBase() = default;
     };
 
@@ -292,21 +283,135 @@ namespace detail
      */
     struct VertexBufferBindHelper
     {
-        GLint preserved;
+        GLuint preserved;
 
-        VertexBufferBindHelper(GLuint handle)
+        VertexBufferBindHelper(GLuint handle) :
+        preserved(GLState::current().getBuffer(GL_ARRAY_BUFFER))
         {
             /// Call should never fail
-            glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &preserved);
+            GLState::current().bindBuffer(GL_ARRAY_BUFFER, handle);
+        }
 
+        ~VertexBufferBindHelper()
+        {
             /// Call should never fail
-            glBindBuffer(GL_ARRAY_BUFFER, handle);
+            GLState::current().bindBuffer(GL_ARRAY_BUFFER, preserved);
         }
+    };
 
-        ~VertexBufferBindHelper()
+    /**
+     * Records the attribute pointers of a buffer object into one Vertex Array Object per program 
+     * (https://www.opengl.org/wiki/Vertex_Specification#Vertex_Array_Object), so that the attribute locations 
+     * are looked up once and binding is a single glBindVertexArray.
+     * 
+     * The recorded arrays refer to the buffer object and to the attribute locations of each program, so they 
+     * must be cleared whenever either changes.  Programs are told apart by handle alone, so a program that 
+     * is deleted and whose handle is reused by a new one must not be bound with the same buffer.
+     * 
+     */
+    class VertexArrayCache
+    {
+        /// The recorded arrays, as pairs of program handle and vertex array handle - a buffer is rarely 
+        /// drawn by more than a few programs, so a linear search beats a map
+        std::vector<std::pair<GLuint, GLuint>> arrays;
+
+      public:
+
+        VertexArrayCache() = default;
+
+        VertexArrayCache(VertexArrayCache&& rhs) noexcept :
+        arrays(std::move(rhs.arrays))
         {
+            rhs.arrays.clear();
+        }
+
+        VertexArrayCache(const VertexArrayCache&) = delete;
+
+        VertexArrayCache& operator=(const VertexArrayCache&) = delete;
+
+        /**
+         * Binds the vertex array of the provided program, recording it first if this is the first time that 
+         * the program is bound with this buffer object
+         * 
+         * @param program the handle of the currently bound program
+         * 
+         * @param buffer the handle of the buffer object that the attributes point into
+         * 
+         * @param attributes the attribute pointers to record
+         * 
+         * @throws AttributeNotFoundException if the program lacks one of the attributes
+         * 
+         */
+        void bind(GLuint program, GLuint buffer, std::list<std::unique_ptr<AttributePointerBase>>& attributes)
+        {
+            for(const std::pair<GLuint, GLuint>& array : arrays)
+            {
+                if(array.first == program)
+                {
+                    /// Call should never fail
+                    GLState::current().bindVertexArray(array.second);
+                    return;
+                }
+            }
+
+            GLuint array;
+            glGenVertexArrays(1, &array);
             /// Call should never fail
-            glBindBuffer(GL_ARRAY_BUFFER, preserved);
+            GLState::current().bindVertexArray(array);
+            GLState::current().bindBuffer(GL_ARRAY_BUFFER, buffer);
+            try
+            {
+                for(std::unique_ptr<AttributePointerBase>& ptr : attributes)
+                {
+                    ptr->bind(program);
+                }
+            }
+            catch(...)
+            {
+                GLState::current().bindVertexArray(0);
+                GLState::current().deleteVertexArray(array);
+                throw;
+            }
+            arrays.emplace_back(program, array);
+        }
+
+        /**
+         * Determines whether the provided vertex array is one of the recorded ones
+         * 
+         * @param array the handle of a vertex array
+         * 
+         * @return true if the vertex array was recorded by this VertexArrayCache, otherwise false
+         * 
+         */
+        bool contains(GLuint array) const noexcept
+        {
+            for(const std::pair<GLuint, GLuint>& recorded : arrays)
+            {
+                if(recorded.second == array)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * Deletes every recorded vertex array
+         * 
+         */
+        void clear() noexcept
+        {
+            for(std::pair<GLuint, GLuint>& array : arrays)
+            {
+                /// Call should never fail
+                GLState::current().deleteVertexArray(array.second);
+            }
+            arrays.clear();
+        }
+
+        ~VertexArrayCache()
+        {
+            clear();
         }
     };
 
@@ -356,7 +461,7 @@ namespace detail
         }
     };
 
-    template<typename T, GLenum PolyType, GLenum Usage>
+    template<typename T, GLenum PolyType, GLenum Usage, BufferRetention Retention = DefaultRetention<Usage>::value>
     class VertexBufferImpl : public VertexBuffer<T>
     {
         static_assert(PolyType == GL_TRIANGLES || PolyType == GL_QUADS, "Invalid poly type template provided to VertexBufferImpl");
@@ -371,17 +476,28 @@ namespace detail
                 Usage == GL_DYNAMIC_READ ||
                 Usage == GL_DYNAMIC_COPY,
                 "Invalid intended usage template provided to VertexBufferImpl");
+        /// Vertex data has no order, so there are no bounds to keep in place of it
+        static_assert(Retention != BufferRetention::Bounds, "Only Keep and Discard retention may be used with VertexBufferImpl");
 
         /// The implementation supplied handle to this buffer object
         GLuint handle;
 
-        /// The data backing this buffer object
+        /// The data backing this buffer object, if it is kept (see BufferRetention)
         std::vector<T> data;
 
+        /// The number of elements in this buffer object
+        std::size_t count;
+
+        /// The ranges of data that have been updated since they were last uploaded
+        DirtyRangeSet dirty;
+
         /// A list of attribute pointers that are associated with this buffer object
         std::list<std::unique_ptr<detail::AttributePointerBase >> attributes;
 
-        void rebuffer(const std::vector<T>& data)
+        /// The attribute pointers, as recorded for each program that this buffer object has been bound with
+        detail::VertexArrayCache vertexArrays;
+
+        void rebuffer(std::vector<T>&& data)
         {
             GLuint newHandle;
             glGenBuffers(1, &newHandle);
@@ -389,81 +505,133 @@ namespace detail
             glBufferData(GL_ARRAY_BUFFER, sizeof(T) * data.size(), &data[0], Usage);
             if(glGetError() == GL_OUT_OF_MEMORY)
             {
-                glDeleteBuffers(1, &newHandle);
+                GLState::current().deleteBuffer(newHandle);
                 throw ResourceException("Unable to allocate GPU memory for VertexBuffer");
             }
-            this->data = data;
-            glDeleteBuffers(1, &this->handle);
+            count = data.size();
+            if(Retention == BufferRetention::Keep)
+            {
+                this->data = std::move(data);
+            }
+            dirty.clear();
+            GLState::current().deleteBuffer(this->handle);
             this->handle = newHandle;
+            vertexArrays.clear();
         }
 
       public:
 
-        VertexBufferImpl(const std::vector<T>& data) : VertexBuffer<T>(data),
-        data(data)
+        /**
+         * Uploads the provided array of data straight from where it lies (a memory-mapped file, for instance)
+         * 
+         * @param data the array of data to build this VertexBuffer with
+         * 
+         * @param count the number of elements in the array
+         * 
+         */
+        VertexBufferImpl(const T* data, std::size_t count) : VertexBuffer<T>(std::vector<T>()),
+        data(Retention == BufferRetention::Keep ? std::vector<T>(data, data + count) : std::vector<T>()),
+        count(count)
         {
             glGenBuffers(1, &handle);
             detail::VertexBufferBindHelper helper(handle);
 
             /// Can set GL_OUT_OF_MEMORY
             /// https://www.opengl.org/sdk/docs/man4/xhtml/glBufferData.xml
-            glBufferData(GL_ARRAY_BUFFER, sizeof(T) * data.size(), &data[0], Usage);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(T) * count, data, Usage);
 
             if(glGetError() == GL_OUT_OF_MEMORY)
             {
+                GLState::current().deleteBuffer(handle);
                 throw ResourceException("Unable to allocate GPU memory for VertexBuffer");
             }
         }
 
-        VertexBufferImpl(std::vector<T>&& data) : VertexBuffer<T>(data), data(data)
+        VertexBufferImpl(const std::vector<T>& data) : VertexBufferImpl(data.data(), data.size())
+        {
+        }
+
+        VertexBufferImpl(std::vector<T>&& data) : VertexBuffer<T>(data), data(std::move(data)), count(this->data.size())
         {
             glGenBuffers(1, &handle);
             detail::VertexBufferBindHelper helper(handle);
 
             /// Can set GL_OUT_OF_MEMORY
             /// https://www.opengl.org/sdk/docs/man4/xhtml/glBufferData.xml
-            glBufferData(GL_ARRAY_BUFFER, sizeof(T) * data.size(), &data[0], Usage);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(T) * this->data.size(), &this->data[0], Usage);
 
             if(glGetError() == GL_OUT_OF_MEMORY)
             {
+                GLState::current().deleteBuffer(handle);
                 throw ResourceException("Unable to allocate GPU memory for VertexBuffer");
             }
+            if(Retention != BufferRetention::Keep)
+            {
+                std::vector<T>().swap(this->data);
+            }
         }
 
         VertexBufferImpl(VertexBufferImpl&& rhs) :
         VertexBuffer<T>(rhs.data),
         handle(rhs.handle),
         data(std::move(rhs.data)),
-        attributes(std::move(rhs.attributes))
+        count(rhs.count),
+        dirty(std::move(rhs.dirty)),
+        attributes(std::move(rhs.attributes)),
+        vertexArrays(std::move(rhs.vertexArrays))
         {
             rhs.handle = 0;
         }
 
         std::size_t vertexCount()
         {
-            return data.size() / PolySize<PolyType>::size();
+            return count / PolySize<PolyType>::size();
         }
 
         void setVertexData(const std::vector<T>& data)
         {
-            GLint bound;
-            glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &bound);
-            if(handle == static_cast<GLuint>(bound))
+            if(vertexArrays.contains(GLState::current().getVertexArray()))
             {
                 throw midnight::glsl::BindException("Unable to rebuffer vertex buffer, as it actively bound");
             }
-            rebuffer(data);
+            rebuffer(std::vector<T>(data));
         }
 
         void setVertexData(std::vector<T>&& data)
         {
-            GLint bound;
-            glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &bound);
-            if(handle == static_cast<GLuint>(bound))
+            if(vertexArrays.contains(GLState::current().getVertexArray()))
             {
                 throw midnight::glsl::BindException("Unable to rebuffer vertex buffer, as it actively bound");
             }
-            rebuffer(data);
+            rebuffer(std::move(data));
+        }
+
+        void updateVertexData(std::size_t offset, const T* data, std::size_t count)
+        {
+            if(offset > this->count || count > this->count - offset)
+            {
+                throw IllegalArgumentException("Unable to update vertex buffer, as the range exceeds its size");
+            }
+            if(Retention == BufferRetention::Keep)
+            {
+                std::copy(data, data + count, this->data.begin() + offset);
+                dirty.add(offset, offset + count);
+            }
+            else if(count != 0)
+            {
+                detail::VertexBufferBindHelper helper(handle);
+                glBufferSubData(GL_ARRAY_BUFFER, sizeof(T) * offset, sizeof(T) * count, data);
+            }
+        }
+
+        void flush(bool orphan = false)
+        {
+            if(dirty.isEmpty())
+            {
+                return;
+            }
+            detail::VertexBufferBindHelper helper(handle);
+            detail::uploadDirtyRanges(GL_ARRAY_BUFFER, data, dirty, Usage, orphan);
         }
 
         void addAttributePointer(const std::string& name,
@@ -475,6 +643,7 @@ namespace detail
         {
             // TODO: C++14 -> replace with std::make_unique(...)
             attributes.push_back(std::move(std::unique_ptr<detail::AttributePointerBase>(new detail::AttributePointer(name, size, type, normalized, stride, offset))));
+            vertexArrays.clear();
         }
 
         void addAttributeIPointer(const std::string& name,
@@ -485,6 +654,7 @@ namespace detail
         {
             // TODO: C++14 -> replace with std::make_unique(...)
             attributes.push_back(std::move(std::unique_ptr<detail::AttributePointerBase>(new detail::AttributeIPointer(name, size, type, stride, offset))));
+            vertexArrays.clear();
         }
 
         void addAttributeLPointer(const std::string& name,
@@ -494,48 +664,38 @@ namespace detail
         {
             // TODO: C++14 -> replace with std::make_unique(...)
             attributes.push_back(std::move(std::unique_ptr<detail::AttributePointerBase>(new detail::AttributeLPointer(name, size, GL_DOUBLE, stride, offset))));
+            vertexArrays.clear();
         }
 
         void bind()
         {
-            GLint programHandle;
-            /// Call should never fail
-            glGetIntegerv(GL_CURRENT_PROGRAM, &programHandle);
+            const GLuint programHandle = GLState::current().getProgram();
             if(programHandle == 0)
             {
                 throw midnight::glsl::BindException("A program must first be bound before binding a VertexBuffer");
             }
-            /// Call should never fail
-            glBindBuffer(GL_ARRAY_BUFFER, handle);
-
-            /// Apply each of our attributes
-            for(std::unique_ptr<detail::AttributePointerBase>& ptr : attributes)
-            {
-                ptr->bind(static_cast<GLuint>(programHandle));
-            }
+            /// The GL_ARRAY_BUFFER binding is not vertex array state - the attributes recorded their buffer - so 
+            /// it is only bound to upload pending updates
+            flush();
+            vertexArrays.bind(programHandle, handle, attributes);
         }
 
         void unbind() noexcept
         {
-            /// Call should never fail
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-            /// Basically, just disable each attribute index that we used
-            for(std::unique_ptr<detail::AttributePointerBase>& ptr : attributes)
-            {
-                ptr->unbind();
-            }
+            /// Our attribute state lives in the vertex arrays, so restoring the default one undoes all of it
+            GLState::current().bindVertexArray(0);
         }
 
         void resetAttributes() noexcept
         {
             attributes.clear();
+            vertexArrays.clear();
         }
 
         ~VertexBufferImpl()
         {
             /// Call should never fail
-            glDeleteBuffers(1, &handle);
+            GLState::current().deleteBuffer(handle);
         }
     };
 }
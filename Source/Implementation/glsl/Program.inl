@@ -1,9 +1,14 @@
+#include <algorithm>
 #include <initializer_list>
 #include <functional>
+#include <limits>
+#include <memory>
 #include <tuple>
 
 #include "BindException.hpp"
+#include "dynamic_assert.hpp"
 #include "dynamic_warn.hpp"
+#include "GLState.hpp"
 #include "LinkingError.hpp"
 #include "ResourceException.hpp"
 #include "Tuple.hpp"
@@ -58,10 +63,10 @@ namespace detail
         static_assert(TypeChecker<ConversionChecker, Args...>::value, "Type mismatch detected");
     };
 
-    GLint getUniformLocation(GLuint handle, const std::string& uniformID)
+    inline GLint getUniformLocation(GLuint handle, const char* uniformID)
     {
         GLint location = glGetUniformLocation(handle,
-                static_cast<const GLchar*>(uniformID.c_str()));
+                static_cast<const GLchar*>(uniformID));
         /// Call returns -1 upon failure
         if(location == -1)
         {
@@ -70,6 +75,9 @@ namespace detail
         return location;
     }
 
+    /// The location that marks a hash shared by the names of several uniforms, which must be located by name
+    constexpr GLint AMBIGUOUS_UNIFORM_LOCATION = -2;
+
     /**
      * Copies the provided tuple in the provided array
      * 
@@ -264,19 +272,19 @@ namespace detail
 
     class BindHelper
     {
-        GLint preserved;
+        GLuint preserved;
 
       public:
 
-        BindHelper(GLuint handle)
+        BindHelper(GLuint handle) :
+        preserved(midnight::GLState::current().getProgram())
         {
-            glGetIntegerv(GL_CURRENT_PROGRAM, &preserved);
-            glUseProgram(handle);
+            midnight::GLState::current().useProgram(handle);
         }
 
         ~BindHelper()
         {
-            glUseProgram(preserved);
+            midnight::GLState::current().useProgram(preserved);
         }
     };
 
@@ -358,6 +366,69 @@ handle(glCreateProgram())
         /// Shaders implicitly detached by the LinkHelper destructor
         throw midnight::glsl::LinkingError(std::string(buffer.get()));
     }
+    resolveUniformLocations();
+}
+
+inline void Program::resolveUniformLocations()
+{
+    GLint count;
+    GLint maxLength;
+
+    /// These should not set any flags, nor fail
+    /// http://www.opengl.org/sdk/docs/man/xhtml/glGetProgram.xml
+    glGetProgramiv(handle, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(handle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::unique_ptr<GLchar[]> name(new GLchar[std::max(maxLength, 1)]);
+    for(GLint i = 0; i < count; ++i)
+    {
+        GLsizei length;
+        GLint size;
+        GLenum type;
+        glGetActiveUniform(handle, static_cast<GLuint>(i), maxLength, &length, &size, &type, name.get());
+
+        /// Members of uniform blocks have no location
+        GLint location = glGetUniformLocation(handle, name.get());
+        if(location == -1)
+        {
+            continue;
+        }
+        uniformLocations.push_back(std::make_pair(hashCode(name.get()), location));
+
+        /// Arrays are reported by their first element, but are also set by their bare name
+        if(length > 3 && std::string(name.get() + length - 3) == "[0]")
+        {
+            name[length - 3] = '\0';
+            uniformLocations.push_back(std::make_pair(hashCode(name.get()), location));
+        }
+    }
+
+    std::sort(uniformLocations.begin(), uniformLocations.end());
+    for(std::size_t i = 1; i < uniformLocations.size(); ++i)
+    {
+        if(uniformLocations[i].first == uniformLocations[i - 1].first)
+        {
+            uniformLocations[i - 1].second = detail::AMBIGUOUS_UNIFORM_LOCATION;
+            uniformLocations[i].second = detail::AMBIGUOUS_UNIFORM_LOCATION;
+        }
+    }
+}
+
+inline GLint Program::getUniformLocation(const UniformName& uniformID) const
+{
+    const std::pair<std::size_t, GLint> key(uniformID.getHash(), std::numeric_limits<GLint>::min());
+    std::vector<std::pair<std::size_t, GLint>>::const_iterator i = std::lower_bound(uniformLocations.begin(), uniformLocations.end(), key);
+
+    /// Names that were not resolved (the elements of arrays, for instance) and names that share a hash are located 
+    /// by name
+    if(i == uniformLocations.end() || i->first != uniformID.getHash() || i->second == detail::AMBIGUOUS_UNIFORM_LOCATION)
+    {
+        return detail::getUniformLocation(handle, uniformID.getName());
+    }
+
+    /// An inactive name whose hash collides with that of an active uniform would be mistaken for it
+    dynamic_assert(glGetUniformLocation(handle, uniformID.getName()) == i->second, "Uniform location cache is out of sync");
+    return i->second;
 }
 
 template<typename ...E>
@@ -380,7 +451,7 @@ inline Program::Program(Shader& first, E&... shaders) : Program({&first, &shader
 
 }
 
-Program::Program(Program&& other) : handle(other.handle)
+Program::Program(Program&& other) : handle(other.handle), uniformLocations(std::move(other.uniformLocations))
 {
     /// Copy-constructing from self would create a resource leak!
     if(&other != this)
@@ -398,6 +469,7 @@ Program& Program::operator=(Program&& other)
     if(&other != this)
     {
         this->handle = other.handle;
+        this->uniformLocations = std::move(other.uniformLocations);
         other.handle = 0;
     }
     else
@@ -412,25 +484,24 @@ void Program::bind()
     /// It's a bit...ambiguous why this might fail...
     /// Spec designers dropped the ball on this one.
     /// http://www.opengl.org/sdk/docs/man4/xhtml/glUseProgram.xml
-    glUseProgram(handle);
-    if(glGetError() == GL_INVALID_OPERATION)
+    if(midnight::GLState::current().useProgram(handle) && glGetError() == GL_INVALID_OPERATION)
     {
+        /// The program that remains current is no longer known
+        midnight::GLState::current().invalidate();
         throw midnight::glsl::BindException("Unable to bind program");
     }
 }
 
 void Program::unbind()
 {
-    GLint current;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &current);
-    if(handle == static_cast<GLuint>(current))
+    if(handle == midnight::GLState::current().getProgram())
     {
         /// It's a bit...ambiguous why this might fail...
         /// Spec designers dropped the ball on this one.
         /// http://www.opengl.org/sdk/docs/man4/xhtml/glUseProgram.xml
-        glUseProgram(0);
-        if(glGetError() == GL_INVALID_OPERATION)
+        if(midnight::GLState::current().useProgram(0) && glGetError() == GL_INVALID_OPERATION)
         {
+            midnight::GLState::current().invalidate();
             throw midnight::glsl::BindException("Unable to unbind program");
         }
     }
@@ -441,7 +512,7 @@ void Program::unbind()
 }
 
 template<typename... E>
-void Program::setUniform(const std::string& uniformID, E&&... tuples)
+void Program::setUniform(const UniformName& uniformID, E&&... tuples)
 {
     /// Compile-time assertion that the tuples aren't mixed and matched...
     detail::TypeCheckAssertion < E...>();
@@ -453,7 +524,7 @@ void Program::setUniform(const std::string& uniformID, E&&... tuples)
     static_assert((N / sizeof...(E)) > 0 && (N / sizeof...(E)) < 5, "Invalid uniform array element type");
 
     /// Can fail with an exception, so try this before copying the provided tuples
-    GLint uniformLocation = detail::getUniformLocation(handle, uniformID);
+    GLint uniformLocation = getUniformLocation(uniformID);
 
     /// Copy the provided tuples into a monolithic array to pass to the GPU
     std::array<T, N> array;
@@ -471,7 +542,7 @@ void Program::setUniform(const std::string& uniformID, E&&... tuples)
     GLenum error = glGetError();
     if(error == GL_INVALID_OPERATION)
     {
-        throw midnight::glsl::UniformMismatchException(std::string("The provided uniform type \"") + uniformID +
+        throw midnight::glsl::UniformMismatchException(std::string("The provided uniform type \"") + uniformID.getName() +
                 "\" is incompatible with the type declared in the program");
     }
 }
@@ -507,9 +578,20 @@ namespace detail
 }
 
 template<typename T, std::size_t Rows, std::size_t Columns>
-void Program::setMatrixUniform(const std::string& uniformID, const midnight::Matrix<T, Rows, Columns>& matrix)
+void Program::setMatrixUniform(const UniformName& uniformID, const midnight::Matrix<T, Rows, Columns>& matrix)
 {
-    GLint uniformLocation = detail::getUniformLocation(handle, uniformID);
+    GLint uniformLocation = getUniformLocation(uniformID);
     detail::BindHelper binder(handle);
     detail::MatrixUniformHelper<T, Rows, Columns>::setUniform(uniformLocation, matrix);
 }
+
+inline void Program::setUniformBlockBinding(const std::string& blockID, GLuint binding)
+{
+    GLuint blockIndex = glGetUniformBlockIndex(handle, static_cast<const GLchar*>(blockID.c_str()));
+    /// Call returns GL_INVALID_INDEX upon failure
+    if(blockIndex == GL_INVALID_INDEX)
+    {
+        throw midnight::glsl::UniformNotFoundException(std::string("Unable to locate uniform block \"") + blockID + "\"");
+    }
+    glUniformBlockBinding(handle, blockIndex, binding);
+}
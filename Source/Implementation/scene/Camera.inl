@@ -28,6 +28,37 @@ inline Matrix4x4F Camera::getOrientation() const noexcept
     return orientation.operator Matrix<float,4,4>();
 }
 
+inline void Camera::getFrustumPlanes(float (&planes)[6][4]) const noexcept
+{
+    /// The shaders compute (v * orientation) * projection, so row k of the clip matrix is column k of the
+    /// product orientation * projection
+    const Matrix4x4F projection = getProjection();
+    const Matrix4x4F orientation = getOrientation();
+    float clip[4][4];
+    for(std::size_t k = 0; k < 4; ++k)
+    {
+        for(std::size_t r = 0; r < 4; ++r)
+        {
+            clip[k][r] = 0.0f;
+            for(std::size_t c = 0; c < 4; ++c)
+            {
+                clip[k][r] += orientation(r, c) * projection(c, k);
+            }
+        }
+    }
+
+    /// -w <= x, y, z <= w, each side being a plane; the offset by our position is folded into d
+    for(std::size_t i = 0; i < 6; ++i)
+    {
+        const float sign = i % 2 == 0 ? 1.0f : -1.0f;
+        for(std::size_t j = 0; j < 4; ++j)
+        {
+            planes[i][j] = clip[3][j] + sign * clip[i / 2][j];
+        }
+        planes[i][3] += planes[i][0] * position[0] + planes[i][1] * position[1] + planes[i][2] * position[2];
+    }
+}
+
 inline void Camera::rotate(const Vector3F& axis, const Radians<float>& angle)
 {
     this->orientation *= Quaternion<float>(axis, angle);
@@ -0,0 +1,86 @@
+#include <cstring>
+
+#include "GLState.hpp"
+#include "ResourceException.hpp"
+
+namespace midnight
+{
+    namespace detail
+    {
+        /**
+         * Copies the provided Tuple into the provided std140 vec4
+         *
+         */
+        template<std::size_t N>
+        void copyVec4(const Tuple<float, N>& tuple, float w, float (&vec4)[4]) noexcept
+        {
+            for(std::size_t i = 0; i < 4; ++i)
+            {
+                vec4[i] = i < N ? tuple[i] : w;
+            }
+        }
+    }
+
+    inline FrameUniforms::FrameUniforms() noexcept :
+        handle(0),
+        block(),
+        uploaded(false)
+    {
+        setSunPosition(Tuple4F(0.0f, 100.0f, 1.0f, 1.0f));
+        setSunColor(Tuple4F(1.0f, 1.0f, 0.0f, 1.0f));
+    }
+
+    inline void FrameUniforms::update(const Camera& camera)
+    {
+        Block current = block;
+        const Matrix4x4F projection = camera.getProjection();
+        const Matrix4x4F orientation = camera.getOrientation();
+        std::memcpy(current.projection, &projection, sizeof(current.projection));
+        std::memcpy(current.orientation, &orientation, sizeof(current.orientation));
+        detail::copyVec4(camera.getPosition(), 0.0f, current.offset);
+
+        if(handle == 0)
+        {
+            glGenBuffers(1, &handle);
+        }
+        GLState::current().bindBuffer(GL_UNIFORM_BUFFER, handle);
+        if(!uploaded || std::memcmp(&current, &block, sizeof(Block)) != 0)
+        {
+            block = current;
+
+            /// Can set GL_OUT_OF_MEMORY
+            /// https://www.opengl.org/sdk/docs/man4/html/glBufferData.xhtml
+            glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), &block, GL_DYNAMIC_DRAW);
+            if(glGetError() == GL_OUT_OF_MEMORY)
+            {
+                uploaded = false;
+                throw ResourceException("Unable to allocate GPU memory for FrameUniforms");
+            }
+            uploaded = true;
+        }
+
+        /// Also binds the generic target, which was bound to the same buffer above
+        glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, handle);
+    }
+
+    inline void FrameUniforms::setSunPosition(const Tuple4F& position) noexcept
+    {
+        detail::copyVec4(position, 1.0f, block.sunPosition);
+        uploaded = false;
+    }
+
+    inline void FrameUniforms::setSunColor(const Tuple4F& color) noexcept
+    {
+        detail::copyVec4(color, 1.0f, block.sunColor);
+        uploaded = false;
+    }
+
+    inline FrameUniforms::~FrameUniforms()
+    {
+        if(handle != 0)
+        {
+            /// Call should never fail
+            GLState::current().deleteBuffer(handle);
+        }
+    }
+}
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+#include "IllegalArgumentException.hpp"
+#include "MeshOptimizer.hpp"
+
+namespace midnight
+{
+
+    inline HalfEdgeMesh::HalfEdgeMesh(const std::vector<std::size_t>& indices, std::size_t vertexCount, std::size_t threadCount)
+    {
+        build(indices, vertexCount, threadCount);
+    }
+
+    inline HalfEdgeMesh::HalfEdgeMesh(const Mesh& mesh, std::size_t threadCount)
+    {
+        std::vector<std::size_t> indices;
+        for(const Mesh::Renderable& renderable : mesh.getMeshes())
+        {
+            indices.insert(indices.end(), renderable.indices.begin(), renderable.indices.end());
+        }
+        build(indices, mesh.getVertices().size(), threadCount);
+    }
+
+    inline void HalfEdgeMesh::build(const std::vector<std::size_t>& indices, std::size_t vertexCount, std::size_t threadCount)
+    {
+        detail::validateTriangleList(indices, vertexCount);
+        if(indices.size() >= NONE || vertexCount >= NONE)
+        {
+            throw IllegalArgumentException("A HalfEdgeMesh can not hold 2^32 half-edges or vertices");
+        }
+        const std::size_t threads = threadCount != 0 ? threadCount : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+        origins.resize(indices.size());
+        detail::parallelFor(indices.size(), threads, [&](std::size_t first, std::size_t last)
+        {
+            for(std::size_t h = first; h < last; ++h)
+            {
+                origins[h] = static_cast<uint32_t>(indices[h]);
+            }
+        });
+
+        /// The corners of a vertex are exactly the half-edges that leave it
+        detail::buildVertexCorners(indices, vertexCount, outgoingOffsets, outgoing);
+
+        /// Each half-edge a->b looks for the only b->a - every half-edge writes its own twin alone
+        twins.resize(indices.size());
+        detail::parallelFor(indices.size(), threads, [&](std::size_t first, std::size_t last)
+        {
+            for(std::size_t h = first; h < last; ++h)
+            {
+                const uint32_t halfEdge = static_cast<uint32_t>(h);
+                const uint32_t a = getOrigin(halfEdge);
+                const uint32_t b = getDestination(halfEdge);
+
+                uint32_t twin = NONE;
+                std::size_t opposite = 0;
+                for(uint32_t i = outgoingOffsets[b]; i < outgoingOffsets[b + 1]; ++i)
+                {
+                    if(getDestination(outgoing[i]) == a)
+                    {
+                        twin = outgoing[i];
+                        ++opposite;
+                    }
+                }
+                std::size_t parallel = 0;
+                for(uint32_t i = outgoingOffsets[a]; i < outgoingOffsets[a + 1]; ++i)
+                {
+                    parallel += getDestination(outgoing[i]) == b ? 1 : 0;
+                }
+
+                /// An edge of more than two half-edges (or of two with the same direction) is left unpaired
+                twins[h] = opposite == 1 && parallel == 1 ? twin : NONE;
+            }
+        });
+    }
+
+    inline bool HalfEdgeMesh::isBoundaryVertex(uint32_t vertex) const noexcept
+    {
+        for(uint32_t i = outgoingOffsets[vertex]; i < outgoingOffsets[vertex + 1]; ++i)
+        {
+            const uint32_t halfEdge = outgoing[i];
+            if(isBoundary(halfEdge) || isBoundary(getPrevious(halfEdge)))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline bool HalfEdgeMesh::isClosed() const noexcept
+    {
+        return std::none_of(twins.begin(), twins.end(), [](uint32_t twin)
+        {
+            return twin == NONE;
+        });
+    }
+
+    template<typename F>
+    void HalfEdgeMesh::forEachNeighbour(uint32_t vertex, F function) const
+    {
+        const uint32_t first = outgoingOffsets[vertex];
+        const uint32_t last = outgoingOffsets[vertex + 1];
+
+        /// The far end of every outgoing half-edge (valences are small, so duplicates are found by scanning)
+        for(uint32_t i = first; i < last; ++i)
+        {
+            const uint32_t neighbour = getDestination(outgoing[i]);
+            bool seen = false;
+            for(uint32_t j = first; j < i && !seen; ++j)
+            {
+                seen = getDestination(outgoing[j]) == neighbour;
+            }
+            if(!seen)
+            {
+                function(neighbour);
+            }
+        }
+
+        /// On a boundary, the near end of an incoming half-edge without a twin is not the far end of any outgoing one
+        for(uint32_t i = first; i < last; ++i)
+        {
+            const uint32_t incoming = getPrevious(outgoing[i]);
+            if(!isBoundary(incoming))
+            {
+                continue;
+            }
+            const uint32_t neighbour = getOrigin(incoming);
+            bool seen = false;
+            for(uint32_t j = first; j < last && !seen; ++j)
+            {
+                seen = getDestination(outgoing[j]) == neighbour ||
+                    (j < i && isBoundary(getPrevious(outgoing[j])) && getOrigin(getPrevious(outgoing[j])) == neighbour);
+            }
+            if(!seen)
+            {
+                function(neighbour);
+            }
+        }
+    }
+
+    template<typename F>
+    void HalfEdgeMesh::forEachTriangle(uint32_t vertex, F function) const
+    {
+        for(uint32_t i = outgoingOffsets[vertex]; i < outgoingOffsets[vertex + 1]; ++i)
+        {
+            function(getTriangle(outgoing[i]));
+        }
+    }
+}
@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+#include "IllegalArgumentException.hpp"
+
+namespace midnight
+{
+
+    namespace detail
+    {
+        /// The multipliers that spread lattice coordinates across the 16 bits of their hash
+        constexpr uint32_t LATTICE_PRIME_X = 0x9E37u;
+        constexpr uint32_t LATTICE_PRIME_Y = 0x7F4Bu;
+
+        /// The multiplier that finalises the hash of a lattice point
+        constexpr uint32_t LATTICE_MIX = 0xB5A3u;
+
+        /**
+         * Finalises the 16-bit hash of a lattice point, whose two most significant bits then select the signs of
+         * its diagonal gradient
+         *
+         */
+        inline uint32_t mixLattice(uint32_t hash) noexcept
+        {
+            return ((hash ^ (hash >> 8)) * LATTICE_MIX) & 0xFFFFu;
+        }
+
+        /**
+         * Evaluates the gradient selected by the provided hash at the provided offset from its lattice point
+         *
+         */
+        inline float latticeGradient(uint32_t hash, float x, float y) noexcept
+        {
+            hash = mixLattice(hash);
+            return ((hash & 0x8000u) != 0 ? -x : x) + ((hash & 0x4000u) != 0 ? -y : y);
+        }
+
+#if defined(__SSE2__)
+        /**
+         * Four lanes of latticeGradient.  The hashes occupy the low halves of the lanes, so that each multiply is a
+         * single pmullw, and their sign bits are moved onto the offsets directly.
+         *
+         */
+        inline __m128 latticeGradient(__m128i hash, __m128 x, __m128 y) noexcept
+        {
+            const __m128i sign = _mm_set1_epi32(static_cast<int>(0x80000000u));
+            hash = _mm_mullo_epi16(_mm_xor_si128(hash, _mm_srli_epi32(hash, 8)), _mm_set1_epi32(static_cast<int>(LATTICE_MIX)));
+            const __m128 xSign = _mm_castsi128_ps(_mm_and_si128(_mm_slli_epi32(hash, 16), sign));
+            const __m128 ySign = _mm_castsi128_ps(_mm_and_si128(_mm_slli_epi32(hash, 17), sign));
+            return _mm_add_ps(_mm_xor_ps(x, xSign), _mm_xor_ps(y, ySign));
+        }
+
+        /**
+         * Splits four coordinates into their lattice cells and their offsets within them (as std::floor would)
+         *
+         */
+        inline __m128i splitCoordinates(__m128 coordinates, __m128& offsets) noexcept
+        {
+            __m128i cells = _mm_cvttps_epi32(coordinates);
+            __m128 truncated = _mm_cvtepi32_ps(cells);
+
+            /// Truncation rounds negative coordinates up, so step those back down by one
+            const __m128 roundedUp = _mm_cmpgt_ps(truncated, coordinates);
+            cells = _mm_add_epi32(cells, _mm_castps_si128(roundedUp));
+            truncated = _mm_sub_ps(truncated, _mm_and_ps(roundedUp, _mm_set1_ps(1.0f)));
+            offsets = _mm_sub_ps(coordinates, truncated);
+            return cells;
+        }
+
+        /**
+         * Four lanes of the quintic fade curve
+         *
+         */
+        inline __m128 fade(__m128 t) noexcept
+        {
+            const __m128 inner = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))), _mm_set1_ps(10.0f));
+            return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+        }
+#endif
+
+        /**
+         * Evaluates gradient noise at the provided points one at a time.  This is the path taken without SSE2, and
+         * is the reference that the SSE2 path must match.
+         *
+         */
+        inline void gradientNoiseScalar(const float* xs, const float* ys, float* out, std::size_t count, uint32_t seed,
+            uint32_t seedShift) noexcept
+        {
+            /// The hash of a lattice point is mix(X * PRIME_X ^ Y * PRIME_Y ^ seed) in 16-bit arithmetic (so the noise
+            /// repeats every 65536 cells), and the products of the next lattice lines are found by adding the primes
+            /// rather than by multiplying again
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                const float fx = std::floor(xs[i]);
+                const float fy = std::floor(ys[i]);
+                const uint32_t X = static_cast<uint32_t>(static_cast<int32_t>(fx));
+                const uint32_t Y = static_cast<uint32_t>(static_cast<int32_t>(fy));
+                const float x = xs[i] - fx;
+                const float y = ys[i] - fy;
+
+                /// Quintic fade curves
+                const float u = x * x * x * (x * (x * 6.0f - 15.0f) + 10.0f);
+                const float v = y * y * y * (y * (y * 6.0f - 15.0f) + 10.0f);
+
+                const uint32_t hashX0 = (X * LATTICE_PRIME_X + seedShift) & 0xFFFFu;
+                const uint32_t hashX1 = (hashX0 + LATTICE_PRIME_X) & 0xFFFFu;
+                const uint32_t hashY0 = (Y * LATTICE_PRIME_Y) & 0xFFFFu;
+                const uint32_t hashY1 = ((hashY0 + LATTICE_PRIME_Y) & 0xFFFFu) ^ seed;
+                const uint32_t seededY0 = hashY0 ^ seed;
+
+                const float g00 = latticeGradient(hashX0 ^ seededY0, x, y);
+                const float g10 = latticeGradient(hashX1 ^ seededY0, x - 1.0f, y);
+                const float g01 = latticeGradient(hashX0 ^ hashY1, x, y - 1.0f);
+                const float g11 = latticeGradient(hashX1 ^ hashY1, x - 1.0f, y - 1.0f);
+
+                const float a = g00 + u * (g10 - g00);
+                const float b = g01 + u * (g11 - g01);
+                out[i] = a + v * (b - a);
+            }
+        }
+
+#if defined(__SSE2__)
+        /**
+         * Evaluates gradient noise at the provided points four at a time, as gradientNoiseScalar would
+         *
+         * @param count the number of points, which must be a multiple of 4
+         *
+         */
+        inline void gradientNoiseSSE2(const float* xs, const float* ys, float* out, std::size_t count, uint32_t seed,
+            uint32_t seedShift) noexcept
+        {
+            const __m128i primeX = _mm_set1_epi32(static_cast<int>(LATTICE_PRIME_X));
+            const __m128i primeY = _mm_set1_epi32(static_cast<int>(LATTICE_PRIME_Y));
+            const __m128i seeds = _mm_set1_epi32(static_cast<int>(seed));
+            const __m128i shift = _mm_set1_epi32(static_cast<int>(seedShift));
+            const __m128 one = _mm_set1_ps(1.0f);
+            for(std::size_t i = 0; i < count; i += 4)
+            {
+                __m128 x;
+                __m128 y;
+                const __m128i X = splitCoordinates(_mm_loadu_ps(xs + i), x);
+                const __m128i Y = splitCoordinates(_mm_loadu_ps(ys + i), y);
+
+                /// The primes are zero in the high halves of the lanes, which keeps the high halves of the hashes zero
+                const __m128i hashX0 = _mm_add_epi16(_mm_mullo_epi16(X, primeX), shift);
+                const __m128i hashX1 = _mm_add_epi16(hashX0, primeX);
+                const __m128i hashY0 = _mm_mullo_epi16(Y, primeY);
+                const __m128i hashY1 = _mm_xor_si128(_mm_add_epi16(hashY0, primeY), seeds);
+                const __m128i seededY0 = _mm_xor_si128(hashY0, seeds);
+
+                const __m128 x1 = _mm_sub_ps(x, one);
+                const __m128 y1 = _mm_sub_ps(y, one);
+                const __m128 g00 = latticeGradient(_mm_xor_si128(hashX0, seededY0), x, y);
+                const __m128 g10 = latticeGradient(_mm_xor_si128(hashX1, seededY0), x1, y);
+                const __m128 g01 = latticeGradient(_mm_xor_si128(hashX0, hashY1), x, y1);
+                const __m128 g11 = latticeGradient(_mm_xor_si128(hashX1, hashY1), x1, y1);
+
+                const __m128 u = fade(x);
+                const __m128 v = fade(y);
+                const __m128 a = _mm_add_ps(g00, _mm_mul_ps(u, _mm_sub_ps(g10, g00)));
+                const __m128 b = _mm_add_ps(g01, _mm_mul_ps(u, _mm_sub_ps(g11, g01)));
+                _mm_storeu_ps(out + i, _mm_add_ps(a, _mm_mul_ps(v, _mm_sub_ps(b, a))));
+            }
+        }
+#endif
+    }
+
+    inline HeightmapGenerator::HeightmapGenerator(uint32_t seed, Variant variant) :
+        seed(detail::mixLattice(seed & 0xFFFFu)),
+        seedShift(((seed >> 16) * detail::LATTICE_PRIME_X) & 0xFFFFu),
+        variant(variant),
+        octaves(6),
+        frequency(1.0f / 256.0f),
+        lacunarity(2.0f),
+        gain(0.5f),
+        warpStrength(64.0f),
+        threadCount(0)
+    {
+    }
+
+    inline void HeightmapGenerator::noise(const float* xs, const float* ys, float* out) const noexcept
+    {
+#if defined(__SSE2__)
+        detail::gradientNoiseSSE2(xs, ys, out, BATCH_SIZE, seed, seedShift);
+#else
+        detail::gradientNoiseScalar(xs, ys, out, BATCH_SIZE, seed, seedShift);
+#endif
+    }
+
+    inline void HeightmapGenerator::fractal(const float* xs, const float* ys, float* out, bool ridged) const noexcept
+    {
+        float octaveXs[BATCH_SIZE];
+        float octaveYs[BATCH_SIZE];
+        float values[BATCH_SIZE];
+
+        std::fill(out, out + BATCH_SIZE, 0.0f);
+
+        float octaveFrequency = frequency;
+        float amplitude = 1.0f;
+        float amplitudeSum = 0.0f;
+        for(std::size_t octave = 0; octave < octaves; ++octave)
+        {
+            /// Offset each octave so that the lattices of the octaves do not line up at the origin
+            const float offset = static_cast<float>(octave) * 17.13f;
+            for(std::size_t i = 0; i < BATCH_SIZE; ++i)
+            {
+                octaveXs[i] = xs[i] * octaveFrequency + offset;
+                octaveYs[i] = ys[i] * octaveFrequency - offset;
+            }
+            noise(octaveXs, octaveYs, values);
+            if(ridged)
+            {
+                for(std::size_t i = 0; i < BATCH_SIZE; ++i)
+                {
+                    const float ridge = 1.0f - std::abs(values[i]);
+                    out[i] += amplitude * ridge * ridge;
+                }
+            }
+            else
+            {
+                for(std::size_t i = 0; i < BATCH_SIZE; ++i)
+                {
+                    out[i] += amplitude * values[i];
+                }
+            }
+            amplitudeSum += amplitude;
+            octaveFrequency *= lacunarity;
+            amplitude *= gain;
+        }
+
+        /// Map to [0, 1] - ridged octaves lie within [0, 1], plain ones within [-1, 1]
+        const float scale = amplitudeSum > 0.0f ? 1.0f / amplitudeSum : 0.0f;
+        for(std::size_t i = 0; i < BATCH_SIZE; ++i)
+        {
+            out[i] = ridged ? out[i] * scale : out[i] * scale * 0.5f + 0.5f;
+        }
+    }
+
+    inline void HeightmapGenerator::generateRows(std::size_t width, std::size_t firstRow, std::size_t lastRow, unsigned char* samples) const noexcept
+    {
+        float xs[BATCH_SIZE];
+        float ys[BATCH_SIZE];
+        float values[BATCH_SIZE];
+        float warpXs[BATCH_SIZE];
+        float warpYs[BATCH_SIZE];
+        float shiftedXs[BATCH_SIZE];
+        float shiftedYs[BATCH_SIZE];
+
+        for(std::size_t row = firstRow; row < lastRow; ++row)
+        {
+            for(std::size_t column0 = 0; column0 < width; column0 += BATCH_SIZE)
+            {
+                for(std::size_t i = 0; i < BATCH_SIZE; ++i)
+                {
+                    xs[i] = static_cast<float>(column0 + i);
+                    ys[i] = static_cast<float>(row);
+                }
+
+                if(variant == Variant::DOMAIN_WARP)
+                {
+                    /// Two decorrelated fields displace the coordinates of the final one
+                    fractal(xs, ys, warpXs, false);
+                    for(std::size_t i = 0; i < BATCH_SIZE; ++i)
+                    {
+                        shiftedXs[i] = xs[i] + 5217.0f;
+                        shiftedYs[i] = ys[i] + 1371.0f;
+                    }
+                    fractal(shiftedXs, shiftedYs, warpYs, false);
+                    for(std::size_t i = 0; i < BATCH_SIZE; ++i)
+                    {
+                        xs[i] += (warpXs[i] - 0.5f) * 2.0f * warpStrength;
+                        ys[i] += (warpYs[i] - 0.5f) * 2.0f * warpStrength;
+                    }
+                }
+
+                fractal(xs, ys, values, variant == Variant::RIDGED);
+
+                const std::size_t count = width - column0 < BATCH_SIZE ? width - column0 : BATCH_SIZE;
+                unsigned char* destination = samples + row * width + column0;
+                for(std::size_t i = 0; i < count; ++i)
+                {
+                    const float value = std::min(std::max(values[i], 0.0f), 1.0f);
+                    destination[i] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+                }
+            }
+        }
+    }
+
+    inline void HeightmapGenerator::setOctaves(std::size_t octaves) noexcept
+    {
+        this->octaves = octaves;
+    }
+
+    inline void HeightmapGenerator::setFrequency(float frequency) noexcept
+    {
+        this->frequency = frequency;
+    }
+
+    inline void HeightmapGenerator::setLacunarity(float lacunarity) noexcept
+    {
+        this->lacunarity = lacunarity;
+    }
+
+    inline void HeightmapGenerator::setGain(float gain) noexcept
+    {
+        this->gain = gain;
+    }
+
+    inline void HeightmapGenerator::setWarpStrength(float warpStrength) noexcept
+    {
+        this->warpStrength = warpStrength;
+    }
+
+    inline void HeightmapGenerator::setThreadCount(std::size_t threadCount) noexcept
+    {
+        this->threadCount = threadCount;
+    }
+
+    inline Heightmap HeightmapGenerator::generate(std::size_t width, std::size_t height) const
+    {
+        if(width == 0 || height == 0)
+        {
+            throw IllegalArgumentException("A heightmap must have at least one sample");
+        }
+
+        std::vector<unsigned char> samples(width * height);
+
+        std::size_t threads = threadCount != 0 ? threadCount : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        threads = std::min(threads, height);
+
+        /// The calling thread takes the last band of rows
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for(std::size_t i = 0; i < threads - 1; ++i)
+        {
+            workers.emplace_back(&HeightmapGenerator::generateRows, this, width, height * i / threads, height * (i + 1) / threads, samples.data());
+        }
+        generateRows(width, height * (threads - 1) / threads, height, samples.data());
+        for(std::thread& worker : workers)
+        {
+            worker.join();
+        }
+
+        return Heightmap(width, height, std::move(samples));
+    }
+}
@@ -0,0 +1,341 @@
+#include <algorithm>
+#include <cmath>
+
+#include "IllegalArgumentException.hpp"
+
+namespace midnight
+{
+    namespace detail
+    {
+        /**
+         * Intersects a ray with a triangle (Moller-Trumbore)
+         *
+         * @param origin the origin of the ray
+         *
+         * @param direction the direction of the ray
+         *
+         * @param a the first vertex of the triangle
+         *
+         * @param b the second vertex of the triangle
+         *
+         * @param c the third vertex of the triangle
+         *
+         * @param distance populated with the distance along the ray to the point of intersection
+         *
+         * @return true if the ray's line intersects the triangle, otherwise false
+         *
+         */
+        template<typename T>
+        bool intersectTriangle(const T origin[3], const T direction[3], const T a[3], const T b[3], const T c[3], T& distance) noexcept
+        {
+            const T e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            const T e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+            const T p[3] =
+            {
+                direction[1] * e2[2] - direction[2] * e2[1],
+                direction[2] * e2[0] - direction[0] * e2[2],
+                direction[0] * e2[1] - direction[1] * e2[0]
+            };
+            const T determinant = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+            if(std::abs(determinant) < std::numeric_limits<T>::epsilon())
+            {
+                return false;
+            }
+            const T inverse = static_cast<T>(1) / determinant;
+            const T s[3] = {origin[0] - a[0], origin[1] - a[1], origin[2] - a[2]};
+            const T u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inverse;
+            if(u < 0 || u > 1)
+            {
+                return false;
+            }
+            const T q[3] =
+            {
+                s[1] * e1[2] - s[2] * e1[1],
+                s[2] * e1[0] - s[0] * e1[2],
+                s[0] * e1[1] - s[1] * e1[0]
+            };
+            const T v = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) * inverse;
+            if(v < 0 || u + v > 1)
+            {
+                return false;
+            }
+            distance = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inverse;
+            return true;
+        }
+    }
+
+    inline HeightmapPyramid::HeightmapPyramid(const Heightmap& heightmap) :
+        width(heightmap.getWidth()),
+        height(heightmap.getHeight())
+    {
+        if(width < 2 || height < 2)
+        {
+            throw IllegalArgumentException("A heightmap must be at least 2x2 samples to be intersected");
+        }
+
+        samples.resize(width * height);
+        for(std::size_t z = 0; z < height; ++z)
+        {
+            for(std::size_t x = 0; x < width; ++x)
+            {
+                samples[z * width + x] = heightmap.getSample(x, z);
+            }
+        }
+
+        /// Level 0 holds a range per cell, and every other level halves the one below (rounding up)
+        levelWidths.push_back(width - 1);
+        levelHeights.push_back(height - 1);
+        while(levelWidths.back() > 1 || levelHeights.back() > 1)
+        {
+            levelWidths.push_back((levelWidths.back() + 1) / 2);
+            levelHeights.push_back((levelHeights.back() + 1) / 2);
+        }
+        for(std::size_t level = 0; level < levelWidths.size(); ++level)
+        {
+            levels.emplace_back(levelWidths[level] * levelHeights[level]);
+        }
+
+        refresh(0, 0, width - 1, height - 1);
+    }
+
+    inline void HeightmapPyramid::refresh(std::size_t x0, std::size_t z0, std::size_t x1, std::size_t z1) noexcept
+    {
+        /// Level 0 - the range of the four corners of each cell
+        for(std::size_t z = z0; z < z1; ++z)
+        {
+            for(std::size_t x = x0; x < x1; ++x)
+            {
+                const uint8_t corners[4] =
+                {
+                    samples[z * width + x],
+                    samples[z * width + x + 1],
+                    samples[(z + 1) * width + x],
+                    samples[(z + 1) * width + x + 1]
+                };
+                levels[0][z * (width - 1) + x] = Range{*std::min_element(corners, corners + 4), *std::max_element(corners, corners + 4)};
+            }
+        }
+
+        /// Every other level - the range of each 2x2 block of the level below
+        for(std::size_t level = 1; level < levels.size(); ++level)
+        {
+            const std::size_t below = level - 1;
+            x0 /= 2;
+            z0 /= 2;
+            x1 = (x1 + 1) / 2;
+            z1 = (z1 + 1) / 2;
+            for(std::size_t z = z0; z < z1; ++z)
+            {
+                for(std::size_t x = x0; x < x1; ++x)
+                {
+                    Range range{UINT8_MAX, 0};
+                    for(std::size_t childZ = z * 2; childZ < std::min(z * 2 + 2, levelHeights[below]); ++childZ)
+                    {
+                        for(std::size_t childX = x * 2; childX < std::min(x * 2 + 2, levelWidths[below]); ++childX)
+                        {
+                            const Range& child = levels[below][childZ * levelWidths[below] + childX];
+                            range.minimum = std::min(range.minimum, child.minimum);
+                            range.maximum = std::max(range.maximum, child.maximum);
+                        }
+                    }
+                    levels[level][z * levelWidths[level] + x] = range;
+                }
+            }
+        }
+    }
+
+    inline void HeightmapPyramid::update(const Heightmap& heightmap, const Heightmap::Region& region)
+    {
+        if(heightmap.getWidth() != width || heightmap.getHeight() != height)
+        {
+            throw IllegalArgumentException("The dimensions of a heightmap may not change after its hierarchy is built");
+        }
+        const std::size_t x1 = std::min(region.x1, width);
+        const std::size_t z1 = std::min(region.y1, height);
+        if(region.x0 >= x1 || region.y0 >= z1)
+        {
+            return;
+        }
+
+        for(std::size_t z = region.y0; z < z1; ++z)
+        {
+            for(std::size_t x = region.x0; x < x1; ++x)
+            {
+                samples[z * width + x] = heightmap.getSample(x, z);
+            }
+        }
+
+        /// Every cell that has one of the modified samples as a corner
+        refresh(region.x0 > 0 ? region.x0 - 1 : 0, region.y0 > 0 ? region.y0 - 1 : 0, std::min(x1, width - 1), std::min(z1, height - 1));
+    }
+
+    template<typename T>
+    bool HeightmapPyramid::clip(const Node& node, const T origin[3], const T inverse[3], T& near, T& far) const noexcept
+    {
+        const Range& range = levels[node.level][node.z * levelWidths[node.level] + node.x];
+        const T lower[3] =
+        {
+            static_cast<T>(node.x << node.level),
+            static_cast<T>(range.minimum),
+            static_cast<T>(node.z << node.level)
+        };
+        const T upper[3] =
+        {
+            static_cast<T>(std::min((node.x + 1) << node.level, width - 1)),
+            static_cast<T>(range.maximum),
+            static_cast<T>(std::min((node.z + 1) << node.level, height - 1))
+        };
+        for(std::size_t i = 0; i < 3; ++i)
+        {
+            /// The ray runs parallel to this slab
+            if(std::isinf(inverse[i]))
+            {
+                if(origin[i] < lower[i] || origin[i] > upper[i])
+                {
+                    return false;
+                }
+                continue;
+            }
+            T t0 = (lower[i] - origin[i]) * inverse[i];
+            T t1 = (upper[i] - origin[i]) * inverse[i];
+            if(t0 > t1)
+            {
+                std::swap(t0, t1);
+            }
+            near = std::max(near, t0);
+            far = std::min(far, t1);
+        }
+        return near <= far;
+    }
+
+    template<typename T>
+    bool HeightmapPyramid::intersectCell(std::size_t x, std::size_t z, const T origin[3], const T direction[3], T limit, Hit<T>& hit) const noexcept
+    {
+        const T x0 = static_cast<T>(x);
+        const T z0 = static_cast<T>(z);
+        const T vertices[4][3] =
+        {
+            {x0, static_cast<T>(samples[z * width + x]), z0},
+            {x0, static_cast<T>(samples[(z + 1) * width + x]), z0 + 1},
+            {x0 + 1, static_cast<T>(samples[z * width + x + 1]), z0},
+            {x0 + 1, static_cast<T>(samples[(z + 1) * width + x + 1]), z0 + 1}
+        };
+
+        /// The same triangulation as Terrain
+        const std::size_t triangles[2][3] = {{0, 1, 2}, {2, 1, 3}};
+
+        const std::size_t* nearest = nullptr;
+        T best = limit;
+        for(const auto& triangle : triangles)
+        {
+            T distance;
+            if(detail::intersectTriangle(origin, direction, vertices[triangle[0]], vertices[triangle[1]], vertices[triangle[2]], distance) &&
+                distance >= 0 && distance <= best)
+            {
+                best = distance;
+                nearest = triangle;
+            }
+        }
+        if(nearest == nullptr)
+        {
+            return false;
+        }
+
+        const T* a = vertices[nearest[0]];
+        const T* b = vertices[nearest[1]];
+        const T* c = vertices[nearest[2]];
+        Vector<T, 3> normal = cross(Vector<T, 3>(b[0] - a[0], b[1] - a[1], b[2] - a[2]), Vector<T, 3>(c[0] - a[0], c[1] - a[1], c[2] - a[2]));
+        if(normal[1] < 0)
+        {
+            normal = -normal;
+        }
+        hit.distance = best;
+        hit.point = Point<T, 3>(origin[0] + direction[0] * best, origin[1] + direction[1] * best, origin[2] + direction[2] * best);
+        hit.normal = normal.normalize();
+        return true;
+    }
+
+    template<typename T>
+    bool HeightmapPyramid::intersect(const Line<T, 3>& ray, Hit<T>& hit, T limit) const noexcept
+    {
+        const T origin[3] = {ray.getPoint()[0], ray.getPoint()[1], ray.getPoint()[2]};
+        const T direction[3] = {ray.getVector()[0], ray.getVector()[1], ray.getVector()[2]};
+        const T inverse[3] =
+        {
+            static_cast<T>(1) / direction[0],
+            static_cast<T>(1) / direction[1],
+            static_cast<T>(1) / direction[2]
+        };
+
+        Node root{levels.size() - 1, 0, 0};
+        T near = 0;
+        T far = limit;
+        if(!clip(root, origin, inverse, near, far))
+        {
+            return false;
+        }
+
+        /// Each level pushes at most three siblings that are visited after the nearest one
+        std::vector<Node> stack;
+        stack.reserve(3 * levels.size() + 1);
+        stack.push_back(root);
+        while(!stack.empty())
+        {
+            const Node node = stack.back();
+            stack.pop_back();
+
+            if(node.level == 0)
+            {
+                /// Children are visited front-to-back, so the first cell hit is the nearest one
+                if(intersectCell(node.x, node.z, origin, direction, limit, hit))
+                {
+                    return true;
+                }
+                continue;
+            }
+
+            const std::size_t level = node.level - 1;
+            Node children[4];
+            T entries[4];
+            std::size_t count = 0;
+            for(std::size_t z = node.z * 2; z < std::min(node.z * 2 + 2, levelHeights[level]); ++z)
+            {
+                for(std::size_t x = node.x * 2; x < std::min(node.x * 2 + 2, levelWidths[level]); ++x)
+                {
+                    Node child{level, x, z};
+                    T childNear = 0;
+                    T childFar = limit;
+                    if(clip(child, origin, inverse, childNear, childFar))
+                    {
+                        /// Insertion sort by descending entry distance, so that the nearest child is pushed last
+                        std::size_t i = count++;
+                        for(; i > 0 && entries[i - 1] < childNear; --i)
+                        {
+                            children[i] = children[i - 1];
+                            entries[i] = entries[i - 1];
+                        }
+                        children[i] = child;
+                        entries[i] = childNear;
+                    }
+                }
+            }
+            stack.insert(stack.end(), children, children + count);
+        }
+        return false;
+    }
+
+    inline std::size_t HeightmapPyramid::getLevelCount() const noexcept
+    {
+        return levels.size();
+    }
+
+    inline uint8_t HeightmapPyramid::getMinimum(std::size_t level, std::size_t x, std::size_t z) const noexcept
+    {
+        return levels[level][z * levelWidths[level] + x].minimum;
+    }
+
+    inline uint8_t HeightmapPyramid::getMaximum(std::size_t level, std::size_t x, std::size_t z) const noexcept
+    {
+        return levels[level][z * levelWidths[level] + x].maximum;
+    }
+}
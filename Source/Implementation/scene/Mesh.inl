@@ -1,3 +1,5 @@
+#include <cmath>
+
 namespace midnight
 {
     
@@ -5,27 +7,138 @@ namespace midnight
         vertices(vertices), materials(materials), meshes(renderables)
     {
         
+    }
+    
+    inline Mesh::Mesh(std::vector<Vertex32F>&& vertices, std::vector<midnight::Material>&& materials, std::vector<midnight::Mesh::Renderable>&& renderables) : 
+        vertices(std::move(vertices)), materials(std::move(materials)), meshes(std::move(renderables))
+    {
+        
     }
 
+    inline std::vector<float> Mesh::getInterleavedVertices() const
+    {
+        std::vector<float> data;
+        data.reserve(vertices.size() * INTERLEAVED_SIZE);
+        for(const Vertex32F& vertex : vertices)
+        {
+            const Point3F& position = vertex.getPosition();
+            const Vector3F& normal = vertex.getNormal();
+            const Point2F& texCoord = vertex.getTexCoord();
+            data.insert(data.end(), {position[0], position[1], position[2], normal[0], normal[1], normal[2], texCoord[0], texCoord[1]});
+        }
+        return data;
+    }
 
+    inline void Mesh::optimize(float overdrawThreshold)
+    {
+        for(Renderable& renderable : meshes)
+        {
+            optimizeVertexCache(renderable.indices, vertices.size());
+            optimizeOverdraw(renderable.indices, vertices, overdrawThreshold);
+            renderable.meshlets.clear();
+        }
 
-    inline std::ostream& operator<<(std::ostream& stream, const Mesh& /*mesh*/)
+        /// Number the vertices in the order in which they are first referenced
+        constexpr std::size_t UNUSED = static_cast<std::size_t>(-1);
+        std::vector<std::size_t> remap(vertices.size(), UNUSED);
+        std::vector<Vertex32F> reordered;
+        reordered.reserve(vertices.size());
+        for(Renderable& renderable : meshes)
+        {
+            for(std::size_t& index : renderable.indices)
+            {
+                if(remap[index] == UNUSED)
+                {
+                    remap[index] = reordered.size();
+                    reordered.push_back(vertices[index]);
+                }
+                index = remap[index];
+            }
+        }
+        for(std::size_t vertex = 0; vertex < vertices.size(); ++vertex)
+        {
+            if(remap[vertex] == UNUSED)
+            {
+                reordered.push_back(vertices[vertex]);
+            }
+        }
+        vertices = std::move(reordered);
+    }
+
+    inline std::size_t Mesh::weld(float epsilon, std::size_t threadCount)
     {
-        // TODO: implement after finalizing class
-        return stream;
+        std::vector<std::size_t> remap;
+        const std::size_t unique = weldVertices(vertices, remap, epsilon, threadCount);
+        if(unique == vertices.size())
+        {
+            return unique;
+        }
+
+        /// Unique vertices are numbered by first occurrence, so they can be compacted in place
+        std::size_t next = 0;
+        for(std::size_t vertex = 0; vertex < vertices.size(); ++vertex)
+        {
+            if(remap[vertex] == next)
+            {
+                vertices[next++] = vertices[vertex];
+            }
+        }
+        vertices.erase(vertices.begin() + unique, vertices.end());
+
+        for(Renderable& renderable : meshes)
+        {
+            for(std::size_t& index : renderable.indices)
+            {
+                index = remap[index];
+            }
+        }
+        return unique;
     }
 
+    inline void Mesh::buildMeshlets(std::size_t maxTriangles, std::size_t maxVertices)
+    {
+        for(Renderable& renderable : meshes)
+        {
+            renderable.meshlets = midnight::buildMeshlets(renderable.indices, vertices, maxTriangles, maxVertices);
+        }
+    }
 
-    inline std::ostream& operator<<(std::ostream& stream, Mesh&& /*mesh*/)
+    inline bool Mesh::hasValidNormals() const noexcept
     {
-        // TODO: implement after finalizing class
-        return stream;
+        for(const Vertex32F& vertex : vertices)
+        {
+            const Vector3F& normal = vertex.getNormal();
+            const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            if(!(std::abs(length - 1.0f) < 1e-2f))
+            {
+                return false;
+            }
+        }
+        return true;
     }
 
+    inline void Mesh::recomputeNormals(NormalWeighting weighting, std::size_t threadCount)
+    {
+        std::vector<std::size_t> indices;
+        for(const Renderable& renderable : meshes)
+        {
+            indices.insert(indices.end(), renderable.indices.begin(), renderable.indices.end());
+        }
+
+        const std::vector<float> normals = computeVertexNormals(vertices, indices, weighting, threadCount);
+        for(std::size_t v = 0; v < vertices.size(); ++v)
+        {
+            vertices[v].setNormal(Vector3F(normals[v * 3], normals[v * 3 + 1], normals[v * 3 + 2]));
+        }
+    }
 
-    inline std::istream& operator>>(std::istream& stream, Mesh& /*mesh*/)
+    inline std::vector<float> Mesh::computeTangents(std::size_t threadCount) const
     {
-        // TODO: implement after finalizing class
-        return stream;
+        std::vector<std::size_t> indices;
+        for(const Renderable& renderable : meshes)
+        {
+            indices.insert(indices.end(), renderable.indices.begin(), renderable.indices.end());
+        }
+        return computeVertexTangents(vertices, indices, threadCount);
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#include "IllegalArgumentException.hpp"
+#include "ResourceException.hpp"
+
+namespace midnight
+{
+    namespace detail
+    {
+        /**
+         * Rounds the provided offset up to the next multiple of MeshCache::ALIGNMENT
+         *
+         */
+        inline uint64_t alignMeshCacheOffset(uint64_t offset) noexcept
+        {
+            const uint64_t alignment = MeshCache::ALIGNMENT;
+            return (offset + alignment - 1) / alignment * alignment;
+        }
+
+        inline void writeMeshCache(std::ostream& stream, const Mesh& mesh, uint64_t sourceSize, int64_t sourceModified)
+        {
+            const std::vector<Vertex32F>& vertices = mesh.getVertices();
+            const std::vector<Material>& materials = mesh.getMaterials();
+            const std::vector<Mesh::Renderable>& meshes = mesh.getMeshes();
+            if(vertices.size() > std::numeric_limits<uint32_t>::max())
+            {
+                throw IllegalArgumentException("A mesh cache can not address more than 2^32 vertices");
+            }
+
+            /// Lay out the sections
+            MeshCacheHeader header;
+            std::memset(&header, 0, sizeof(header));
+            std::memcpy(header.magic, MeshCache::MAGIC, sizeof(header.magic));
+            header.version = MeshCache::VERSION;
+            header.byteOrder = MeshCache::BYTE_ORDER_MARK;
+            header.sourceSize = sourceSize;
+            header.sourceModified = sourceModified;
+            header.vertexCount = vertices.size();
+            header.vertexOffset = alignMeshCacheOffset(sizeof(MeshCacheHeader));
+            header.materialCount = materials.size();
+            header.materialOffset = alignMeshCacheOffset(header.vertexOffset + vertices.size() * Mesh::INTERLEAVED_SIZE * sizeof(float));
+            header.renderableCount = meshes.size();
+            header.renderableOffset = alignMeshCacheOffset(header.materialOffset + materials.size() * sizeof(MeshCacheMaterial));
+
+            std::vector<MeshCacheRenderable> renderables;
+            uint64_t offset = alignMeshCacheOffset(header.renderableOffset + meshes.size() * sizeof(MeshCacheRenderable));
+            for(const Mesh::Renderable& renderable : meshes)
+            {
+                renderables.push_back(MeshCacheRenderable{renderable.materialIndex, renderable.indices.size(), offset});
+                offset = alignMeshCacheOffset(offset + renderable.indices.size() * sizeof(uint32_t));
+            }
+            header.fileSize = offset;
+
+            /// Emit them, padding between each
+            uint64_t position = 0;
+            auto emit = [&stream, &position](const void* data, uint64_t size, uint64_t at)
+            {
+                static const char PADDING[MeshCache::ALIGNMENT] = {};
+                while(position < at)
+                {
+                    const uint64_t padding = std::min<uint64_t>(at - position, sizeof(PADDING));
+                    stream.write(PADDING, static_cast<std::streamsize>(padding));
+                    position += padding;
+                }
+                stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+                position += size;
+            };
+
+            emit(&header, sizeof(header), 0);
+
+            const std::vector<float> interleaved = mesh.getInterleavedVertices();
+            emit(interleaved.data(), interleaved.size() * sizeof(float), header.vertexOffset);
+
+            std::vector<MeshCacheMaterial> records;
+            for(const Material& material : materials)
+            {
+                MeshCacheMaterial record;
+                std::memset(&record, 0, sizeof(record));
+                record.lightingMode = static_cast<uint32_t>(material.getLightingMode());
+                record.cullingMode = static_cast<uint32_t>(material.getCullingMode());
+                record.autoNormalize = material.autoNormalizes() ? 1 : 0;
+                for(std::size_t i = 0; i < 4; ++i)
+                {
+                    record.ambience[i] = material.getAmbience()[i];
+                    record.diffusion[i] = material.getDiffusion()[i];
+                    record.emission[i] = material.getEmission()[i];
+                    record.specularity[i] = material.getSpecularity()[i];
+                }
+                records.push_back(record);
+            }
+            emit(records.data(), records.size() * sizeof(MeshCacheMaterial), header.materialOffset);
+            emit(renderables.data(), renderables.size() * sizeof(MeshCacheRenderable), header.renderableOffset);
+
+            for(std::size_t i = 0; i < meshes.size(); ++i)
+            {
+                const std::vector<uint32_t> indices(meshes[i].indices.begin(), meshes[i].indices.end());
+                emit(indices.data(), indices.size() * sizeof(uint32_t), renderables[i].indexOffset);
+            }
+            emit(nullptr, 0, header.fileSize);
+        }
+    }
+
+    inline MeshCache::MeshCache(const std::string& path) :
+        file(new internal::MappedFile(path)),
+        base(nullptr),
+        header(nullptr),
+        vertices(nullptr),
+        materials(nullptr),
+        renderables(nullptr)
+    {
+        attach(file->getData(), file->getSize(), path);
+    }
+
+    inline MeshCache::MeshCache(std::istream& stream) :
+        base(nullptr),
+        header(nullptr),
+        vertices(nullptr),
+        materials(nullptr),
+        renderables(nullptr)
+    {
+        std::vector<char> contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        buffer.resize((contents.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        std::memcpy(buffer.data(), contents.data(), contents.size());
+        attach(buffer.data(), contents.size(), "The stream");
+    }
+
+    inline void MeshCache::attach(const void* data, uint64_t size, const std::string& name)
+    {
+        base = static_cast<const char*>(data);
+        header = static_cast<const detail::MeshCacheHeader*>(data);
+        if(size < sizeof(detail::MeshCacheHeader) ||
+            std::memcmp(header->magic, MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != VERSION ||
+            header->byteOrder != BYTE_ORDER_MARK ||
+            header->fileSize != size)
+        {
+            throw ResourceException(name + " is not a compatible mesh cache");
+        }
+
+        /// Every section must lie within the cache
+        auto within = [size](uint64_t offset, uint64_t count, uint64_t elementSize)
+        {
+            return offset <= size && count <= (size - offset) / elementSize && offset % ALIGNMENT == 0;
+        };
+        if(!within(header->vertexOffset, header->vertexCount, Mesh::INTERLEAVED_SIZE * sizeof(float)) ||
+            !within(header->materialOffset, header->materialCount, sizeof(detail::MeshCacheMaterial)) ||
+            !within(header->renderableOffset, header->renderableCount, sizeof(detail::MeshCacheRenderable)))
+        {
+            throw ResourceException(name + " is a corrupt mesh cache");
+        }
+
+        vertices = reinterpret_cast<const float*>(base + header->vertexOffset);
+        materials = reinterpret_cast<const detail::MeshCacheMaterial*>(base + header->materialOffset);
+        renderables = reinterpret_cast<const detail::MeshCacheRenderable*>(base + header->renderableOffset);
+
+        for(std::size_t i = 0; i < header->renderableCount; ++i)
+        {
+            if(!within(renderables[i].indexOffset, renderables[i].indexCount, sizeof(uint32_t)))
+            {
+                throw ResourceException(name + " is a corrupt mesh cache");
+            }
+        }
+    }
+
+    inline bool MeshCache::isCurrent(const std::string& path, const std::string& source) noexcept
+    {
+        uint64_t sourceSize;
+        int64_t sourceModified;
+        if(!internal::getFileStatus(source, sourceSize, sourceModified))
+        {
+            return false;
+        }
+
+        std::ifstream stream(path, std::ios::binary);
+        detail::MeshCacheHeader header;
+        if(!stream.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        {
+            return false;
+        }
+        return std::memcmp(header.magic, MAGIC, sizeof(header.magic)) == 0 &&
+            header.version == VERSION &&
+            header.byteOrder == BYTE_ORDER_MARK &&
+            header.sourceSize == sourceSize &&
+            header.sourceModified == sourceModified;
+    }
+
+    inline void MeshCache::write(const std::string& path, const Mesh& mesh, const std::string& source)
+    {
+        uint64_t sourceSize = 0;
+        int64_t sourceModified = 0;
+        if(!source.empty() && !internal::getFileStatus(source, sourceSize, sourceModified))
+        {
+            throw ResourceException("Unable to stat " + source);
+        }
+
+        const std::string temporary = path + ".tmp";
+        {
+            std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+            detail::writeMeshCache(stream, mesh, sourceSize, sourceModified);
+            if(!stream.flush())
+            {
+                std::remove(temporary.c_str());
+                throw ResourceException("Unable to write " + temporary);
+            }
+        }
+        if(std::rename(temporary.c_str(), path.c_str()) != 0)
+        {
+            std::remove(temporary.c_str());
+            throw ResourceException("Unable to rename " + temporary + " to " + path);
+        }
+    }
+
+    inline std::size_t MeshCache::getVertexCount() const noexcept
+    {
+        return static_cast<std::size_t>(header->vertexCount);
+    }
+
+    inline const float* MeshCache::getInterleavedVertices() const noexcept
+    {
+        return vertices;
+    }
+
+    inline std::size_t MeshCache::getRenderableCount() const noexcept
+    {
+        return static_cast<std::size_t>(header->renderableCount);
+    }
+
+    inline std::size_t MeshCache::getMaterialIndex(std::size_t renderable) const noexcept
+    {
+        return static_cast<std::size_t>(renderables[renderable].materialIndex);
+    }
+
+    inline std::size_t MeshCache::getIndexCount(std::size_t renderable) const noexcept
+    {
+        return static_cast<std::size_t>(renderables[renderable].indexCount);
+    }
+
+    inline const uint32_t* MeshCache::getIndices(std::size_t renderable) const noexcept
+    {
+        return reinterpret_cast<const uint32_t*>(base + renderables[renderable].indexOffset);
+    }
+
+    inline std::vector<std::pair<const uint32_t*, std::size_t>> MeshCache::getIndexLists() const
+    {
+        std::vector<std::pair<const uint32_t*, std::size_t>> lists;
+        lists.reserve(getRenderableCount());
+        for(std::size_t i = 0; i < getRenderableCount(); ++i)
+        {
+            lists.emplace_back(getIndices(i), getIndexCount(i));
+        }
+        return lists;
+    }
+
+    inline Mesh MeshCache::toMesh() const
+    {
+        std::vector<Vertex32F> meshVertices;
+        meshVertices.reserve(getVertexCount());
+        for(std::size_t i = 0; i < getVertexCount(); ++i)
+        {
+            const float* vertex = vertices + i * Mesh::INTERLEAVED_SIZE;
+            meshVertices.emplace_back(Point3F(vertex[0], vertex[1], vertex[2]), Vector3F(vertex[3], vertex[4], vertex[5]), Point2F(vertex[6], vertex[7]));
+        }
+
+        std::vector<Material> meshMaterials;
+        for(std::size_t i = 0; i < header->materialCount; ++i)
+        {
+            const detail::MeshCacheMaterial& record = materials[i];
+            meshMaterials.emplace_back(
+                static_cast<LightingMode>(record.lightingMode),
+                static_cast<CullingMode>(record.cullingMode),
+                record.autoNormalize != 0,
+                Color<float, 4>(record.ambience[0], record.ambience[1], record.ambience[2], record.ambience[3]),
+                Color<float, 4>(record.diffusion[0], record.diffusion[1], record.diffusion[2], record.diffusion[3]),
+                Color<float, 4>(record.emission[0], record.emission[1], record.emission[2], record.emission[3]),
+                Color<float, 4>(record.specularity[0], record.specularity[1], record.specularity[2], record.specularity[3]));
+        }
+
+        std::vector<Mesh::Renderable> meshRenderables;
+        for(std::size_t i = 0; i < getRenderableCount(); ++i)
+        {
+            meshRenderables.emplace_back(getMaterialIndex(i));
+            meshRenderables.back().indices.assign(getIndices(i), getIndices(i) + getIndexCount(i));
+        }
+        return Mesh(std::move(meshVertices), std::move(meshMaterials), std::move(meshRenderables));
+    }
+
+    inline std::ostream& operator<<(std::ostream& stream, const Mesh& mesh)
+    {
+        detail::writeMeshCache(stream, mesh, 0, 0);
+        return stream;
+    }
+
+    inline std::ostream& operator<<(std::ostream& stream, Mesh&& mesh)
+    {
+        detail::writeMeshCache(stream, mesh, 0, 0);
+        return stream;
+    }
+
+    inline std::istream& operator>>(std::istream& stream, Mesh& mesh)
+    {
+        try
+        {
+            mesh = MeshCache(stream).toMesh();
+        }
+        catch(const ResourceException&)
+        {
+            stream.setstate(std::ios::failbit);
+        }
+        return stream;
+    }
+}
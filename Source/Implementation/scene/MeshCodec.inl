@@ -0,0 +1,327 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+#include "IllegalArgumentException.hpp"
+#include "ResourceException.hpp"
+
+namespace midnight
+{
+    namespace detail
+    {
+        /// The number of values in a block of an encoded stream
+        constexpr std::size_t CODEC_BLOCK_SIZE = 16;
+
+        /**
+         * Describes one attribute column of an encoded vertex stream
+         *
+         */
+        struct MeshCodecColumn
+        {
+            /// The bits that the column is quantized to, or 0 if it holds the bit patterns of its floats
+            uint32_t bits;
+
+            /// The value of a quantized 0
+            float offset;
+
+            /// The difference between consecutive quantized values
+            float scale;
+        };
+
+        /**
+         * Appends the provided values to the provided stream as zig-zag encoded differences, in byte-plane blocks.
+         *
+         * Each block is a mask of the planes that are present followed by those planes, 16 bytes each, so that
+         * byte p of every value in the block is held together.  The final block is padded with zero differences.
+         *
+         */
+        inline void encodeDeltaBlocks(const uint32_t* values, std::size_t count, std::vector<uint8_t>& stream)
+        {
+            uint32_t previous = 0;
+            for(std::size_t first = 0; first < count; first += CODEC_BLOCK_SIZE)
+            {
+                uint32_t encoded[CODEC_BLOCK_SIZE] = {};
+                uint32_t planes = 0;
+                for(std::size_t i = 0; i < CODEC_BLOCK_SIZE && first + i < count; ++i)
+                {
+                    const uint32_t delta = values[first + i] - previous;
+                    previous = values[first + i];
+                    encoded[i] = (delta << 1) ^ (0 - (delta >> 31));
+                    planes |= encoded[i];
+                }
+
+                uint8_t mask = 0;
+                for(uint32_t plane = 0; plane < 4; ++plane)
+                {
+                    mask |= ((planes >> (plane * 8)) & 0xFF) != 0 ? 1 << plane : 0;
+                }
+                stream.push_back(mask);
+                for(uint32_t plane = 0; plane < 4; ++plane)
+                {
+                    if((mask & (1 << plane)) != 0)
+                    {
+                        for(std::size_t i = 0; i < CODEC_BLOCK_SIZE; ++i)
+                        {
+                            stream.push_back(static_cast<uint8_t>(encoded[i] >> (plane * 8)));
+                        }
+                    }
+                }
+            }
+        }
+
+        /**
+         * Decodes the planes of one block written by encodeDeltaBlocks one value at a time.  This is the path taken
+         * without SSE2, and is the reference that the SSE2 path must match.
+         *
+         * @param mask the mask of the planes that are present, which must be followed by them at data
+         *
+         * @return the first byte after the planes
+         *
+         */
+        inline const uint8_t* decodeDeltaPlanesScalar(uint8_t mask, const uint8_t* data, uint32_t& previous,
+            uint32_t (&values)[CODEC_BLOCK_SIZE]) noexcept
+        {
+            uint32_t encoded[CODEC_BLOCK_SIZE] = {};
+            for(uint32_t plane = 0; plane < 4; ++plane)
+            {
+                if((mask & (1 << plane)) != 0)
+                {
+                    for(std::size_t i = 0; i < CODEC_BLOCK_SIZE; ++i)
+                    {
+                        encoded[i] |= static_cast<uint32_t>(data[i]) << (plane * 8);
+                    }
+                    data += CODEC_BLOCK_SIZE;
+                }
+            }
+            for(std::size_t i = 0; i < CODEC_BLOCK_SIZE; ++i)
+            {
+                previous += (encoded[i] >> 1) ^ (0 - (encoded[i] & 1));
+                values[i] = previous;
+            }
+            return data;
+        }
+
+#if defined(__SSE2__)
+        /**
+         * Decodes the planes of one block written by encodeDeltaBlocks four values at a time, as
+         * decodeDeltaPlanesScalar would
+         *
+         */
+        inline const uint8_t* decodeDeltaPlanesSSE2(uint8_t mask, const uint8_t* data, uint32_t& previous,
+            uint32_t (&values)[CODEC_BLOCK_SIZE]) noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+            __m128i lanes[4] = {zero, zero, zero, zero};
+            for(int plane = 0; plane < 4; ++plane)
+            {
+                if((mask & (1 << plane)) == 0)
+                {
+                    continue;
+                }
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+                data += CODEC_BLOCK_SIZE;
+                const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+                const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+                const __m128i shift = _mm_cvtsi32_si128(plane * 8);
+                lanes[0] = _mm_or_si128(lanes[0], _mm_sll_epi32(_mm_unpacklo_epi16(low, zero), shift));
+                lanes[1] = _mm_or_si128(lanes[1], _mm_sll_epi32(_mm_unpackhi_epi16(low, zero), shift));
+                lanes[2] = _mm_or_si128(lanes[2], _mm_sll_epi32(_mm_unpacklo_epi16(high, zero), shift));
+                lanes[3] = _mm_or_si128(lanes[3], _mm_sll_epi32(_mm_unpackhi_epi16(high, zero), shift));
+            }
+
+            /// Undo the zig-zag encoding, then sum the differences four at a time
+            const __m128i one = _mm_set1_epi32(1);
+            __m128i running = _mm_set1_epi32(static_cast<int>(previous));
+            for(int i = 0; i < 4; ++i)
+            {
+                __m128i delta = _mm_xor_si128(_mm_srli_epi32(lanes[i], 1), _mm_sub_epi32(zero, _mm_and_si128(lanes[i], one)));
+                delta = _mm_add_epi32(delta, _mm_slli_si128(delta, 4));
+                delta = _mm_add_epi32(delta, _mm_slli_si128(delta, 8));
+                running = _mm_add_epi32(running, delta);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i * 4), running);
+                running = _mm_shuffle_epi32(running, 0xFF);
+            }
+            previous = values[CODEC_BLOCK_SIZE - 1];
+            return data;
+        }
+#endif
+
+        /**
+         * Decodes one block written by encodeDeltaBlocks
+         *
+         * @return the first byte after the block, or nullptr if the block does not fit before end
+         *
+         */
+        inline const uint8_t* decodeDeltaBlock(const uint8_t* data, const uint8_t* end, uint32_t& previous,
+            uint32_t (&values)[CODEC_BLOCK_SIZE]) noexcept
+        {
+            if(data == end)
+            {
+                return nullptr;
+            }
+            const uint8_t mask = *data++;
+            const std::size_t planeCount = (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1);
+            if(mask > 0xF || static_cast<std::size_t>(end - data) < planeCount * CODEC_BLOCK_SIZE)
+            {
+                return nullptr;
+            }
+#if defined(__SSE2__)
+            return decodeDeltaPlanesSSE2(mask, data, previous, values);
+#else
+            return decodeDeltaPlanesScalar(mask, data, previous, values);
+#endif
+        }
+
+        /**
+         * Encodes one attribute column of the provided interleaved vertices
+         *
+         */
+        inline void encodeColumn(const float* interleaved, std::size_t vertexCount, std::size_t column, unsigned bits,
+            std::vector<uint8_t>& stream)
+        {
+            if(bits > 24)
+            {
+                throw IllegalArgumentException("A vertex attribute can not be quantized to more than 24 bits");
+            }
+
+            MeshCodecColumn descriptor;
+            std::memset(&descriptor, 0, sizeof(descriptor));
+            descriptor.bits = bits;
+            std::vector<uint32_t> values(vertexCount);
+            if(bits == 0)
+            {
+                for(std::size_t i = 0; i < vertexCount; ++i)
+                {
+                    std::memcpy(&values[i], &interleaved[i * Mesh::INTERLEAVED_SIZE + column], sizeof(uint32_t));
+                }
+            }
+            else
+            {
+                float minimum = std::numeric_limits<float>::max();
+                float maximum = std::numeric_limits<float>::lowest();
+                for(std::size_t i = 0; i < vertexCount; ++i)
+                {
+                    const float value = interleaved[i * Mesh::INTERLEAVED_SIZE + column];
+                    if(!std::isfinite(value))
+                    {
+                        throw IllegalArgumentException("A quantized vertex attribute must be finite");
+                    }
+                    minimum = std::min(minimum, value);
+                    maximum = std::max(maximum, value);
+                }
+                const float steps = static_cast<float>((1u << bits) - 1);
+                descriptor.offset = vertexCount != 0 ? minimum : 0.0f;
+                descriptor.scale = maximum > minimum ? (maximum - minimum) / steps : 0.0f;
+                for(std::size_t i = 0; i < vertexCount; ++i)
+                {
+                    const float value = interleaved[i * Mesh::INTERLEAVED_SIZE + column];
+                    const float quantized = descriptor.scale > 0.0f ? std::round((value - minimum) / descriptor.scale) : 0.0f;
+                    values[i] = static_cast<uint32_t>(std::min(quantized, steps));
+                }
+            }
+
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&descriptor);
+            stream.insert(stream.end(), bytes, bytes + sizeof(descriptor));
+            encodeDeltaBlocks(values.data(), vertexCount, stream);
+        }
+    }
+
+    inline std::vector<uint8_t> encodeIndices(const uint32_t* indices, std::size_t count)
+    {
+        std::vector<uint8_t> stream;
+        stream.reserve(count + count / detail::CODEC_BLOCK_SIZE + 1);
+        detail::encodeDeltaBlocks(indices, count, stream);
+        return stream;
+    }
+
+    inline std::size_t decodeIndices(const uint8_t* data, std::size_t size, uint32_t* indices, std::size_t count)
+    {
+        const uint8_t* position = data;
+        const uint8_t* end = data + size;
+        uint32_t previous = 0;
+        uint32_t values[detail::CODEC_BLOCK_SIZE];
+        for(std::size_t first = 0; first < count; first += detail::CODEC_BLOCK_SIZE)
+        {
+            position = detail::decodeDeltaBlock(position, end, previous, values);
+            if(position == nullptr)
+            {
+                throw ResourceException("The encoded indices are truncated or corrupt");
+            }
+            const std::size_t length = std::min(count - first, detail::CODEC_BLOCK_SIZE);
+            std::memcpy(indices + first, values, length * sizeof(uint32_t));
+        }
+        return static_cast<std::size_t>(position - data);
+    }
+
+    inline std::vector<uint8_t> encodeVertices(const float* interleaved, std::size_t vertexCount, const VertexQuantization& quantization)
+    {
+        const unsigned bits[Mesh::INTERLEAVED_SIZE] =
+        {
+            quantization.positionBits, quantization.positionBits, quantization.positionBits,
+            quantization.normalBits, quantization.normalBits, quantization.normalBits,
+            quantization.textureBits, quantization.textureBits
+        };
+
+        std::vector<uint8_t> stream;
+        stream.reserve(vertexCount * Mesh::INTERLEAVED_SIZE * sizeof(float));
+        for(std::size_t column = 0; column < Mesh::INTERLEAVED_SIZE; ++column)
+        {
+            detail::encodeColumn(interleaved, vertexCount, column, bits[column], stream);
+        }
+        return stream;
+    }
+
+    inline std::size_t decodeVertices(const uint8_t* data, std::size_t size, float* interleaved, std::size_t vertexCount)
+    {
+        const uint8_t* position = data;
+        const uint8_t* end = data + size;
+        uint32_t values[detail::CODEC_BLOCK_SIZE];
+        for(std::size_t column = 0; column < Mesh::INTERLEAVED_SIZE; ++column)
+        {
+            detail::MeshCodecColumn descriptor;
+            if(static_cast<std::size_t>(end - position) < sizeof(descriptor))
+            {
+                throw ResourceException("The encoded vertices are truncated or corrupt");
+            }
+            std::memcpy(&descriptor, position, sizeof(descriptor));
+            position += sizeof(descriptor);
+            if(descriptor.bits > 24)
+            {
+                throw ResourceException("The encoded vertices are truncated or corrupt");
+            }
+
+            uint32_t previous = 0;
+            for(std::size_t first = 0; first < vertexCount; first += detail::CODEC_BLOCK_SIZE)
+            {
+                position = detail::decodeDeltaBlock(position, end, previous, values);
+                if(position == nullptr)
+                {
+                    throw ResourceException("The encoded vertices are truncated or corrupt");
+                }
+
+                const std::size_t length = std::min(vertexCount - first, detail::CODEC_BLOCK_SIZE);
+                float* output = interleaved + first * Mesh::INTERLEAVED_SIZE + column;
+                if(descriptor.bits == 0)
+                {
+                    for(std::size_t i = 0; i < length; ++i)
+                    {
+                        std::memcpy(output + i * Mesh::INTERLEAVED_SIZE, &values[i], sizeof(float));
+                    }
+                }
+                else
+                {
+                    for(std::size_t i = 0; i < length; ++i)
+                    {
+                        output[i * Mesh::INTERLEAVED_SIZE] = descriptor.offset + static_cast<float>(values[i]) * descriptor.scale;
+                    }
+                }
+            }
+        }
+        return static_cast<std::size_t>(position - data);
+    }
+}
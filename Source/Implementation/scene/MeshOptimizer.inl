@@ -0,0 +1,759 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <thread>
+
+#include "IllegalArgumentException.hpp"
+
+namespace midnight
+{
+    namespace detail
+    {
+        /**
+         * Throws if the provided indices do not form a triangle list over the provided number of vertices
+         *
+         */
+        inline void validateTriangleList(const std::vector<std::size_t>& indices, std::size_t vertexCount)
+        {
+            if(indices.size() % 3 != 0)
+            {
+                throw IllegalArgumentException("A triangle list must hold a multiple of three indices");
+            }
+            for(std::size_t index : indices)
+            {
+                if(index >= vertexCount)
+                {
+                    throw IllegalArgumentException("A triangle list refers to a vertex that does not exist");
+                }
+            }
+        }
+
+        /// The size of the LRU cache that Forsyth's heuristic models
+        constexpr std::size_t FORSYTH_CACHE_SIZE = 32;
+
+        /**
+         * Scores a vertex by its (LRU) cache position and the number of triangles that still use it
+         *
+         */
+        inline float forsythScore(int cachePosition, std::size_t remainingTriangles) noexcept
+        {
+            if(remainingTriangles == 0)
+            {
+                return -1.0f;
+            }
+
+            float score = 0.0f;
+            if(cachePosition >= 0)
+            {
+                if(cachePosition < 3)
+                {
+                    /// The vertices of the triangle that was just emitted are scored equally, so that
+                    /// consecutive triangles aren't biased towards the same edge
+                    score = 0.75f;
+                }
+                else
+                {
+                    const float scale = 1.0f / static_cast<float>(FORSYTH_CACHE_SIZE - 3);
+                    score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scale, 1.5f);
+                }
+            }
+
+            /// Vertices with few remaining triangles are boosted, so that they are retired early
+            return score + 2.0f / std::sqrt(static_cast<float>(remainingTriangles));
+        }
+
+        /// The quantized attributes of a vertex (position, normal and texture coordinates)
+        typedef std::array<int64_t, 8> WeldKey;
+
+        /**
+         * Quantizes the attributes of the provided vertex
+         *
+         */
+        inline WeldKey quantize(const Vertex32F& vertex, float epsilon) noexcept
+        {
+            const float attributes[8] =
+            {
+                vertex.getPosition()[0], vertex.getPosition()[1], vertex.getPosition()[2],
+                vertex.getNormal()[0], vertex.getNormal()[1], vertex.getNormal()[2],
+                vertex.getTexCoord()[0], vertex.getTexCoord()[1]
+            };
+            WeldKey key;
+            for(std::size_t i = 0; i < 8; ++i)
+            {
+                if(epsilon == 0.0f)
+                {
+                    /// Adding zero turns -0 into +0
+                    const float value = attributes[i] + 0.0f;
+                    uint32_t bits;
+                    std::memcpy(&bits, &value, sizeof(bits));
+                    key[i] = bits;
+                }
+                else
+                {
+                    key[i] = static_cast<int64_t>(std::floor(static_cast<double>(attributes[i]) / epsilon + 0.5));
+                }
+            }
+            return key;
+        }
+
+        /**
+         * Hashes a quantized vertex
+         *
+         */
+        inline uint64_t hash(const WeldKey& key) noexcept
+        {
+            uint64_t hash = 0x9E3779B97F4A7C15ull;
+            for(int64_t element : key)
+            {
+                /// splitmix64 finalizer of each element, folded into the running hash
+                uint64_t x = static_cast<uint64_t>(element) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+                x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+                x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+                hash ^= x ^ (x >> 31);
+            }
+            return hash;
+        }
+
+        /**
+         * Invokes the provided function over [0, count) in contiguous ranges on the provided number of threads
+         *
+         */
+        template<typename F>
+        void parallelFor(std::size_t count, std::size_t threadCount, const F& function)
+        {
+            const std::size_t threads = std::max<std::size_t>(std::min(threadCount, count), 1);
+            std::vector<std::thread> workers;
+            workers.reserve(threads - 1);
+            for(std::size_t i = 0; i < threads - 1; ++i)
+            {
+                workers.emplace_back(function, count * i / threads, count * (i + 1) / threads);
+            }
+            function(count * (threads - 1) / threads, count);
+            for(std::thread& worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+        /**
+         * Lists the corners (triangle * 3 + corner) that use each vertex of the provided triangle list, by a
+         * counting sort - the corners of vertex v are [offsets[v], offsets[v + 1]) of corners, in ascending order
+         *
+         */
+        template<typename T>
+        void buildVertexCorners(const std::vector<std::size_t>& indices, std::size_t vertexCount, std::vector<T>& offsets, std::vector<T>& corners)
+        {
+            offsets.assign(vertexCount + 1, 0);
+            for(std::size_t index : indices)
+            {
+                ++offsets[index + 1];
+            }
+            for(std::size_t v = 0; v < vertexCount; ++v)
+            {
+                offsets[v + 1] += offsets[v];
+            }
+            corners.resize(indices.size());
+            std::vector<T> fill(offsets.begin(), offsets.end() - 1);
+            for(std::size_t corner = 0; corner < indices.size(); ++corner)
+            {
+                corners[fill[indices[corner]]++] = static_cast<T>(corner);
+            }
+        }
+    }
+
+    inline float computeACMR(const std::vector<std::size_t>& indices, std::size_t vertexCount, std::size_t cacheSize)
+    {
+        detail::validateTriangleList(indices, vertexCount);
+        if(indices.empty())
+        {
+            return 0.0f;
+        }
+
+        /// The time at which each vertex entered the cache - it is cached while it is among the most recent entries
+        std::vector<std::size_t> timestamps(vertexCount, 0);
+        std::size_t time = cacheSize + 1;
+        std::size_t misses = 0;
+        for(std::size_t index : indices)
+        {
+            if(time - timestamps[index] > cacheSize)
+            {
+                timestamps[index] = time++;
+                ++misses;
+            }
+        }
+        return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    }
+
+    inline void optimizeVertexCache(std::vector<std::size_t>& indices, std::size_t vertexCount)
+    {
+        detail::validateTriangleList(indices, vertexCount);
+        const std::size_t triangleCount = indices.size() / 3;
+        if(triangleCount == 0)
+        {
+            return;
+        }
+
+        /// The triangles that use each vertex, as offsets into a single array
+        std::vector<std::size_t> valences(vertexCount, 0);
+        for(std::size_t index : indices)
+        {
+            ++valences[index];
+        }
+        std::vector<std::size_t> offsets(vertexCount + 1, 0);
+        std::partial_sum(valences.begin(), valences.end(), offsets.begin() + 1);
+        std::vector<std::size_t> adjacency(indices.size());
+        {
+            std::vector<std::size_t> cursors(offsets.begin(), offsets.end() - 1);
+            for(std::size_t i = 0; i < indices.size(); ++i)
+            {
+                adjacency[cursors[indices[i]]++] = i / 3;
+            }
+        }
+
+        /// The number of triangles that are yet to be emitted, for each vertex
+        std::vector<std::size_t> remaining(valences);
+        std::vector<int> cachePositions(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for(std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            vertexScores[vertex] = detail::forsythScore(-1, remaining[vertex]);
+        }
+
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<std::size_t> result;
+        result.reserve(indices.size());
+
+        /// Three extra slots hold the vertices that are pushed out by the triangle being emitted
+        std::vector<std::size_t> cache;
+        std::vector<std::size_t> nextCache;
+        cache.reserve(detail::FORSYTH_CACHE_SIZE + 3);
+        nextCache.reserve(detail::FORSYTH_CACHE_SIZE + 3);
+
+        std::size_t best = 0;
+        std::size_t cursor = 0;
+        for(std::size_t count = 0; count < triangleCount; ++count)
+        {
+            if(best == triangleCount)
+            {
+                /// Nothing in the cache touches an unemitted triangle - resume from the first unemitted one
+                while(emitted[cursor])
+                {
+                    ++cursor;
+                }
+                best = cursor;
+            }
+
+            const std::size_t* corners = &indices[3 * best];
+            result.insert(result.end(), corners, corners + 3);
+            emitted[best] = true;
+
+            /// Retire the emitted triangle from the adjacency of its vertices
+            for(std::size_t i = 0; i < 3; ++i)
+            {
+                const std::size_t vertex = corners[i];
+                std::size_t* first = &adjacency[offsets[vertex]];
+                std::size_t* last = first + remaining[vertex];
+                std::iter_swap(std::find(first, last, best), last - 1);
+                --remaining[vertex];
+            }
+
+            /// The emitted triangle's vertices move to the front of the cache
+            nextCache.clear();
+            for(std::size_t i = 0; i < 3; ++i)
+            {
+                if(std::find(nextCache.begin(), nextCache.end(), corners[i]) == nextCache.end())
+                {
+                    nextCache.push_back(corners[i]);
+                }
+            }
+            for(std::size_t vertex : cache)
+            {
+                if(vertex != corners[0] && vertex != corners[1] && vertex != corners[2])
+                {
+                    nextCache.push_back(vertex);
+                }
+            }
+            std::swap(cache, nextCache);
+
+            for(std::size_t i = 0; i < cache.size(); ++i)
+            {
+                const std::size_t vertex = cache[i];
+                cachePositions[vertex] = i < detail::FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+                vertexScores[vertex] = detail::forsythScore(cachePositions[vertex], remaining[vertex]);
+            }
+
+            /// Rescore every triangle that touches the cache, and pick the best of them to emit next
+            best = triangleCount;
+            float bestScore = -1.0f;
+            for(std::size_t vertex : cache)
+            {
+                for(std::size_t i = offsets[vertex]; i < offsets[vertex] + remaining[vertex]; ++i)
+                {
+                    const std::size_t triangle = adjacency[i];
+                    const float score = vertexScores[indices[3 * triangle]] + vertexScores[indices[3 * triangle + 1]] +
+                        vertexScores[indices[3 * triangle + 2]];
+                    if(score > bestScore)
+                    {
+                        bestScore = score;
+                        best = triangle;
+                    }
+                }
+            }
+
+            if(cache.size() > detail::FORSYTH_CACHE_SIZE)
+            {
+                cache.resize(detail::FORSYTH_CACHE_SIZE);
+            }
+        }
+
+        indices = std::move(result);
+    }
+
+    inline void optimizeOverdraw(std::vector<std::size_t>& indices, const std::vector<Vertex32F>& vertices, float threshold)
+    {
+        detail::validateTriangleList(indices, vertices.size());
+        const std::size_t triangleCount = indices.size() / 3;
+        if(triangleCount < 2)
+        {
+            return;
+        }
+
+        /// Split wherever the (FIFO) cache has gone cold, so that reordering clusters costs few extra misses
+        constexpr std::size_t CACHE_SIZE = 16;
+        std::vector<std::size_t> clusters;
+        {
+            std::vector<std::size_t> timestamps(vertices.size(), 0);
+            std::size_t time = CACHE_SIZE + 1;
+            for(std::size_t triangle = 0; triangle < triangleCount; ++triangle)
+            {
+                std::size_t misses = 0;
+                for(std::size_t i = 0; i < 3; ++i)
+                {
+                    const std::size_t vertex = indices[3 * triangle + i];
+                    if(time - timestamps[vertex] > CACHE_SIZE)
+                    {
+                        timestamps[vertex] = time++;
+                        ++misses;
+                    }
+                }
+                if(triangle == 0 || misses == 3)
+                {
+                    clusters.push_back(triangle);
+                }
+            }
+        }
+        if(clusters.size() < 2)
+        {
+            return;
+        }
+        clusters.push_back(triangleCount);
+
+        /// The area-weighted centroid and the summed (area-weighted) normal of each cluster and of the whole mesh
+        struct Moments
+        {
+            float centroid[3];
+            float normal[3];
+            float area;
+        };
+        std::vector<Moments> moments(clusters.size() - 1, Moments{{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, 0.0f});
+        Moments mesh{{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, 0.0f};
+        for(std::size_t cluster = 0; cluster < moments.size(); ++cluster)
+        {
+            Moments& current = moments[cluster];
+            for(std::size_t triangle = clusters[cluster]; triangle < clusters[cluster + 1]; ++triangle)
+            {
+                const Point3F& p0 = vertices[indices[3 * triangle]].getPosition();
+                const Point3F& p1 = vertices[indices[3 * triangle + 1]].getPosition();
+                const Point3F& p2 = vertices[indices[3 * triangle + 2]].getPosition();
+
+                /// The cross product's length is twice the triangle's area
+                const Vector3F normal = cross(p0.vectorTo(p1), p0.vectorTo(p2));
+                const float area = normal.length();
+                for(std::size_t i = 0; i < 3; ++i)
+                {
+                    current.centroid[i] += (p0[i] + p1[i] + p2[i]) / 3.0f * area;
+                    current.normal[i] += normal[i];
+                }
+                current.area += area;
+            }
+            for(std::size_t i = 0; i < 3; ++i)
+            {
+                mesh.centroid[i] += current.centroid[i];
+            }
+            mesh.area += current.area;
+        }
+        if(mesh.area == 0.0f)
+        {
+            return;
+        }
+
+        /// Clusters that face furthest away from the centre are most likely to occlude the others
+        std::vector<float> keys(moments.size(), 0.0f);
+        for(std::size_t cluster = 0; cluster < moments.size(); ++cluster)
+        {
+            const Moments& current = moments[cluster];
+            if(current.area > 0.0f)
+            {
+                for(std::size_t i = 0; i < 3; ++i)
+                {
+                    const float offset = current.centroid[i] / current.area - mesh.centroid[i] / mesh.area;
+                    keys[cluster] += offset * current.normal[i] / current.area;
+                }
+            }
+        }
+        std::vector<std::size_t> order(clusters.size() - 1);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&keys](std::size_t a, std::size_t b)
+        {
+            return keys[a] > keys[b];
+        });
+
+        std::vector<std::size_t> result;
+        result.reserve(indices.size());
+        for(std::size_t cluster : order)
+        {
+            result.insert(result.end(), indices.begin() + 3 * clusters[cluster], indices.begin() + 3 * clusters[cluster + 1]);
+        }
+
+        if(computeACMR(result, vertices.size(), CACHE_SIZE) <= computeACMR(indices, vertices.size(), CACHE_SIZE) * threshold)
+        {
+            indices = std::move(result);
+        }
+    }
+
+    inline std::size_t weldVertices(const std::vector<Vertex32F>& vertices, std::vector<std::size_t>& remap, float epsilon, std::size_t threadCount)
+    {
+        if(epsilon < 0.0f)
+        {
+            throw IllegalArgumentException("The welding epsilon may not be negative");
+        }
+        const std::size_t threads = threadCount != 0 ? threadCount : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+        const std::size_t count = vertices.size();
+        std::vector<detail::WeldKey> keys(count);
+        std::vector<uint64_t> hashes(count);
+        detail::parallelFor(count, threads, [&](std::size_t first, std::size_t last)
+        {
+            for(std::size_t i = first; i < last; ++i)
+            {
+                keys[i] = detail::quantize(vertices[i], epsilon);
+                hashes[i] = detail::hash(keys[i]);
+            }
+        });
+
+        /// A power-of-two table at most half full - each slot holds (vertex index + 1), or 0 when empty
+        std::size_t capacity = 1;
+        while(capacity < count * 2)
+        {
+            capacity <<= 1;
+        }
+        const std::size_t mask = capacity - 1;
+        std::unique_ptr<std::atomic<std::size_t>[]> table(new std::atomic<std::size_t>[capacity]);
+        for(std::size_t i = 0; i < capacity; ++i)
+        {
+            table[i].store(0, std::memory_order_relaxed);
+        }
+
+        /// Every slot ends up holding the lowest index of its key, so the outcome is independent of scheduling
+        detail::parallelFor(count, threads, [&](std::size_t first, std::size_t last)
+        {
+            for(std::size_t i = first; i < last; ++i)
+            {
+                for(std::size_t slot = hashes[i] & mask; ; slot = (slot + 1) & mask)
+                {
+                    std::size_t occupant = table[slot].load(std::memory_order_acquire);
+                    if(occupant == 0)
+                    {
+                        if(table[slot].compare_exchange_strong(occupant, i + 1, std::memory_order_acq_rel))
+                        {
+                            break;
+                        }
+                        /// Lost the race - occupant now holds the winner
+                    }
+                    if(hashes[occupant - 1] != hashes[i] || keys[occupant - 1] != keys[i])
+                    {
+                        continue;
+                    }
+                    while(occupant > i + 1 && !table[slot].compare_exchange_weak(occupant, i + 1, std::memory_order_acq_rel))
+                    {
+                    }
+                    break;
+                }
+            }
+        });
+
+        std::vector<std::size_t> representatives(count);
+        detail::parallelFor(count, threads, [&](std::size_t first, std::size_t last)
+        {
+            for(std::size_t i = first; i < last; ++i)
+            {
+                for(std::size_t slot = hashes[i] & mask; ; slot = (slot + 1) & mask)
+                {
+                    const std::size_t occupant = table[slot].load(std::memory_order_relaxed);
+                    if(hashes[occupant - 1] == hashes[i] && keys[occupant - 1] == keys[i])
+                    {
+                        representatives[i] = occupant - 1;
+                        break;
+                    }
+                }
+            }
+        });
+
+        /// Representatives precede their duplicates, so a single ordered pass numbers them by first occurrence
+        remap.resize(count);
+        std::size_t unique = 0;
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            remap[i] = representatives[i] == i ? unique++ : remap[representatives[i]];
+        }
+        return unique;
+    }
+
+    namespace detail
+    {
+        /**
+         * The vertices of a triangle list in structure-of-arrays form, with the faces that use each vertex
+         *
+         */
+        struct TriangleSoup
+        {
+            std::vector<float> x;
+            std::vector<float> y;
+            std::vector<float> z;
+
+            /// The corners (triangle * 3 + corner) that use each vertex are [offsets[v], offsets[v + 1]) of corners
+            std::vector<std::size_t> offsets;
+            std::vector<std::size_t> corners;
+
+            /// The interior angle of each corner
+            std::vector<float> angles;
+
+            /// The length of the cross product of the edges of each triangle (twice its area)
+            std::vector<float> lengths;
+        };
+
+        /**
+         * Gathers the positions, corner adjacency and (optionally) corner angles of the provided triangle list
+         *
+         */
+        inline void buildTriangleSoup(TriangleSoup& soup, const std::vector<Vertex32F>& vertices, const std::vector<std::size_t>& indices,
+            std::size_t threads, bool withAngles)
+        {
+            const std::size_t vertexCount = vertices.size();
+            const std::size_t triangleCount = indices.size() / 3;
+
+            soup.x.resize(vertexCount);
+            soup.y.resize(vertexCount);
+            soup.z.resize(vertexCount);
+            parallelFor(vertexCount, threads, [&](std::size_t first, std::size_t last)
+            {
+                for(std::size_t v = first; v < last; ++v)
+                {
+                    const Point3F& position = vertices[v].getPosition();
+                    soup.x[v] = position[0];
+                    soup.y[v] = position[1];
+                    soup.z[v] = position[2];
+                }
+            });
+
+            buildVertexCorners(indices, vertexCount, soup.offsets, soup.corners);
+
+            soup.angles.resize(withAngles ? indices.size() : 0);
+            soup.lengths.resize(triangleCount);
+            parallelFor(triangleCount, threads, [&](std::size_t first, std::size_t last)
+            {
+                for(std::size_t triangle = first; triangle < last; ++triangle)
+                {
+                    const std::size_t* corner = &indices[triangle * 3];
+                    const float ax = soup.x[corner[1]] - soup.x[corner[0]], ay = soup.y[corner[1]] - soup.y[corner[0]], az = soup.z[corner[1]] - soup.z[corner[0]];
+                    const float bx = soup.x[corner[2]] - soup.x[corner[1]], by = soup.y[corner[2]] - soup.y[corner[1]], bz = soup.z[corner[2]] - soup.z[corner[1]];
+                    const float cx = soup.x[corner[0]] - soup.x[corner[2]], cy = soup.y[corner[0]] - soup.y[corner[2]], cz = soup.z[corner[0]] - soup.z[corner[2]];
+                    const float nx = ay * bz - az * by, ny = az * bx - ax * bz, nz = ax * by - ay * bx;
+                    const float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+                    soup.lengths[triangle] = length;
+                    if(!withAngles)
+                    {
+                        continue;
+                    }
+
+                    /// Every pair of edges spans the same area, so each angle is atan2(length, -dot) of its edges
+                    soup.angles[triangle * 3] = std::atan2(length, -(cx * ax + cy * ay + cz * az));
+                    soup.angles[triangle * 3 + 1] = std::atan2(length, -(ax * bx + ay * by + az * bz));
+                    soup.angles[triangle * 3 + 2] = std::atan2(length, -(bx * cx + by * cy + bz * cz));
+                }
+            });
+        }
+    }
+
+    inline std::vector<float> computeVertexNormals(const std::vector<Vertex32F>& vertices, const std::vector<std::size_t>& indices,
+        NormalWeighting weighting, std::size_t threadCount)
+    {
+        detail::validateTriangleList(indices, vertices.size());
+        const std::size_t threads = threadCount != 0 ? threadCount : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        const std::size_t triangleCount = indices.size() / 3;
+
+        detail::TriangleSoup soup;
+        detail::buildTriangleSoup(soup, vertices, indices, threads, weighting != NormalWeighting::AREA);
+
+        /// The face normals, scaled so that a corner contributes its face normal times its corner weight
+        std::vector<float> faceX(triangleCount);
+        std::vector<float> faceY(triangleCount);
+        std::vector<float> faceZ(triangleCount);
+        detail::parallelFor(triangleCount, threads, [&](std::size_t first, std::size_t last)
+        {
+            for(std::size_t triangle = first; triangle < last; ++triangle)
+            {
+                const std::size_t* corner = &indices[triangle * 3];
+                const float ax = soup.x[corner[1]] - soup.x[corner[0]], ay = soup.y[corner[1]] - soup.y[corner[0]], az = soup.z[corner[1]] - soup.z[corner[0]];
+                const float bx = soup.x[corner[2]] - soup.x[corner[0]], by = soup.y[corner[2]] - soup.y[corner[0]], bz = soup.z[corner[2]] - soup.z[corner[0]];
+
+                /// The cross product is proportional to area - it is normalized unless area is wanted
+                const float scale = weighting == NormalWeighting::ANGLE && soup.lengths[triangle] > 0.0f ? 1.0f / soup.lengths[triangle] : 1.0f;
+                faceX[triangle] = (ay * bz - az * by) * scale;
+                faceY[triangle] = (az * bx - ax * bz) * scale;
+                faceZ[triangle] = (ax * by - ay * bx) * scale;
+            }
+        });
+
+        std::vector<float> normals(vertices.size() * 3);
+        detail::parallelFor(vertices.size(), threads, [&](std::size_t first, std::size_t last)
+        {
+            for(std::size_t v = first; v < last; ++v)
+            {
+                float nx = 0.0f, ny = 0.0f, nz = 0.0f;
+                for(std::size_t i = soup.offsets[v]; i < soup.offsets[v + 1]; ++i)
+                {
+                    const std::size_t corner = soup.corners[i];
+                    const std::size_t triangle = corner / 3;
+                    const float weight = weighting == NormalWeighting::AREA ? 1.0f : soup.angles[corner];
+                    nx += faceX[triangle] * weight;
+                    ny += faceY[triangle] * weight;
+                    nz += faceZ[triangle] * weight;
+                }
+                const float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+                if(length > 0.0f && std::isfinite(length))
+                {
+                    normals[v * 3] = nx / length;
+                    normals[v * 3 + 1] = ny / length;
+                    normals[v * 3 + 2] = nz / length;
+                }
+                else
+                {
+                    const Vector3F& normal = vertices[v].getNormal();
+                    normals[v * 3] = normal[0];
+                    normals[v * 3 + 1] = normal[1];
+                    normals[v * 3 + 2] = normal[2];
+                }
+            }
+        });
+        return normals;
+    }
+
+    inline std::vector<float> computeVertexTangents(const std::vector<Vertex32F>& vertices, const std::vector<std::size_t>& indices,
+        std::size_t threadCount)
+    {
+        detail::validateTriangleList(indices, vertices.size());
+        const std::size_t threads = threadCount != 0 ? threadCount : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        const std::size_t triangleCount = indices.size() / 3;
+
+        detail::TriangleSoup soup;
+        detail::buildTriangleSoup(soup, vertices, indices, threads, true);
+
+        /// The unit tangent and bitangent of each face (zero where the texture coordinates are degenerate)
+        std::vector<float> tangentX(triangleCount), tangentY(triangleCount), tangentZ(triangleCount);
+        std::vector<float> bitangentX(triangleCount), bitangentY(triangleCount), bitangentZ(triangleCount);
+        detail::parallelFor(triangleCount, threads, [&](std::size_t first, std::size_t last)
+        {
+            for(std::size_t triangle = first; triangle < last; ++triangle)
+            {
+                const std::size_t* corner = &indices[triangle * 3];
+                const float ax = soup.x[corner[1]] - soup.x[corner[0]], ay = soup.y[corner[1]] - soup.y[corner[0]], az = soup.z[corner[1]] - soup.z[corner[0]];
+                const float bx = soup.x[corner[2]] - soup.x[corner[0]], by = soup.y[corner[2]] - soup.y[corner[0]], bz = soup.z[corner[2]] - soup.z[corner[0]];
+                const Point2F& uv0 = vertices[corner[0]].getTexCoord();
+                const Point2F& uv1 = vertices[corner[1]].getTexCoord();
+                const Point2F& uv2 = vertices[corner[2]].getTexCoord();
+                const float du1 = uv1[0] - uv0[0], dv1 = uv1[1] - uv0[1];
+                const float du2 = uv2[0] - uv0[0], dv2 = uv2[1] - uv0[1];
+
+                /// Only the sign of the determinant matters, as both directions are normalized
+                const float determinant = du1 * dv2 - du2 * dv1;
+                const float sign = determinant > 0.0f ? 1.0f : determinant < 0.0f ? -1.0f : 0.0f;
+                float tx = (ax * dv2 - bx * dv1) * sign, ty = (ay * dv2 - by * dv1) * sign, tz = (az * dv2 - bz * dv1) * sign;
+                float sx = (bx * du1 - ax * du2) * sign, sy = (by * du1 - ay * du2) * sign, sz = (bz * du1 - az * du2) * sign;
+                const float tangentLength = std::sqrt(tx * tx + ty * ty + tz * tz);
+                const float bitangentLength = std::sqrt(sx * sx + sy * sy + sz * sz);
+                const float tangentScale = tangentLength > 0.0f ? 1.0f / tangentLength : 0.0f;
+                const float bitangentScale = bitangentLength > 0.0f ? 1.0f / bitangentLength : 0.0f;
+                tangentX[triangle] = tx * tangentScale;
+                tangentY[triangle] = ty * tangentScale;
+                tangentZ[triangle] = tz * tangentScale;
+                bitangentX[triangle] = sx * bitangentScale;
+                bitangentY[triangle] = sy * bitangentScale;
+                bitangentZ[triangle] = sz * bitangentScale;
+            }
+        });
+
+        std::vector<float> tangents(vertices.size() * 4);
+        detail::parallelFor(vertices.size(), threads, [&](std::size_t first, std::size_t last)
+        {
+            for(std::size_t v = first; v < last; ++v)
+            {
+                float tx = 0.0f, ty = 0.0f, tz = 0.0f;
+                float sx = 0.0f, sy = 0.0f, sz = 0.0f;
+                for(std::size_t i = soup.offsets[v]; i < soup.offsets[v + 1]; ++i)
+                {
+                    const std::size_t corner = soup.corners[i];
+                    const std::size_t triangle = corner / 3;
+                    const float weight = soup.angles[corner];
+                    tx += tangentX[triangle] * weight;
+                    ty += tangentY[triangle] * weight;
+                    tz += tangentZ[triangle] * weight;
+                    sx += bitangentX[triangle] * weight;
+                    sy += bitangentY[triangle] * weight;
+                    sz += bitangentZ[triangle] * weight;
+                }
+
+                /// Gram-Schmidt against the normal
+                const Vector3F& normal = vertices[v].getNormal();
+                float nx = normal[0], ny = normal[1], nz = normal[2];
+                const float normalLength = std::sqrt(nx * nx + ny * ny + nz * nz);
+                if(normalLength > 0.0f)
+                {
+                    nx /= normalLength;
+                    ny /= normalLength;
+                    nz /= normalLength;
+                }
+                const float dot = nx * tx + ny * ty + nz * tz;
+                tx -= nx * dot;
+                ty -= ny * dot;
+                tz -= nz * dot;
+                float length = std::sqrt(tx * tx + ty * ty + tz * tz);
+                if(!(length > 1e-6f) || !std::isfinite(length))
+                {
+                    /// Without usable texture coordinates, any direction perpendicular to the normal will do
+                    const bool useX = std::abs(nx) < 0.9f;
+                    tx = useX ? 0.0f : -nz;
+                    ty = useX ? nz : 0.0f;
+                    tz = useX ? -ny : nx;
+                    length = std::sqrt(tx * tx + ty * ty + tz * tz);
+                    if(length == 0.0f)
+                    {
+                        tx = 1.0f;
+                        length = 1.0f;
+                    }
+                }
+                tangents[v * 4] = tx / length;
+                tangents[v * 4 + 1] = ty / length;
+                tangents[v * 4 + 2] = tz / length;
+
+                const float cx = ny * tz - nz * ty, cy = nz * tx - nx * tz, cz = nx * ty - ny * tx;
+                tangents[v * 4 + 3] = cx * sx + cy * sy + cz * sz < 0.0f ? -1.0f : 1.0f;
+            }
+        });
+        return tangents;
+    }
+}
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "IllegalArgumentException.hpp"
+#include "MeshOptimizer.hpp"
+
+namespace midnight
+{
+    namespace detail
+    {
+        /**
+         * Computes the bounding sphere and normal cone of the provided triangles
+         *
+         */
+        inline void boundMeshlet(Meshlet& meshlet, const std::size_t* indices, const std::vector<Vertex32F>& vertices,
+            const std::vector<float>& normals)
+        {
+            float minimum[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+            float maximum[3] = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+            for(std::size_t i = 0; i < meshlet.indexCount; ++i)
+            {
+                const Point3F& position = vertices[indices[i]].getPosition();
+                for(std::size_t axis = 0; axis < 3; ++axis)
+                {
+                    minimum[axis] = std::min(minimum[axis], position[axis]);
+                    maximum[axis] = std::max(maximum[axis], position[axis]);
+                }
+            }
+            for(std::size_t axis = 0; axis < 3; ++axis)
+            {
+                meshlet.center[axis] = (minimum[axis] + maximum[axis]) * 0.5f;
+            }
+            float radius = 0.0f;
+            for(std::size_t i = 0; i < meshlet.indexCount; ++i)
+            {
+                const Point3F& position = vertices[indices[i]].getPosition();
+                const float dx = position[0] - meshlet.center[0];
+                const float dy = position[1] - meshlet.center[1];
+                const float dz = position[2] - meshlet.center[2];
+                radius = std::max(radius, dx * dx + dy * dy + dz * dz);
+            }
+            meshlet.radius = std::sqrt(radius);
+
+            /// The cone axis is the mean of the triangle normals, and the cone is as wide as the widest of them
+            const std::size_t firstTriangle = meshlet.firstIndex / 3;
+            const std::size_t triangleCount = meshlet.indexCount / 3;
+            float axis[3] = {0.0f, 0.0f, 0.0f};
+            for(std::size_t triangle = firstTriangle; triangle < firstTriangle + triangleCount; ++triangle)
+            {
+                for(std::size_t k = 0; k < 3; ++k)
+                {
+                    axis[k] += normals[triangle * 3 + k];
+                }
+            }
+            const float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+            float minimumDot = 1.0f;
+            for(std::size_t k = 0; k < 3; ++k)
+            {
+                meshlet.coneAxis[k] = length > 0.0f ? axis[k] / length : 0.0f;
+            }
+            for(std::size_t triangle = firstTriangle; triangle < firstTriangle + triangleCount; ++triangle)
+            {
+                const float* normal = &normals[triangle * 3];
+                if(normal[0] != 0.0f || normal[1] != 0.0f || normal[2] != 0.0f)
+                {
+                    minimumDot = std::min(minimumDot, normal[0] * meshlet.coneAxis[0] + normal[1] * meshlet.coneAxis[1] + normal[2] * meshlet.coneAxis[2]);
+                }
+            }
+
+            /// A cone of half a sphere or more can never be wholly back-facing
+            meshlet.coneCutoff = length > 0.0f && minimumDot > 0.0f ? std::sqrt(1.0f - minimumDot * minimumDot) : 1.0f;
+        }
+    }
+
+    inline std::vector<Meshlet> buildMeshlets(std::vector<std::size_t>& indices, const std::vector<Vertex32F>& vertices,
+        std::size_t maxTriangles, std::size_t maxVertices)
+    {
+        detail::validateTriangleList(indices, vertices.size());
+        if(maxTriangles == 0 || maxVertices < 3)
+        {
+            throw IllegalArgumentException("A Meshlet must be able to hold at least one triangle");
+        }
+
+        const std::size_t triangleCount = indices.size() / 3;
+        constexpr std::size_t NONE = static_cast<std::size_t>(-1);
+
+        /// The unit normal of each triangle (zero for degenerate ones)
+        std::vector<float> normals(triangleCount * 3);
+        for(std::size_t triangle = 0; triangle < triangleCount; ++triangle)
+        {
+            const Point3F& p0 = vertices[indices[triangle * 3]].getPosition();
+            const Point3F& p1 = vertices[indices[triangle * 3 + 1]].getPosition();
+            const Point3F& p2 = vertices[indices[triangle * 3 + 2]].getPosition();
+            const float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+            const float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+            const float normal[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+            const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            for(std::size_t k = 0; k < 3; ++k)
+            {
+                normals[triangle * 3 + k] = length > 0.0f ? normal[k] / length : 0.0f;
+            }
+        }
+
+        /// The corners (and so the triangles) that use each vertex
+        std::vector<std::size_t> adjacencyOffsets;
+        std::vector<std::size_t> adjacency;
+        detail::buildVertexCorners(indices, vertices.size(), adjacencyOffsets, adjacency);
+
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<std::size_t> vertexMeshlet(vertices.size(), NONE);
+        std::vector<std::size_t> candidateMeshlet(triangleCount, NONE);
+        std::vector<std::size_t> candidates;
+        std::vector<std::size_t> ordered;
+        ordered.reserve(indices.size());
+        std::vector<float> orderedNormals;
+        orderedNormals.reserve(normals.size());
+
+        std::vector<Meshlet> meshlets;
+        std::size_t cursor = 0;
+        while(ordered.size() < indices.size())
+        {
+            const std::size_t current = meshlets.size();
+            Meshlet meshlet;
+            meshlet.firstIndex = ordered.size();
+            std::size_t meshletTriangles = 0;
+            std::size_t meshletVertices = 0;
+            float normalSum[3] = {0.0f, 0.0f, 0.0f};
+            candidates.clear();
+
+            while(meshletTriangles < maxTriangles)
+            {
+                /// The candidate that brings in the fewest new vertices, then the one that faces most like the Meshlet
+                std::size_t best = NONE;
+                std::size_t bestNewVertices = 4;
+                float bestDot = 0.0f;
+                for(std::size_t i = 0; i < candidates.size();)
+                {
+                    const std::size_t triangle = candidates[i];
+                    if(emitted[triangle])
+                    {
+                        candidates[i] = candidates.back();
+                        candidates.pop_back();
+                        continue;
+                    }
+                    std::size_t newVertices = 0;
+                    for(std::size_t k = 0; k < 3; ++k)
+                    {
+                        newVertices += vertexMeshlet[indices[triangle * 3 + k]] != current ? 1 : 0;
+                    }
+                    const float* normal = &normals[triangle * 3];
+                    const float dot = normal[0] * normalSum[0] + normal[1] * normalSum[1] + normal[2] * normalSum[2];
+                    if(newVertices < bestNewVertices || (newVertices == bestNewVertices && dot > bestDot))
+                    {
+                        best = triangle;
+                        bestNewVertices = newVertices;
+                        bestDot = dot;
+                    }
+                    ++i;
+                }
+
+                /// Without a neighbour, continue with the next triangle in the original order
+                if(best == NONE)
+                {
+                    while(cursor < triangleCount && emitted[cursor])
+                    {
+                        ++cursor;
+                    }
+                    if(cursor == triangleCount)
+                    {
+                        break;
+                    }
+                    best = cursor;
+                    bestNewVertices = 0;
+                    for(std::size_t k = 0; k < 3; ++k)
+                    {
+                        bestNewVertices += vertexMeshlet[indices[best * 3 + k]] != current ? 1 : 0;
+                    }
+                }
+                if(meshletVertices + bestNewVertices > maxVertices)
+                {
+                    break;
+                }
+
+                emitted[best] = true;
+                ++meshletTriangles;
+                meshletVertices += bestNewVertices;
+                for(std::size_t k = 0; k < 3; ++k)
+                {
+                    const std::size_t vertex = indices[best * 3 + k];
+                    vertexMeshlet[vertex] = current;
+                    ordered.push_back(vertex);
+                    orderedNormals.push_back(normals[best * 3 + k]);
+                    normalSum[k] += normals[best * 3 + k];
+                    for(std::size_t j = adjacencyOffsets[vertex]; j < adjacencyOffsets[vertex + 1]; ++j)
+                    {
+                        const std::size_t neighbour = adjacency[j] / 3;
+                        if(!emitted[neighbour] && candidateMeshlet[neighbour] != current)
+                        {
+                            candidateMeshlet[neighbour] = current;
+                            candidates.push_back(neighbour);
+                        }
+                    }
+                }
+            }
+
+            meshlet.indexCount = ordered.size() - meshlet.firstIndex;
+            meshlets.push_back(meshlet);
+        }
+
+        indices.swap(ordered);
+        for(Meshlet& meshlet : meshlets)
+        {
+            detail::boundMeshlet(meshlet, &indices[meshlet.firstIndex], vertices, orderedNormals);
+        }
+        return meshlets;
+    }
+
+    inline bool isBackFacing(const Meshlet& meshlet, const float eye[3]) noexcept
+    {
+        const float direction[3] = {meshlet.center[0] - eye[0], meshlet.center[1] - eye[1], meshlet.center[2] - eye[2]};
+        const float distance = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+        const float dot = direction[0] * meshlet.coneAxis[0] + direction[1] * meshlet.coneAxis[1] + direction[2] * meshlet.coneAxis[2];
+        return dot > meshlet.coneCutoff * distance + meshlet.radius;
+    }
+
+    inline bool isOutside(const Meshlet& meshlet, const float (*planes)[4], std::size_t planeCount) noexcept
+    {
+        for(std::size_t i = 0; i < planeCount; ++i)
+        {
+            const float* plane = planes[i];
+            if(plane[0] * meshlet.center[0] + plane[1] * meshlet.center[1] + plane[2] * meshlet.center[2] + plane[3] < -meshlet.radius)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
@@ -54,14 +54,11 @@ namespace midnight
     };
 
     template<typename T, std::size_t W, std::size_t H, std::size_t L>
-    const std::string Skybox<T, W, H, L>::VERTEX_SHADER_SRC = 
-        "#version 130\n\
+    const std::string Skybox<T, W, H, L>::VERTEX_SHADER_SRC = std::string(
+        "#version 130\n") + FRAME_UNIFORM_BLOCK_SRC + "\
         in vec3 position;\n\
         in vec2 uv_in;\n\
         out vec2 uv_out;\n\
-        uniform vec3 offset;\n\
-        uniform mat4 projection;\n\
-        uniform mat4 orientation;\n\
         void main()\n\
         {\n\
             vec4 cameraPos = vec4(position.x, position.y, position.z, 1.0) + vec4(offset.x, offset.y, offset.z, 0.0);\n\
@@ -89,6 +86,7 @@ namespace midnight
         texture(texture), 
         vbo(DATA)
     {
+        program.setUniformBlockBinding(FRAME_UNIFORM_BLOCK, FRAME_UNIFORM_BINDING);
         vbo.addAttributePointer("position", 3, GL_FLOAT, GL_FALSE, 0, 0);
         vbo.addAttributePointer("uv_in", 2, GL_FLOAT, GL_FALSE, 0, reinterpret_cast<GLvoid*>(48 * 6));
     }
@@ -96,18 +94,15 @@ namespace midnight
     template<typename T, std::size_t W, std::size_t H, std::size_t L>
     void Skybox<T, W, H, L>::render(const Camera& camera)
     {
-   		glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture.handle);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP);
+   		GLState::current().setActiveTexture(GL_TEXTURE0);
+        GLState::current().bindTexture(GL_TEXTURE_2D, texture.handle);
+        GLState::current().setTextureParameter(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        GLState::current().setTextureParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        GLState::current().setTextureParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+        GLState::current().setTextureParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+        GLState::current().setTextureParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP);
         
 		program.bind();
-		program.setUniform("offset", camera.getPosition());
-		program.setMatrixUniform("projection", camera.getProjection());
-		program.setMatrixUniform("orientation", camera.getOrientation());
 		vbo.bind();
 		glDrawArrays(GL_QUADS, 0, 24);
 		vbo.unbind();
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "IllegalArgumentException.hpp"
+
+namespace midnight
+{
+    namespace detail
+    {
+        /**
+         * Determines whether the provided Materials would render identically
+         *
+         */
+        inline bool isSameMaterial(const Material& lhs, const Material& rhs) noexcept
+        {
+            if(lhs.getLightingMode() != rhs.getLightingMode() ||
+                lhs.getCullingMode() != rhs.getCullingMode() ||
+                lhs.autoNormalizes() != rhs.autoNormalizes())
+            {
+                return false;
+            }
+            for(std::size_t i = 0; i < 4; ++i)
+            {
+                if(lhs.getAmbience()[i] != rhs.getAmbience()[i] ||
+                    lhs.getDiffusion()[i] != rhs.getDiffusion()[i] ||
+                    lhs.getEmission()[i] != rhs.getEmission()[i] ||
+                    lhs.getSpecularity()[i] != rhs.getSpecularity()[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    inline std::size_t StaticBatch::findGroup(const Material& material)
+    {
+        for(std::size_t i = 0; i < groups.size(); ++i)
+        {
+            if(detail::isSameMaterial(groups[i].material, material))
+            {
+                return i;
+            }
+        }
+        groups.emplace_back(material);
+        return groups.size() - 1;
+    }
+
+    inline std::size_t StaticBatch::add(const Mesh& mesh, const Matrix4x4F& transformation)
+    {
+        const std::size_t baseVertex = getVertexCount();
+        if(baseVertex + mesh.getVertices().size() > std::numeric_limits<uint32_t>::max())
+        {
+            throw IllegalArgumentException("A StaticBatch can not address more than 2^32 vertices");
+        }
+
+        const Matrix4x4F& m = transformation;
+
+        /// The cofactor matrix of the upper 3x3 is its inverse transpose scaled by its determinant
+        const float cofactor[3][3] =
+        {
+            {m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1), m(1, 2) * m(2, 0) - m(1, 0) * m(2, 2), m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0)},
+            {m(0, 2) * m(2, 1) - m(0, 1) * m(2, 2), m(0, 0) * m(2, 2) - m(0, 2) * m(2, 0), m(0, 1) * m(2, 0) - m(0, 0) * m(2, 1)},
+            {m(0, 1) * m(1, 2) - m(0, 2) * m(1, 1), m(0, 2) * m(1, 0) - m(0, 0) * m(1, 2), m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0)}
+        };
+        const float determinant = m(0, 0) * cofactor[0][0] + m(0, 1) * cofactor[0][1] + m(0, 2) * cofactor[0][2];
+        const bool mirrored = determinant < 0.0f;
+
+        const std::vector<float> source = mesh.getInterleavedVertices();
+        vertices.reserve(vertices.size() + source.size());
+        for(std::size_t offset = 0; offset < source.size(); offset += Mesh::INTERLEAVED_SIZE)
+        {
+            const float* vertex = &source[offset];
+            float normal[3];
+            for(std::size_t column = 0; column < 3; ++column)
+            {
+                vertices.push_back(vertex[0] * m(0, column) + vertex[1] * m(1, column) + vertex[2] * m(2, column) + m(3, column));
+                normal[column] = vertex[3] * cofactor[0][column] + vertex[4] * cofactor[1][column] + vertex[5] * cofactor[2][column];
+            }
+            const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            const float scale = length > 0.0f ? (mirrored ? -1.0f : 1.0f) / length : 0.0f;
+            vertices.insert(vertices.end(), {normal[0] * scale, normal[1] * scale, normal[2] * scale, vertex[6], vertex[7]});
+        }
+
+        const std::size_t firstRange = ranges.size();
+        for(const Mesh::Renderable& renderable : mesh.getMeshes())
+        {
+            Range range;
+            range.group = findGroup(mesh.getMaterials().at(renderable.materialIndex));
+            std::vector<uint32_t>& indices = groups[range.group].indices;
+            range.firstIndex = indices.size();
+            range.indexCount = renderable.indices.size();
+
+            float minimum[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+            float maximum[3] = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+            for(std::size_t i = 0; i < renderable.indices.size(); ++i)
+            {
+                /// Swapping the last two indices of each triangle restores the winding of a mirrored mesh
+                const std::size_t corner = i % 3;
+                const std::size_t from = !mirrored || corner == 0 ? i : corner == 1 ? i + 1 : i - 1;
+                const std::size_t vertex = baseVertex + renderable.indices[from];
+                indices.push_back(static_cast<uint32_t>(vertex));
+
+                const float* position = &vertices[vertex * Mesh::INTERLEAVED_SIZE];
+                for(std::size_t axis = 0; axis < 3; ++axis)
+                {
+                    minimum[axis] = std::min(minimum[axis], position[axis]);
+                    maximum[axis] = std::max(maximum[axis], position[axis]);
+                }
+            }
+
+            range.radius = 0.0f;
+            for(std::size_t axis = 0; axis < 3; ++axis)
+            {
+                range.center[axis] = range.indexCount == 0 ? 0.0f : (minimum[axis] + maximum[axis]) * 0.5f;
+            }
+            for(std::size_t i = range.firstIndex; i < indices.size(); ++i)
+            {
+                const float* position = &vertices[indices[i] * Mesh::INTERLEAVED_SIZE];
+                const float dx = position[0] - range.center[0];
+                const float dy = position[1] - range.center[1];
+                const float dz = position[2] - range.center[2];
+                range.radius = std::max(range.radius, dx * dx + dy * dy + dz * dz);
+            }
+            range.radius = std::sqrt(range.radius);
+            ranges.push_back(range);
+        }
+        return firstRange;
+    }
+
+    inline std::size_t StaticBatch::getVertexCount() const noexcept
+    {
+        return vertices.size() / Mesh::INTERLEAVED_SIZE;
+    }
+
+    inline const std::vector<float>& StaticBatch::getVertices() const noexcept
+    {
+        return vertices;
+    }
+
+    inline const std::vector<StaticBatch::Group>& StaticBatch::getGroups() const noexcept
+    {
+        return groups;
+    }
+
+    inline const std::vector<StaticBatch::Range>& StaticBatch::getRanges() const noexcept
+    {
+        return ranges;
+    }
+}
@@ -3,110 +3,215 @@
 
 namespace midnight
 {
+    namespace detail
+    {
+        /// Hashed at compile-time, as it is set every frame
+        constexpr UniformName AMBIENT_COLOR_UNIFORM("ambient_color");
+    }
+    
+    template<typename T>
+    PreparedTerrain<T>::PreparedTerrain(Heightmap&& heightmap, std::size_t textureWidth, std::size_t textureHeight, 
+            std::vector<unsigned char>&& texturePixels, T verticalScale, T horizontalScale) :
+        verticalScale(verticalScale),
+        horizontalScale(horizontalScale),
+        heightmap(std::move(heightmap)),
+        pyramid(this->heightmap),
+        indexer(this->heightmap.getWidth(), this->heightmap.getHeight()),
+        textureWidth(textureWidth),
+        textureHeight(textureHeight),
+        texturePixels(std::move(texturePixels))
+    {
+        Terrain<T>::buildVertices(this->heightmap, verticalScale, 
+                Heightmap::Region{0, 0, this->heightmap.getWidth(), this->heightmap.getHeight()}, vertices);
+    }
+    
+    template<typename T>
+    PreparedTerrain<T>::PreparedTerrain(const std::string& heightmapFile, const std::string& texturemapFile, 
+            T verticalScale, T horizontalScale) :
+        PreparedTerrain(io::loadHeightmap(heightmapFile), 0, 0, std::vector<unsigned char>(), verticalScale, horizontalScale)
+    {
+        texturePixels = io::loadPixels(texturemapFile, textureWidth, textureHeight);
+    }
+    
+    template<typename T>
+    std::size_t uploadSize(const PreparedTerrain<T>& terrain) noexcept
+    {
+        return sizeof(T) * terrain.vertices.size() + sizeof(uint16_t) * terrain.indexer.getIndices().size() + terrain.texturePixels.size();
+    }
+    
+    template<typename T>
+    Terrain<T>::Terrain(const std::string& heightmapFile, const std::string& texturemapFile, T verticalScale, T horizontalScale, bool editable) : 
+        Terrain(PreparedTerrain<T>(heightmapFile, texturemapFile, verticalScale, horizontalScale), editable)
+    {
+    }
     
     template<typename T>
-    Terrain<T>::Terrain(const std::string& heightmapFile, const std::string& texturemapFile, T verticalScale, T horizontalScale) : 
-        verticalScale(verticalScale), 
-        horizontalScale(horizontalScale), 
-        heightmap(io::loadHeightmap(heightmapFile)), 
-        texture(io::loadTexture(texturemapFile)), 
+    Terrain<T>::Terrain(PreparedTerrain<T>&& prepared, bool editable) : 
+        verticalScale(prepared.verticalScale), 
+        horizontalScale(prepared.horizontalScale), 
+        heightmap(std::move(prepared.heightmap)), 
+        pyramid(std::move(prepared.pyramid)), 
+        texture(prepared.textureWidth, prepared.textureHeight, prepared.texturePixels), 
         program(VertexShader(VERTEX_SHADER_SRC), FragmentShader(FRAGMENT_SHADER_SRC))
     {
-            std::vector<uint32_t> _indexData;
-            _indexData.resize(heightmap.getWidth() * heightmap.getHeight() * 6);
-            std::size_t ptr = 0;
-            for(uint32_t i = 0; i < heightmap.getWidth() - 1; ++i)
+        program.setUniformBlockBinding(FRAME_UNIFORM_BLOCK, FRAME_UNIFORM_BINDING);
+        for(const TerrainIndexer::Tile& tile : prepared.indexer.getTiles())
+        {
+            tileCounts.push_back(static_cast<GLsizei>(tile.count));
+            tileOffsets.push_back(reinterpret_cast<const GLvoid*>(tile.first * sizeof(uint16_t)));
+            tileBaseVertices.push_back(static_cast<GLint>(tile.baseVertex));
+        }
+
+        /// Editable Terrains are respecified often, so hint as much to the implementation
+        if(editable)
+        {
+            this->vertexData.reset(new DynamicDrawTriangleBuffer<T>(std::move(prepared.vertices)));
+        }
+        else
+        {
+            this->vertexData.reset(new StaticDrawTriangleBuffer<T>(std::move(prepared.vertices)));
+        }
+        this->indexBuffer.reset(new StaticDrawIndexBuffer<uint16_t>(prepared.indexer.releaseIndices()));
+
+        this->vertexData->addAttributePointer("position", 3, GL_FLOAT, GL_FALSE, DATA_COUNT * 4, reinterpret_cast<GLvoid*>(0));
+        this->vertexData->addAttributePointer("uv", 2, GL_FLOAT, GL_FALSE, DATA_COUNT * 4, reinterpret_cast<GLvoid*>(12));
+        this->vertexData->addAttributePointer("normal", 3, GL_FLOAT, GL_FALSE, DATA_COUNT * 4, reinterpret_cast<GLvoid*>(20));
+    }
+
+    template<typename T>
+    Point<T, 3> Terrain<T>::getPosition(const Heightmap& heightmap, T verticalScale, std::size_t i, std::size_t j)
+    {
+        return Point<T, 3>((T)i - (T)((T)heightmap.getWidth() / 2.0f), 
+                -static_cast<T>(heightmap.getSample(i, j)) / 255.0f * verticalScale, 
+                (T)j - (T)((T)heightmap.getHeight() / 2.0f));
+    }
+
+    template<typename T>
+    void Terrain<T>::buildVertices(const Heightmap& heightmap, T verticalScale, const Heightmap::Region& region, std::vector<T>& vertices)
+    {
+        const std::size_t regionWidth = region.x1 - region.x0;
+        vertices.assign(regionWidth * (region.y1 - region.y0) * DATA_COUNT, static_cast<T>(0));
+        for(std::size_t j = region.y0; j < region.y1; ++j)
+        {
+            for(std::size_t i = region.x0; i < region.x1; ++i)
             {
-                for(uint32_t j = 0; j < heightmap.getHeight() - 1; ++j)
-                {
-                    _indexData[ptr++] = static_cast<uint32_t>(j * heightmap.getWidth() + i);
-                    _indexData[ptr++] = static_cast<uint32_t>((j + 1) * heightmap.getWidth() + i);
-                    _indexData[ptr++] = static_cast<uint32_t>(j * heightmap.getWidth() + i+ 1);
+                T* vertex = &vertices[DATA_COUNT * ((j - region.y0) * regionWidth + (i - region.x0))];
+                const Point<T, 3> position = getPosition(heightmap, verticalScale, i, j);
 
-                    _indexData[ptr++] = static_cast<uint32_t>(j * heightmap.getWidth() + i+ 1);
-                    _indexData[ptr++] = static_cast<uint32_t>((j + 1) * heightmap.getWidth() + i);
-                    _indexData[ptr++] = static_cast<uint32_t>((j + 1) * heightmap.getWidth() + i+ 1);
+                /// Positions
+                vertex[0] = position[0];
+                vertex[1] = position[1];
+                vertex[2] = position[2];
 
-                }
+                /// Texture Coordinates
+                vertex[3] = static_cast<T>(i) / static_cast<T>(heightmap.getWidth());
+                vertex[4] = static_cast<T>(j) / static_cast<T>(heightmap.getHeight());
             }
+        }
 
-            std::vector<T> _vertexData;
-            constexpr std::size_t DATA_COUNT = 8;
-            _vertexData.resize(heightmap.getWidth() * heightmap.getHeight() * DATA_COUNT);
-            for(std::size_t i = 0; i < heightmap.getWidth(); ++i)
+        /// Accumulate the face normals of the two triangles of every quad that touches the region into the 
+        /// vertices that lie within it
+        const std::size_t quadX0 = region.x0 > 0 ? region.x0 - 1 : 0;
+        const std::size_t quadY0 = region.y0 > 0 ? region.y0 - 1 : 0;
+        const std::size_t quadX1 = std::min(region.x1, heightmap.getWidth() - 1);
+        const std::size_t quadY1 = std::min(region.y1, heightmap.getHeight() - 1);
+        for(std::size_t i = quadX0; i < quadX1; ++i)
+        {
+            for(std::size_t j = quadY0; j < quadY1; ++j)
             {
-                for(std::size_t j = 0; j < heightmap.getHeight(); ++j)
+                const std::size_t quad[4][2] = {{i, j}, {i, j + 1}, {i + 1, j}, {i + 1, j + 1}};
+                const std::size_t triangles[2][3] = {{0, 1, 2}, {2, 1, 3}};
+                for(const auto& triangle : triangles)
                 {
+                    Point<T, 3> p0 = getPosition(heightmap, verticalScale, quad[triangle[0]][0], quad[triangle[0]][1]);
+                    Point<T, 3> p1 = getPosition(heightmap, verticalScale, quad[triangle[1]][0], quad[triangle[1]][1]);
+                    Point<T, 3> p2 = getPosition(heightmap, verticalScale, quad[triangle[2]][0], quad[triangle[2]][1]);
 
-                    std::size_t index = j * heightmap.getWidth() + i;
+                    Vector<T, 3> v0(p0 - p1);
+                    Vector<T, 3> v1(p0 - p2);
 
-                    /// Positions
-                    _vertexData[DATA_COUNT * index + 0] = (T)i - (T)((T)heightmap.getWidth() / 2.0f);
-                    _vertexData[DATA_COUNT * index + 1] = -static_cast<T>(heightmap[index * 4]) / 255.0f * verticalScale;
-                    _vertexData[DATA_COUNT * index + 2] = (T)j - (T)((T)heightmap.getHeight() / 2.0f);
+                    Vector<T, 3> normal = cross(v0, v1).normalize();
 
-                    /// Texture Coordinates
-                    _vertexData[DATA_COUNT * index + 3] = static_cast<T>(i) / static_cast<T>(heightmap.getWidth());
-                    _vertexData[DATA_COUNT * index + 4] = static_cast<T>(j) / static_cast<T>(heightmap.getHeight());
+                    for(std::size_t corner : triangle)
+                    {
+                        const std::size_t x = quad[corner][0];
+                        const std::size_t y = quad[corner][1];
+                        if(x < region.x0 || x >= region.x1 || y < region.y0 || y >= region.y1)
+                        {
+                            continue;
+                        }
+                        T* vertex = &vertices[DATA_COUNT * ((y - region.y0) * regionWidth + (x - region.x0))];
+                        vertex[5] += normal[0];
+                        vertex[6] += normal[1];
+                        vertex[7] += normal[2];
+                    }
                 }
             }
+        }
+    }
 
-            for(std::size_t i = 0; i < _indexData.size(); i += 3)
-            {
-                Point3F p0(_vertexData[DATA_COUNT * _indexData[i + 0] + 0], _vertexData[DATA_COUNT * _indexData[i + 0] + 1], _vertexData[DATA_COUNT * _indexData[i + 0] + 2]);
-                Point3F p1(_vertexData[DATA_COUNT * _indexData[i + 1] + 0], _vertexData[DATA_COUNT * _indexData[i + 1] + 1], _vertexData[DATA_COUNT * _indexData[i + 1] + 2]);
-                Point3F p2(_vertexData[DATA_COUNT * _indexData[i + 2] + 0], _vertexData[DATA_COUNT * _indexData[i + 2] + 1], _vertexData[DATA_COUNT * _indexData[i + 2] + 2]);
-
-                Vector3F v0(p0 - p1);
-                Vector3F v1(p0 - p2);
-
-                Vector3F normal = cross(v0, v1).normalize();
-
-                _vertexData[DATA_COUNT * _indexData[i + 0] + 5] += normal[0];
-                _vertexData[DATA_COUNT * _indexData[i + 0] + 6] += normal[1];
-                _vertexData[DATA_COUNT * _indexData[i + 0] + 7] += normal[2];
+    template<typename T>
+    void Terrain<T>::synchronize()
+    {
+        const Heightmap::Region& dirty = heightmap.getDirtyRegion();
+        if(dirty.isEmpty())
+        {
+            return;
+        }
 
-                _vertexData[DATA_COUNT * _indexData[i + 1] + 5] += normal[0];
-                _vertexData[DATA_COUNT * _indexData[i + 1] + 6] += normal[1];
-                _vertexData[DATA_COUNT * _indexData[i + 1] + 7] += normal[2];
+        /// The normals of the samples bordering the modified ones depend upon the modified positions
+        const Heightmap::Region region
+        {
+            dirty.x0 > 0 ? dirty.x0 - 1 : 0,
+            dirty.y0 > 0 ? dirty.y0 - 1 : 0,
+            std::min(dirty.x1 + 1, heightmap.getWidth()),
+            std::min(dirty.y1 + 1, heightmap.getHeight())
+        };
+        std::vector<T> vertices;
+        buildVertices(heightmap, verticalScale, region, vertices);
 
-                _vertexData[DATA_COUNT * _indexData[i + 2] + 5] += normal[0];
-                _vertexData[DATA_COUNT * _indexData[i + 2] + 6] += normal[1];
-                _vertexData[DATA_COUNT * _indexData[i + 2] + 7] += normal[2];
+        const std::size_t regionWidth = region.x1 - region.x0;
+        if(regionWidth == heightmap.getWidth())
+        {
+            /// Whole rows are contiguous in the buffer
+            vertexData->updateVertexData(DATA_COUNT * region.y0 * regionWidth, vertices.data(), vertices.size());
+        }
+        else
+        {
+            for(std::size_t j = region.y0; j < region.y1; ++j)
+            {
+                vertexData->updateVertexData(DATA_COUNT * (j * heightmap.getWidth() + region.x0), 
+                        &vertices[DATA_COUNT * (j - region.y0) * regionWidth], DATA_COUNT * regionWidth);
             }
+        }
 
-       this->vertexData.reset(new StaticDrawTriangleBuffer<float>(_vertexData));
-       this->indexBuffer.reset(new StaticDrawIndexBuffer<uint32_t>(_indexData));
-
-        this->vertexData->addAttributePointer("position", 3, GL_FLOAT, GL_FALSE, DATA_COUNT * 4, reinterpret_cast<GLvoid*>(0));
-        this->vertexData->addAttributePointer("uv", 2, GL_FLOAT, GL_FALSE, DATA_COUNT * 4, reinterpret_cast<GLvoid*>(12));
-        this->vertexData->addAttributePointer("normal", 3, GL_FLOAT, GL_FALSE, DATA_COUNT * 4, reinterpret_cast<GLvoid*>(20));
+        pyramid.update(heightmap, dirty);
+        heightmap.clearDirtyRegion();
     }
 
     template<typename T>
     void Terrain<T>::render(const Camera& camera)
     {
         this->AbstractSceneGraphNode::render(camera);
-        program.setUniform("ambient_color", ambientLighting.getColor());
-        program.setUniform("sun_position", Tuple4F(0.0f, 100.0f, 1.0f, 1.0f));
-        program.setUniform("sun_color", Tuple4F(1.0f, 1.0f, 0.0f, 1.0f));
-        program.setUniform("offset", (Tuple3F)camera.getPosition());
-        program.setMatrixUniform("projection", camera.getProjection());
-        program.setMatrixUniform("orientation", camera.getOrientation());
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture.handle);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP);
+        synchronize();
+        program.setUniform(detail::AMBIENT_COLOR_UNIFORM, ambientLighting.getColor());
+        GLState::current().setActiveTexture(GL_TEXTURE0);
+        GLState::current().bindTexture(GL_TEXTURE_2D, texture.handle);
+        GLState::current().setTextureParameter(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        GLState::current().setTextureParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        GLState::current().setTextureParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+        GLState::current().setTextureParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+        GLState::current().setTextureParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP);
         this->program.bind();
 
-        this->indexBuffer->bind();
         this->vertexData->bind();
-        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(heightmap.getWidth() * heightmap.getHeight() * 6), GL_UNSIGNED_INT, (GLvoid*)0);
-        this->vertexData->unbind();
+        this->indexBuffer->bind();
+        glEnable(GL_PRIMITIVE_RESTART);
+        glPrimitiveRestartIndex(TerrainIndexer::RESTART_INDEX);
+        glMultiDrawElementsBaseVertex(GL_TRIANGLE_STRIP, &tileCounts[0], indexBuffer->getType(), &tileOffsets[0], static_cast<GLsizei>(tileCounts.size()), &tileBaseVertices[0]);
+        glDisable(GL_PRIMITIVE_RESTART);
         this->indexBuffer->unbind();
+        this->vertexData->unbind();
         this->program.unbind();
 
     }
@@ -117,12 +222,55 @@ namespace midnight
         return heightmap;
     }
 
+    template<typename T>
+    Heightmap& Terrain<T>::getHeightmap()
+    {
+        return heightmap;
+    }
+
     template<typename T>
     bool Terrain<T>::isPickable()
     {
         return true;
     }
     
+    template<typename T>
+    Line<T, 3> Terrain<T>::toHeightmapSpace(const Line<T, 3>& ray) const
+    {
+        /// Inverse of the vertex positions generated by the constructor
+        const T heightScale = static_cast<T>(-255.0f) / verticalScale;
+        return Line<T, 3>(
+            Point<T, 3>(ray.getPoint()[0] + (T)((T)heightmap.getWidth() / 2.0f), 
+                ray.getPoint()[1] * heightScale, 
+                ray.getPoint()[2] + (T)((T)heightmap.getHeight() / 2.0f)),
+            Vector<T, 3>(ray.getVector()[0], ray.getVector()[1] * heightScale, ray.getVector()[2]));
+    }
+    
+    template<typename T>
+    bool Terrain<T>::pick(const Line<T, 3>& ray, HeightmapPyramid::Hit<T>& hit) const
+    {
+        if(!pyramid.intersect(toHeightmapSpace(ray), hit))
+        {
+            return false;
+        }
+        /// The distance along the ray is unaffected by the (affine) change of space
+        for(std::size_t i = 0; i < 3; ++i)
+        {
+            hit.point[i] = ray.getPoint()[i] + ray.getVector()[i] * hit.distance;
+        }
+        /// Normals transform by the inverse-transpose of the vertical scale
+        hit.normal[1] *= static_cast<T>(-255.0f) / verticalScale;
+        hit.normal.normalize();
+        return true;
+    }
+    
+    template<typename T>
+    bool Terrain<T>::isVisible(const Point<T, 3>& from, const Point<T, 3>& to) const
+    {
+        HeightmapPyramid::Hit<T> hit;
+        return !pyramid.intersect(toHeightmapSpace(Line<T, 3>(from, to)), hit, static_cast<T>(1));
+    }
+    
     template<typename T>
     void Terrain<T>::setAmbience(const AmbientLight<float>& ambience)
     {
@@ -130,8 +278,8 @@ namespace midnight
     }
     
     template<typename T>
-    const std::string Terrain<T>::VERTEX_SHADER_SRC = 
-        "#version 130\n\
+    const std::string Terrain<T>::VERTEX_SHADER_SRC = std::string(
+        "#version 130\n") + FRAME_UNIFORM_BLOCK_SRC + "\
         in vec3 position;\n\
         in vec2 uv;\n\
         in vec3 normal;\n\
@@ -140,12 +288,6 @@ namespace midnight
         out vec4 rgba_out;\n\
 \
         uniform vec4 ambient_color;\n\
-        uniform vec4 sun_position;\n\
-        uniform vec4 sun_color;\n\
-\
-        uniform vec3 offset;\n\
-        uniform mat4 projection;\n\
-        uniform mat4 orientation;\n\
 \
         void main()\n\
         {\n\
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace midnight
+{
+
+    inline TerrainIndexer::TerrainIndexer(std::size_t width, std::size_t height)
+    {
+        if(width < 2 || height < 2)
+        {
+            throw IllegalArgumentException("A terrain grid must be at least 2x2 vertices");
+        }
+
+        /// The largest tile-relative index is (rows * width + columns), which must stay below RESTART_INDEX
+        const std::size_t tileRows = (RESTART_INDEX - 1 - TILE_QUADS) / width;
+        if(tileRows == 0)
+        {
+            throw IllegalArgumentException("A terrain grid of width " + std::to_string(width) +
+                    " can not be addressed with 16 bit indices");
+        }
+
+        const std::size_t quadRows = height - 1;
+        const std::size_t quadColumns = width - 1;
+        const uint16_t restart = RESTART_INDEX;
+
+        /// Each row of quads takes two indices per vertex column, plus one restart index between rows
+        indices.reserve(quadRows * (2 * (quadColumns + (quadColumns + TILE_QUADS - 1) / TILE_QUADS) + 1));
+
+        for(std::size_t row0 = 0; row0 < quadRows; row0 += tileRows)
+        {
+            const std::size_t row1 = std::min(row0 + tileRows, quadRows);
+            for(std::size_t column0 = 0; column0 < quadColumns; column0 += TILE_QUADS)
+            {
+                const std::size_t column1 = std::min(column0 + TILE_QUADS, quadColumns);
+                const std::size_t first = indices.size();
+                for(std::size_t row = row0; row < row1; ++row)
+                {
+                    if(row != row0)
+                    {
+                        indices.push_back(restart);
+                    }
+                    const std::size_t top = (row - row0) * width;
+                    for(std::size_t column = 0; column <= column1 - column0; ++column)
+                    {
+                        indices.push_back(static_cast<uint16_t>(top + column));
+                        indices.push_back(static_cast<uint16_t>(top + width + column));
+                    }
+                }
+                tiles.push_back(Tile{first, indices.size() - first, row0 * width + column0});
+            }
+        }
+    }
+
+    inline const std::vector<uint16_t>& TerrainIndexer::getIndices() const noexcept
+    {
+        return indices;
+    }
+
+    inline std::vector<uint16_t>&& TerrainIndexer::releaseIndices() noexcept
+    {
+        return std::move(indices);
+    }
+
+    inline const std::vector<TerrainIndexer::Tile>& TerrainIndexer::getTiles() const noexcept
+    {
+        return tiles;
+    }
+}
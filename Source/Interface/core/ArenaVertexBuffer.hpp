@@ -0,0 +1,185 @@
+#ifndef ARENA_VERTEX_BUFFER_HPP
+#define ARENA_VERTEX_BUFFER_HPP
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BufferArena.hpp"
+#include "Platform.hpp"
+#include "VertexBuffer.hpp"
+
+namespace midnight
+{
+    /**
+     * A VertexBuffer whose data lives in a range of a BufferArena, so that the vertices of many meshes share a
+     * few buffer objects.
+     *
+     * The attribute pointers address the buffer object from its start, so draws must add the base vertex of
+     * the range (see getBaseVertex) to their indices, or to the first vertex of glDrawArrays.  The range is
+     * allocated with the stride of a vertex as its alignment, which keeps the base vertex whole.  As
+     * BufferArena::defragment may move the range, the base vertex must be looked up for every draw; if
+     * setVertexData reallocates the range in another buffer object, the vertex arrays are recorded again.
+     *
+     * The BufferArena must outlive every ArenaVertexBuffer that is allocated from it.
+     *
+     */
+    template<typename T, GLenum PolyType>
+    class ArenaVertexBuffer : public VertexBuffer<T>
+    {
+        static_assert(PolyType == GL_POINTS || PolyType == GL_LINES || PolyType == GL_TRIANGLES || PolyType == GL_QUADS,
+            "Invalid poly type template provided to ArenaVertexBuffer");
+
+        /// The BufferArena that the range is allocated from
+        BufferArena& arena;
+
+        /// The size (in bytes) of a vertex
+        std::size_t stride;
+
+        /// The range that holds the data
+        BufferArena::Handle range;
+
+        /// The number of elements in the range
+        std::size_t count;
+
+        /// The buffer object that the vertex arrays were recorded with
+        GLuint recorded;
+
+        /// A list of attribute pointers that are associated with this buffer
+        std::list<std::unique_ptr<detail::AttributePointerBase>> attributes;
+
+        /// The attribute pointers, as recorded for each program that this buffer has been bound with
+        detail::VertexArrayCache vertexArrays;
+
+        /**
+         * Allocates a range for the provided data and uploads it
+         *
+         */
+        void allocate(const T* data, std::size_t count);
+
+      public:
+
+        /**
+         * Allocates a range of the provided BufferArena and uploads the provided data to it
+         *
+         * @param arena the BufferArena to allocate from
+         *
+         * @param data the data to upload
+         *
+         * @param count the number of elements
+         *
+         * @param stride the size (in bytes) of a vertex
+         *
+         * @throws IllegalArgumentException if there is no data, or stride is 0
+         *
+         * @throws ResourceException if GPU memory could not be allocated
+         *
+         */
+        ArenaVertexBuffer(BufferArena& arena, const T* data, std::size_t count, std::size_t stride);
+
+        ArenaVertexBuffer(BufferArena& arena, const std::vector<T>& data, std::size_t stride);
+
+        ArenaVertexBuffer(const ArenaVertexBuffer&) = delete;
+
+        ArenaVertexBuffer& operator=(const ArenaVertexBuffer&) = delete;
+
+        /**
+         * Retrieves the range of this ArenaVertexBuffer
+         *
+         * @return the Handle of the range
+         *
+         */
+        BufferArena::Handle getRange() const noexcept;
+
+        /**
+         * Retrieves the index of the first vertex of this ArenaVertexBuffer within its buffer object, which
+         * is to be added to the indices of each draw
+         *
+         * @return the base vertex
+         *
+         */
+        GLint getBaseVertex() const noexcept;
+
+        std::size_t vertexCount();
+
+        /**
+         * Replaces the data of this ArenaVertexBuffer, reallocating its range if the size has changed
+         *
+         * @throws BindException if this ArenaVertexBuffer is bound
+         *
+         */
+        void setVertexData(std::vector<T>&& data);
+
+        /**
+         * Replaces the data of this ArenaVertexBuffer, reallocating its range if the size has changed
+         *
+         * @throws BindException if this ArenaVertexBuffer is bound
+         *
+         */
+        void setVertexData(const std::vector<T>& data);
+
+        /**
+         * Replaces a range of the data of this ArenaVertexBuffer, which is uploaded at once
+         *
+         * @throws IllegalArgumentException if the range extends past the end of this ArenaVertexBuffer
+         *
+         */
+        void updateVertexData(std::size_t offset, const T* data, std::size_t count);
+
+        /**
+         * Does nothing, as updates are uploaded at once
+         *
+         */
+        void flush(bool orphan = false);
+
+        void bind();
+
+        void unbind() noexcept;
+
+        void resetAttributes() noexcept;
+
+        void addAttributePointer(const std::string& name,
+            GLint size,
+            GLenum type,
+            GLboolean normalized,
+            GLsizei stride,
+            const GLvoid* offset);
+
+        void addAttributeIPointer(const std::string& name,
+            GLint size,
+            GLenum type,
+            GLsizei stride,
+            const GLvoid* offset);
+
+        void addAttributeLPointer(const std::string& name,
+            GLint size,
+            GLsizei stride,
+            const GLvoid* offset);
+
+        /**
+         * Releases the range of this ArenaVertexBuffer
+         *
+         */
+        ~ArenaVertexBuffer();
+    };
+}
+
+#include "ArenaVertexBuffer.inl"
+
+namespace midnight
+{
+    template<typename T>
+    using ArenaPointBuffer = ArenaVertexBuffer<T, GL_POINTS>;
+
+    template<typename T>
+    using ArenaLineBuffer = ArenaVertexBuffer<T, GL_LINES>;
+
+    template<typename T>
+    using ArenaTriangleBuffer = ArenaVertexBuffer<T, GL_TRIANGLES>;
+
+    template<typename T>
+    using ArenaQuadBuffer = ArenaVertexBuffer<T, GL_QUADS>;
+}
+
+#endif
@@ -0,0 +1,229 @@
+#ifndef BUFFER_ARENA_HPP
+#define BUFFER_ARENA_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "Platform.hpp"
+#include "RangeAllocator.hpp"
+
+namespace midnight
+{
+    /**
+     * Sub-allocates many small buffers (the vertices or indices of meshes and terrain tiles) from a few large
+     * buffer objects, so that they share bindings and may be drawn together by a single multi-draw call.
+     *
+     * Each allocation is identified by a Handle that stays valid until it is released.  The buffer object and
+     * offset of an allocation are looked up through its Handle, as defragment may move it: the offset of a
+     * vertex allocation divided by its stride is the base vertex of its draws, and the offset of an index
+     * allocation is the offset of its indices within the element buffer.
+     *
+     */
+    class BufferArena
+    {
+      public:
+
+        /// Identifies an allocation
+        typedef std::size_t Handle;
+
+      private:
+
+        /**
+         * One buffer object and the allocator of its storage
+         *
+         */
+        struct Arena
+        {
+            GLuint buffer;
+            RangeAllocator allocator;
+        };
+
+        /**
+         * The placement of one allocation, or of a released Handle (whose size is 0)
+         *
+         */
+        struct Allocation
+        {
+            std::size_t arena;
+            std::size_t offset;
+            std::size_t size;
+            std::size_t alignment;
+        };
+
+        /// The usage hint of the buffer objects
+        GLenum usage;
+
+        /// The size of each buffer object (unless a larger allocation calls for a larger one)
+        std::size_t arenaSize;
+
+        std::vector<Arena> arenas;
+
+        /// The allocations, indexed by Handle
+        std::vector<Allocation> allocations;
+
+        /// The Handles that have been released, for reuse
+        std::vector<Handle> releasedHandles;
+
+        /**
+         * Creates a buffer object of the provided size
+         *
+         * @throws ResourceException if GPU memory could not be allocated
+         *
+         */
+        GLuint createBuffer(std::size_t size) const;
+
+        /**
+         * Copies a range of the provided buffer object to a lower offset within it, through the provided scratch
+         * buffer object if the ranges overlap
+         *
+         */
+        void moveWithin(GLuint buffer, std::size_t from, std::size_t to, std::size_t size, GLuint scratch) const;
+
+      public:
+
+        /**
+         * Constructs an empty BufferArena - buffer objects are created as they are needed.  They may be bound
+         * to any target, as vertex and index data alike.
+         *
+         * @param arenaSize the size (in bytes) of each buffer object
+         *
+         * @param usage the usage hint of the buffer objects
+         *
+         * @throws IllegalArgumentException if arenaSize is 0
+         *
+         */
+        explicit BufferArena(std::size_t arenaSize = 64 << 20, GLenum usage = GL_STATIC_DRAW);
+
+        BufferArena(const BufferArena&) = delete;
+
+        BufferArena& operator=(const BufferArena&) = delete;
+
+        /**
+         * Allocates a range of one of the buffer objects, creating a new buffer object if none has room
+         *
+         * @param size the size (in bytes) of the range
+         *
+         * @param alignment the offset of the range is made a multiple of this - the stride of the vertices, or
+         * the size of the indices, that it is to hold
+         *
+         * @return the Handle of the range
+         *
+         * @throws IllegalArgumentException if size or alignment is 0
+         *
+         * @throws ResourceException if GPU memory could not be allocated
+         *
+         */
+        Handle allocate(std::size_t size, std::size_t alignment);
+
+        /**
+         * Releases the range of the provided Handle, which may then be reused
+         *
+         * @param handle the Handle to release
+         *
+         */
+        void release(Handle handle);
+
+        /**
+         * Uploads data to the range of the provided Handle
+         *
+         * @param handle the Handle of the range
+         *
+         * @param data the data to upload
+         *
+         * @param size the number of bytes to upload
+         *
+         * @param offset the offset (in bytes) within the range to upload to
+         *
+         * @throws IllegalArgumentException if the data extends past the end of the range
+         *
+         */
+        void upload(Handle handle, const void* data, std::size_t size, std::size_t offset = 0);
+
+        /**
+         * Moves the allocations of every buffer object to its start, so that its free space is contiguous, and
+         * deletes the buffer objects that are no longer used.  The allocations are moved within their buffer
+         * object with glCopyBufferSubData, which GL executes after the draws that were issued before, so the
+         * buffer object of an allocation never changes.  Allocations whose new range overlaps their old one are
+         * copied through a scratch buffer object as large as the largest of them, which is all the GPU memory
+         * that defragmenting takes.
+         *
+         * @return true if any allocation has moved (and so draws must look up their offsets again), otherwise
+         * false
+         *
+         * @throws ResourceException if GPU memory could not be allocated
+         *
+         */
+        bool defragment();
+
+        /**
+         * Retrieves the buffer object that holds the range of the provided Handle
+         *
+         * @param handle the Handle of the range
+         *
+         * @return the buffer object that holds the range
+         *
+         */
+        GLuint getBuffer(Handle handle) const noexcept;
+
+        /**
+         * Retrieves the offset (in bytes) of the range of the provided Handle within its buffer object
+         *
+         * @param handle the Handle of the range
+         *
+         * @return the offset of the range
+         *
+         */
+        std::size_t getOffset(Handle handle) const noexcept;
+
+        /**
+         * Retrieves the size (in bytes) of the range of the provided Handle
+         *
+         * @param handle the Handle of the range
+         *
+         * @return the size of the range
+         *
+         */
+        std::size_t getSize(Handle handle) const noexcept;
+
+        /**
+         * Retrieves the base vertex of the range of the provided Handle, which was allocated with the provided
+         * stride as its alignment
+         *
+         * @param handle the Handle of the range
+         *
+         * @param stride the size (in bytes) of each vertex
+         *
+         * @return the index of the first vertex of the range, within its buffer object
+         *
+         */
+        GLint getBaseVertex(Handle handle, std::size_t stride) const noexcept;
+
+        /**
+         * Retrieves the number of buffer objects
+         *
+         * @return the number of buffer objects
+         *
+         */
+        std::size_t getArenaCount() const noexcept;
+
+        /**
+         * Retrieves the number of free bytes in the provided buffer object
+         *
+         * @param arena the index of the buffer object
+         *
+         * @return the number of free bytes in the buffer object
+         *
+         */
+        std::size_t getFreeSize(std::size_t arena) const noexcept;
+
+        /**
+         * Deletes every buffer object
+         *
+         */
+        ~BufferArena();
+    };
+}
+
+#include "BufferArena.inl"
+
+#endif
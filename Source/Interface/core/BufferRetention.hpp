@@ -0,0 +1,39 @@
+#ifndef BUFFER_RETENTION_HPP
+#define BUFFER_RETENTION_HPP
+
+#include <type_traits>
+
+#include "Platform.hpp"
+
+namespace midnight
+{
+    /**
+     * What a buffer keeps of its data in system memory once the data has been uploaded.
+     *
+     * <ul>
+     *  <li>Keep retains a full copy, so that updates are coalesced (see DirtyRangeSet) and the buffer may be
+     *  orphaned and respecified from it.</li>
+     *  <li>Discard retains only the number of elements.  Updates are uploaded as they are made.</li>
+     *  <li>Bounds retains the number of elements and the smallest and largest of them (for indices, the range
+     *  to pass to glDrawRangeElements).  Updates are uploaded as they are made, and only widen the bounds.</li>
+     * </ul>
+     *
+     */
+    enum class BufferRetention
+    {
+        Keep,
+        Discard,
+        Bounds
+    };
+
+    namespace detail
+    {
+        /// Static draw buffers are rarely updated, so they do not keep their data by default
+        template<GLenum Usage>
+        struct DefaultRetention : std::integral_constant<BufferRetention, Usage == GL_STATIC_DRAW ? BufferRetention::Discard : BufferRetention::Keep>
+        {
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef DIRTY_RANGE_SET_HPP
+#define DIRTY_RANGE_SET_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "Platform.hpp"
+
+namespace midnight
+{
+    /**
+     * The ranges of a buffer that have been modified since it was last uploaded.
+     *
+     * The ranges are kept sorted and disjoint: a range that overlaps or touches another is merged with it as it
+     * is added, so any number of small edits to the same area cost a single upload.
+     *
+     */
+    class DirtyRangeSet
+    {
+      public:
+
+        /**
+         * A half-open range [first, last) of elements
+         *
+         */
+        struct Range
+        {
+            std::size_t first;
+            std::size_t last;
+        };
+
+      private:
+
+        /// The dirty ranges, in ascending order
+        std::vector<Range> ranges;
+
+      public:
+
+        /**
+         * Marks the provided range as dirty
+         *
+         * @param first the first element of the range
+         *
+         * @param last one past the last element of the range
+         *
+         */
+        void add(std::size_t first, std::size_t last);
+
+        /**
+         * Merges every pair of neighbouring ranges that are separated by no more than the provided number of
+         * elements, trading the upload of the clean elements between them for one upload fewer
+         *
+         * @param gap the largest number of clean elements to absorb
+         *
+         */
+        void coalesce(std::size_t gap);
+
+        /**
+         * Retrieves the dirty ranges
+         *
+         * @return the dirty ranges, in ascending order
+         *
+         */
+        const std::vector<Range>& getRanges() const noexcept;
+
+        /**
+         * Retrieves the number of dirty elements
+         *
+         * @return the total length of the dirty ranges
+         *
+         */
+        std::size_t getSize() const noexcept;
+
+        /**
+         * Determines whether any element is dirty
+         *
+         * @return true if there are no dirty ranges, otherwise false
+         *
+         */
+        bool isEmpty() const noexcept;
+
+        /**
+         * Marks every element as clean
+         *
+         */
+        void clear() noexcept;
+    };
+
+    namespace detail
+    {
+        /// Dirty ranges that are separated by no more than this many bytes are uploaded as one
+        constexpr std::size_t DIRTY_RANGE_GAP = 4096;
+
+        /**
+         * Uploads the dirty ranges of the provided data to the buffer object bound to the provided target, and
+         * marks them clean.
+         *
+         * If orphaning is requested, or more than half of the data is dirty, the whole buffer is respecified
+         * with glBufferData so that the implementation may allocate new storage rather than wait for draws that
+         * still read the old contents.  Otherwise the ranges are coalesced and uploaded with glBufferSubData.
+         *
+         */
+        template<typename T>
+        void uploadDirtyRanges(GLenum target, const std::vector<T>& data, DirtyRangeSet& dirty, GLenum usage, bool orphan);
+    }
+}
+
+#include "DirtyRangeSet.inl"
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef DRAW_COMMAND_BUFFER_HPP
+#define DRAW_COMMAND_BUFFER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "Platform.hpp"
+
+namespace midnight
+{
+    /**
+     * Collects indexed draws that share the same program, vertex array and element buffer, and submits them
+     * together.
+     *
+     * Where ARB_multi_draw_indirect is available the draws are uploaded to a draw indirect buffer and
+     * submitted with a single glMultiDrawElementsIndirect.  Otherwise draws of a single instance are
+     * submitted with glMultiDrawElementsBaseVertex, and instanced draws one at a time - each run of draws of a
+     * single instance is submitted before the instanced draw that follows it, so that the draws are rasterized
+     * in the order that they were added.
+     *
+     * A draw that continues the previous one (the same base vertex and instances, starting at the index
+     * where the previous one ends) is merged into it as it is added.
+     *
+     */
+    class DrawCommandBuffer
+    {
+      public:
+
+        /**
+         * A draw, laid out as glMultiDrawElementsIndirect expects
+         *
+         */
+        struct Command
+        {
+            GLuint count;
+            GLuint instanceCount;
+            GLuint firstIndex;
+            GLint baseVertex;
+            GLuint baseInstance;
+        };
+
+      private:
+
+        /// The implementation supplied handle to the draw indirect buffer, or 0 until it is first needed
+        GLuint handle;
+
+        /// The draws to submit
+        std::vector<Command> commands;
+
+        /// The counts, byte offsets and base vertices of the fallback (retained to avoid reallocating)
+        std::vector<GLsizei> counts;
+        std::vector<const GLvoid*> offsets;
+        std::vector<GLint> baseVertices;
+
+        /**
+         * Submits the draws of a single instance that have been collected by the fallback, with a single
+         * glMultiDrawElementsBaseVertex
+         *
+         */
+        void submitPending(GLenum mode, GLenum type);
+
+      public:
+
+        DrawCommandBuffer();
+
+        DrawCommandBuffer(const DrawCommandBuffer&) = delete;
+
+        DrawCommandBuffer& operator=(const DrawCommandBuffer&) = delete;
+
+        /**
+         * Adds a draw
+         *
+         * @param count the number of indices to draw
+         *
+         * @param firstIndex the position of the first index within the element buffer
+         *
+         * @param baseVertex the value that is added to each index
+         *
+         * @param instanceCount the number of instances to draw
+         *
+         * @param baseInstance the first instance, for instanced attributes
+         *
+         */
+        void add(GLuint count, GLuint firstIndex, GLint baseVertex = 0, GLuint instanceCount = 1, GLuint baseInstance = 0);
+
+        /**
+         * Removes every draw
+         *
+         */
+        void clear() noexcept;
+
+        /**
+         * Retrieves the draws that have been added
+         *
+         * @return the draws, in the order that they were added
+         *
+         */
+        const std::vector<Command>& getCommands() const noexcept;
+
+        /**
+         * Submits every draw, with the bound program, vertex array and element buffer
+         *
+         * @param mode the kind of primitive to draw (GL_TRIANGLES, for instance)
+         *
+         * @param type the type of the indices (GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT)
+         *
+         */
+        void submit(GLenum mode, GLenum type);
+
+        /**
+         * Determines whether the draws are submitted with a single indirect draw call
+         *
+         * @return true if ARB_multi_draw_indirect is available, otherwise false
+         *
+         */
+        static bool isIndirect() noexcept;
+
+        /**
+         * Deletes the draw indirect buffer
+         *
+         */
+        ~DrawCommandBuffer();
+    };
+}
+
+#include "DrawCommandBuffer.inl"
+
+#endif
@@ -0,0 +1,245 @@
+#ifndef GL_STATE_HPP
+#define GL_STATE_HPP
+
+#include <cstdint>
+#include <map>
+#include <utility>
+
+#include "Platform.hpp"
+
+namespace midnight
+{
+    /**
+     * A CPU side mirror of the binding state of the current context: the bound program, vertex array, buffers,
+     * textures and texture parameters.
+     *
+     * Binding through GLState drops every bind that would not change the state, and the bound objects are read
+     * back from the mirror rather than with glGetIntegerv, which stalls the driver.  The mirror is only
+     * queried from the driver after invalidate (or, with MIDNIGHT_RUNTIME_ASSERTIONS, to verify itself).
+     *
+     * The mirror assumes a freshly created context, so every bind and delete of the state it tracks must go
+     * through it - code that binds behind its back (a third party library, for instance) must be followed
+     * by a call to invalidate.  Each thread has its own GLState, just as it has its own current context.
+     *
+     */
+    class GLState
+    {
+      public:
+
+        /**
+         * The number of state changes that were issued to the implementation, and that were elided as
+         * redundant
+         *
+         */
+        struct Counters
+        {
+            std::size_t issued;
+            std::size_t elided;
+        };
+
+      private:
+
+        /// The bound program
+        GLuint program;
+
+        /// The bound vertex array
+        GLuint vertexArray;
+
+        /// The active texture unit
+        GLenum activeTexture;
+
+        /// The buffers bound to each target except GL_ELEMENT_ARRAY_BUFFER, which belongs to the vertex array
+        std::map<GLenum, GLuint> buffers;
+
+        /// The element buffer bound to each vertex array
+        std::map<GLuint, GLuint> elementBuffers;
+
+        /// The textures bound to each texture unit and target
+        std::map<std::pair<GLenum, GLenum>, GLuint> textures;
+
+        /// The integer parameters of each texture - parameters that have not been set through GLState are
+        /// unknown, as their defaults depend on the parameter
+        std::map<std::pair<GLuint, GLenum>, GLint> textureParameters;
+
+        /// The binding that is assumed for the buffers and textures that are absent from the maps: 0 for a
+        /// fresh context, or unknown after invalidate
+        GLuint fallback;
+
+        Counters counters;
+
+        GLState();
+
+        /**
+         * Counts a state change, and reports whether it should be issued
+         *
+         */
+        bool change(bool redundant) noexcept;
+
+        /**
+         * Replaces the provided handle with 0 wherever it is bound, after it is deleted
+         *
+         */
+        void unbindDeleted(std::map<GLenum, GLuint>& bindings, GLuint handle) noexcept;
+
+      public:
+
+        GLState(const GLState&) = delete;
+
+        GLState& operator=(const GLState&) = delete;
+
+        /**
+         * Retrieves the GLState of the calling thread
+         *
+         * @return the GLState of the calling thread
+         *
+         */
+        static GLState& current();
+
+        /**
+         * Makes the provided program current, unless it already is
+         *
+         * @param program the handle of the program
+         *
+         * @return true if glUseProgram was issued (and so may have set an error), otherwise false
+         *
+         */
+        bool useProgram(GLuint program);
+
+        /**
+         * Retrieves the current program
+         *
+         * @return the handle of the current program, or 0 if there is none
+         *
+         */
+        GLuint getProgram();
+
+        /**
+         * Binds the provided vertex array, unless it already is
+         *
+         * @param vertexArray the handle of the vertex array
+         *
+         */
+        void bindVertexArray(GLuint vertexArray);
+
+        /**
+         * Retrieves the bound vertex array
+         *
+         * @return the handle of the bound vertex array
+         *
+         */
+        GLuint getVertexArray();
+
+        /**
+         * Deletes the provided vertex array, which unbinds it if it is bound
+         *
+         * @param vertexArray the handle of the vertex array
+         *
+         */
+        void deleteVertexArray(GLuint vertexArray);
+
+        /**
+         * Binds the provided buffer to the provided target, unless it already is - the GL_ELEMENT_ARRAY_BUFFER
+         * binding is tracked for each vertex array
+         *
+         * @param target the binding point
+         *
+         * @param buffer the handle of the buffer
+         *
+         */
+        void bindBuffer(GLenum target, GLuint buffer);
+
+        /**
+         * Retrieves the buffer that is bound to the provided target
+         *
+         * @param target the binding point
+         *
+         * @return the handle of the bound buffer
+         *
+         */
+        GLuint getBuffer(GLenum target);
+
+        /**
+         * Deletes the provided buffer, which unbinds it from every target that it is bound to
+         *
+         * @param buffer the handle of the buffer
+         *
+         */
+        void deleteBuffer(GLuint buffer);
+
+        /**
+         * Makes the provided texture unit active, unless it already is
+         *
+         * @param unit the texture unit (GL_TEXTURE0, for instance)
+         *
+         */
+        void setActiveTexture(GLenum unit);
+
+        /**
+         * Binds the provided texture to the provided target of the active texture unit, unless it already is
+         *
+         * @param target the binding point
+         *
+         * @param texture the handle of the texture
+         *
+         */
+        void bindTexture(GLenum target, GLuint texture);
+
+        /**
+         * Retrieves the texture that is bound to the provided target of the active texture unit
+         *
+         * @param target the binding point
+         *
+         * @return the handle of the bound texture
+         *
+         */
+        GLuint getTexture(GLenum target);
+
+        /**
+         * Sets an integer parameter of the texture that is bound to the provided target of the active texture
+         * unit, unless it already has that value
+         *
+         * @param target the binding point
+         *
+         * @param name the name of the parameter (GL_TEXTURE_MIN_FILTER, for instance)
+         *
+         * @param value the value of the parameter
+         *
+         */
+        void setTextureParameter(GLenum target, GLenum name, GLint value);
+
+        /**
+         * Deletes the provided texture, which unbinds it from every texture unit that it is bound to
+         *
+         * @param texture the handle of the texture
+         *
+         */
+        void deleteTexture(GLuint texture);
+
+        /**
+         * Forgets the whole mirror, after state was changed without going through GLState.  Each binding is
+         * queried from the implementation the next time that it is read, and issued the next time that it is
+         * set.
+         *
+         */
+        void invalidate() noexcept;
+
+        /**
+         * Retrieves the number of state changes that were issued and elided since the counters were last
+         * reset (which the render loop should do once per frame)
+         *
+         * @return the counters
+         *
+         */
+        const Counters& getCounters() const noexcept;
+
+        /**
+         * Resets the counters to zero
+         *
+         */
+        void resetCounters() noexcept;
+    };
+}
+
+#include "GLState.inl"
+
+#endif
@@ -1,18 +1,56 @@
 #ifndef INDEX_BUFFER_HPP
 #define INDEX_BUFFER_HPP
 
+#include <cstdint>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "BufferArena.hpp"
+#include "BufferRetention.hpp"
+#include "DirtyRangeSet.hpp"
 #include "Platform.hpp"
 
 namespace midnight
 {
-    template<typename T, GLenum Usage>
+    namespace detail
+    {
+        /// Maps an index type to its OpenGL element type (only unsigned 8, 16 and 32-bit indices are valid)
+        template<typename T>
+        struct IndexType : std::integral_constant<GLenum, 0>
+        {
+        };
+
+        template<>
+        struct IndexType<uint8_t> : std::integral_constant<GLenum, GL_UNSIGNED_BYTE>
+        {
+        };
+
+        template<>
+        struct IndexType<uint16_t> : std::integral_constant<GLenum, GL_UNSIGNED_SHORT>
+        {
+        };
+
+        template<>
+        struct IndexType<uint32_t> : std::integral_constant<GLenum, GL_UNSIGNED_INT>
+        {
+        };
+    }
+
+    /**
+     * An index buffer of a fixed width.
+     * 
+     * What is kept of the indices once they are uploaded is chosen by the Retention template (see 
+     * BufferRetention) - static draw IndexBuffers discard them by default.
+     * 
+     */
+    template<typename T, GLenum Usage, BufferRetention Retention = detail::DefaultRetention<Usage>::value>
     class IndexBuffer
     {
         static_assert(std::is_integral<T>::value, "Only integral types may be used to instantiate an IndexBuffer template");
 
+        static_assert(detail::IndexType<T>::value != 0, "Only uint8_t, uint16_t and uint32_t may be used to instantiate an IndexBuffer template");
+
         static_assert(Usage == GL_STREAM_DRAW ||
             Usage == GL_STREAM_READ ||
             Usage == GL_STREAM_COPY ||
@@ -26,28 +64,382 @@ namespace midnight
 
         GLuint handle;
         
+        /// The indices, if they are kept (see BufferRetention)
         std::vector<T> data;
         
+        /// The ranges of data that have been updated since they were last uploaded
+        DirtyRangeSet dirty;
+        
+        /// The number of indices
+        std::size_t count;
+        
+        /// The smallest and largest index (unless the indices are discarded)
+        T minIndex;
+        T maxIndex;
+        
+        /**
+         * Creates the buffer object and uploads the provided indices to it
+         * 
+         */
+        void upload(const std::vector<T>& indices);
+        
       public:
         
         IndexBuffer(const std::vector<T>& data);
         
         IndexBuffer(std::vector<T>&& data);
         
+        /**
+         * Replaces a range of the indices of this IndexBuffer without reallocating it
+         * 
+         * If the indices are kept, the upload is deferred until this IndexBuffer is next flushed (or bound), so 
+         * that many small updates coalesce into few uploads.  Otherwise the indices are uploaded at once.
+         * 
+         * @param offset the first index to replace
+         * 
+         * @param indices the replacement indices
+         * 
+         * @param count the number of indices to replace
+         * 
+         * @throws IllegalArgumentException if the range extends past the end of this IndexBuffer
+         * 
+         */
+        void updateIndices(std::size_t offset, const T* indices, std::size_t count);
+        
+        /**
+         * Uploads every update that is pending to the GPU (this is done by bind as well)
+         * 
+         * @param orphan whether to respecify the whole buffer rather than only the updated ranges, so that the 
+         * implementation need not wait for draws that are still reading it (only if the indices are kept, as 
+         * there is nothing to respecify it from otherwise)
+         * 
+         */
+        void flush(bool orphan = false);
+        
+        /**
+         * Retrieves the number of indices in this IndexBuffer
+         * 
+         * @return the number of indices in this IndexBuffer
+         * 
+         */
+        std::size_t getCount() const noexcept
+        {
+            return count;
+        }
+        
+        /**
+         * Retrieves the smallest index of this IndexBuffer, the start of the range to pass to 
+         * glDrawRangeElements - after updates this may be smaller than the actual smallest index
+         * 
+         * @return the smallest index of this IndexBuffer
+         * 
+         */
+        T getMinIndex() const noexcept
+        {
+            static_assert(Retention != BufferRetention::Discard, "The bounds of discarded indices are not kept");
+            return minIndex;
+        }
+        
+        /**
+         * Retrieves the largest index of this IndexBuffer, the end of the range to pass to 
+         * glDrawRangeElements - after updates this may be larger than the actual largest index
+         * 
+         * @return the largest index of this IndexBuffer
+         * 
+         */
+        T getMaxIndex() const noexcept
+        {
+            static_assert(Retention != BufferRetention::Discard, "The bounds of discarded indices are not kept");
+            return maxIndex;
+        }
+        
+        /**
+         * Binds this IndexBuffer to the vertex array that is bound, which records it - so after the first draw with 
+         * that vertex array, the bind is elided
+         * 
+         * @throws BindException if there is currently no program bound to the implementation
+         * 
+         */
         void bind();
         
+        /**
+         * Unbinds this IndexBuffer, unless a vertex array is bound (whose element buffer it is left as)
+         * 
+         */
         void unbind();
         
+        /**
+         * Retrieves the OpenGL type of the indices of this IndexBuffer, to pass to the draw call
+         * 
+         * @return GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+         * 
+         */
+        constexpr GLenum getType() const noexcept
+        {
+            return detail::IndexType<T>::value;
+        }
+        
         ~IndexBuffer();
-    };    
+    };
+    
+    /**
+     * An index buffer whose width is chosen from its contents.
+     * 
+     * The largest index is found upon construction and the indices are narrowed to the smallest of 8, 16 or 
+     * 32 bits that can hold it, so that a mesh of fewer than 65536 vertices uses half (or a quarter) of the 
+     * memory and bandwidth of 32-bit indices.  The chosen type must be passed to the draw call (see getType).
+     * 
+     * Unlike IndexBuffer, no copy of the indices is retained.
+     * 
+     */
+    template<GLenum Usage>
+    class AdaptiveIndexBuffer
+    {
+        static_assert(Usage == GL_STREAM_DRAW ||
+            Usage == GL_STREAM_READ ||
+            Usage == GL_STREAM_COPY ||
+            Usage == GL_STATIC_DRAW ||
+            Usage == GL_STATIC_READ ||
+            Usage == GL_STATIC_COPY ||
+            Usage == GL_DYNAMIC_DRAW ||
+            Usage == GL_DYNAMIC_READ ||
+            Usage == GL_DYNAMIC_COPY,
+            "Invalid intended usage template provided to AdaptiveIndexBuffer");
+        
+        GLuint handle;
+        
+        /// The OpenGL type of the indices
+        GLenum type;
+        
+        /// The number of indices
+        std::size_t count;
+        
+        /**
+         * Narrows the provided lists of indices to U as they are written to the buffer object
+         * 
+         */
+        template<typename U, typename S>
+        void upload(const std::vector<std::pair<const S*, std::size_t>>& lists);
+        
+      public:
+        
+        /**
+         * Selects the narrowest index type that can address the provided index
+         * 
+         * @param maxIndex the largest index to store
+         * 
+         * @return GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+         * 
+         * @throws IllegalArgumentException if maxIndex does not fit in 32 bits
+         * 
+         */
+        static GLenum selectType(std::size_t maxIndex);
+        
+        /**
+         * Retrieves the size (in bytes) of an index of the provided type
+         * 
+         * @param type GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+         * 
+         * @return the size of an index of the provided type
+         * 
+         */
+        static constexpr std::size_t sizeOf(GLenum type) noexcept
+        {
+            return type == GL_UNSIGNED_BYTE ? 1 : type == GL_UNSIGNED_SHORT ? 2 : 4;
+        }
+        
+        /**
+         * Uploads the provided indices at the narrowest sufficient width
+         * 
+         * @param indices the indices to upload
+         * 
+         * @param count the number of indices
+         * 
+         * @throws IllegalArgumentException if an index does not fit in 32 bits
+         * 
+         * @throws ResourceException if GPU memory could not be allocated
+         * 
+         */
+        template<typename S>
+        AdaptiveIndexBuffer(const S* indices, std::size_t count);
+        
+        template<typename S>
+        explicit AdaptiveIndexBuffer(const std::vector<S>& indices);
+        
+        /**
+         * Uploads the provided lists of indices one after another, at the narrowest width that suffices for all 
+         * of them - so the sub-meshes of a mesh share an index buffer without first being concatenated
+         * 
+         * @param lists the lists of indices to upload, as pairs of the first index and the number of indices
+         * 
+         * @throws IllegalArgumentException if an index does not fit in 32 bits
+         * 
+         * @throws ResourceException if GPU memory could not be allocated
+         * 
+         */
+        template<typename S>
+        explicit AdaptiveIndexBuffer(const std::vector<std::pair<const S*, std::size_t>>& lists);
+        
+        AdaptiveIndexBuffer(const AdaptiveIndexBuffer&) = delete;
+        
+        AdaptiveIndexBuffer& operator=(const AdaptiveIndexBuffer&) = delete;
+        
+        /**
+         * Binds this AdaptiveIndexBuffer to the vertex array that is bound, which records it - so after the first draw with 
+         * that vertex array, the bind is elided
+         * 
+         * @throws BindException if there is currently no program bound to the implementation
+         * 
+         */
+        void bind();
+        
+        /**
+         * Unbinds this AdaptiveIndexBuffer, unless a vertex array is bound (whose element buffer it is left as)
+         * 
+         */
+        void unbind();
+        
+        /**
+         * Retrieves the OpenGL type of the indices of this AdaptiveIndexBuffer, to pass to the draw call
+         * 
+         * @return GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+         * 
+         */
+        GLenum getType() const noexcept;
+        
+        /**
+         * Retrieves the number of indices in this AdaptiveIndexBuffer
+         * 
+         * @return the number of indices in this AdaptiveIndexBuffer
+         * 
+         */
+        std::size_t getCount() const noexcept;
+        
+        ~AdaptiveIndexBuffer();
+    };
+    
+    /**
+     * An index buffer whose indices live in a range of a BufferArena, so that the indices of many meshes share 
+     * a few buffer objects.
+     * 
+     * Like AdaptiveIndexBuffer, the indices are narrowed to the smallest sufficient width (and the range is 
+     * aligned to it).  Draws must start from the first index of the range (see getFirstIndex), which is looked 
+     * up for every draw as BufferArena::defragment may move it.
+     * 
+     * The BufferArena must outlive every ArenaIndexBuffer that is allocated from it.
+     * 
+     */
+    class ArenaIndexBuffer
+    {
+        /// The BufferArena that the range is allocated from
+        BufferArena& arena;
+        
+        /// The range that holds the indices
+        BufferArena::Handle range;
+        
+        /// The OpenGL type of the indices
+        GLenum type;
+        
+        /// The number of indices
+        std::size_t count;
+        
+        /**
+         * Narrows the provided indices to U, and allocates a range for them and uploads them
+         * 
+         */
+        template<typename U, typename S>
+        void upload(const S* indices);
+        
+      public:
+        
+        /**
+         * Allocates a range of the provided BufferArena and uploads the provided indices to it, at the 
+         * narrowest sufficient width
+         * 
+         * @param arena the BufferArena to allocate from
+         * 
+         * @param indices the indices to upload
+         * 
+         * @param count the number of indices
+         * 
+         * @throws IllegalArgumentException if there are no indices, or an index does not fit in 32 bits
+         * 
+         * @throws ResourceException if GPU memory could not be allocated
+         * 
+         */
+        template<typename S>
+        ArenaIndexBuffer(BufferArena& arena, const S* indices, std::size_t count);
+        
+        template<typename S>
+        ArenaIndexBuffer(BufferArena& arena, const std::vector<S>& indices);
+        
+        ArenaIndexBuffer(const ArenaIndexBuffer&) = delete;
+        
+        ArenaIndexBuffer& operator=(const ArenaIndexBuffer&) = delete;
+        
+        /**
+         * Retrieves the range of this ArenaIndexBuffer
+         * 
+         * @return the Handle of the range
+         * 
+         */
+        BufferArena::Handle getRange() const noexcept;
+        
+        /**
+         * Retrieves the position of the first index of this ArenaIndexBuffer within its buffer object, which 
+         * is to be added to the first index of each draw
+         * 
+         * @return the first index
+         * 
+         */
+        std::size_t getFirstIndex() const noexcept;
+        
+        /**
+         * Binds the buffer object of this ArenaIndexBuffer to the vertex array that is bound
+         * 
+         * @throws BindException if there is currently no program bound to the implementation
+         * 
+         */
+        void bind();
+        
+        /**
+         * Unbinds this ArenaIndexBuffer, unless a vertex array is bound (whose element buffer it is left as)
+         * 
+         */
+        void unbind();
+        
+        /**
+         * Retrieves the OpenGL type of the indices of this ArenaIndexBuffer, to pass to the draw call
+         * 
+         * @return GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+         * 
+         */
+        GLenum getType() const noexcept;
+        
+        /**
+         * Retrieves the number of indices in this ArenaIndexBuffer
+         * 
+         * @return the number of indices in this ArenaIndexBuffer
+         * 
+         */
+        std::size_t getCount() const noexcept;
+        
+        /**
+         * Releases the range of this ArenaIndexBuffer
+         * 
+         */
+        ~ArenaIndexBuffer();
+    };
 }
 
 #include "IndexBuffer.inl"
 
 namespace midnight
 {
-    template<typename T>
-    using StaticDrawIndexBuffer = IndexBuffer<T, GL_STATIC_DRAW>;
+    template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_STATIC_DRAW>::value>
+    using StaticDrawIndexBuffer = IndexBuffer<T, GL_STATIC_DRAW, Retention>;
+    
+    using StaticDrawAdaptiveIndexBuffer = AdaptiveIndexBuffer<GL_STATIC_DRAW>;
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,115 @@
+#ifndef RANGE_ALLOCATOR_HPP
+#define RANGE_ALLOCATOR_HPP
+
+#include <cstdint>
+#include <map>
+
+namespace midnight
+{
+    /**
+     * Carves a range of a fixed capacity (such as a buffer object) into aligned sub-ranges.
+     *
+     * The free ranges are kept both by offset, so that a released range is merged with its free neighbours,
+     * and by size, so that each allocation takes the smallest free range that it fits (best fit), which keeps
+     * the large free ranges intact for large allocations.  Both operations take logarithmic time.
+     *
+     */
+    class RangeAllocator
+    {
+        /// The capacity of the range
+        std::size_t capacity;
+
+        /// The free ranges, by offset
+        std::map<std::size_t, std::size_t> freeByOffset;
+
+        /// The free ranges, by size
+        std::multimap<std::size_t, std::size_t> freeBySize;
+
+        /// The number of free bytes
+        std::size_t freeSize;
+
+        /**
+         * Adds the provided range to the free ranges, without merging it
+         *
+         */
+        void insertFree(std::size_t offset, std::size_t size);
+
+        /**
+         * Removes the free range at the provided offset
+         *
+         */
+        void eraseFree(std::map<std::size_t, std::size_t>::iterator range);
+
+      public:
+
+        /**
+         * Constructs a RangeAllocator over [0, capacity), all of which is free
+         *
+         * @param capacity the capacity of the range
+         *
+         */
+        explicit RangeAllocator(std::size_t capacity);
+
+        /**
+         * Allocates a sub-range
+         *
+         * @param size the size of the sub-range
+         *
+         * @param alignment the offset of the sub-range is made a multiple of this
+         *
+         * @param offset receives the offset of the sub-range
+         *
+         * @return true if the sub-range was allocated, or false if no free range can hold it
+         *
+         * @throws IllegalArgumentException if size or alignment is 0
+         *
+         */
+        bool allocate(std::size_t size, std::size_t alignment, std::size_t& offset);
+
+        /**
+         * Releases a sub-range that was allocated by this RangeAllocator
+         *
+         * @param offset the offset of the sub-range
+         *
+         * @param size the size of the sub-range
+         *
+         */
+        void release(std::size_t offset, std::size_t size);
+
+        /**
+         * Retrieves the capacity of this RangeAllocator
+         *
+         * @return the capacity of this RangeAllocator
+         *
+         */
+        std::size_t getCapacity() const noexcept;
+
+        /**
+         * Retrieves the number of free bytes, in every free range
+         *
+         * @return the number of free bytes
+         *
+         */
+        std::size_t getFreeSize() const noexcept;
+
+        /**
+         * Retrieves the size of the largest free range, the largest allocation that is sure to succeed
+         *
+         * @return the size of the largest free range
+         *
+         */
+        std::size_t getLargestFreeSize() const noexcept;
+
+        /**
+         * Retrieves the number of free ranges, a measure of fragmentation
+         *
+         * @return the number of free ranges
+         *
+         */
+        std::size_t getFreeRangeCount() const noexcept;
+    };
+}
+
+#include "RangeAllocator.inl"
+
+#endif
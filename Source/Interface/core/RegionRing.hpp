@@ -0,0 +1,120 @@
+#ifndef REGION_RING_HPP
+#define REGION_RING_HPP
+
+#include <cstdint>
+
+namespace midnight
+{
+    /**
+     * Places writes into a ring of equally sized regions, one region per frame in flight (see
+     * StreamingVertexBuffer).  Writes are placed one after another within the current region, and the ring only
+     * moves on to the next region when it is told to - a region is never left while draws that read it may
+     * still be issued.
+     *
+     * Offsets are in elements from the start of the ring, and are not tied to any buffer object.
+     *
+     */
+    class RegionRing
+    {
+        /// The number of elements in each region
+        std::size_t regionCapacity;
+
+        /// The number of regions
+        std::size_t regionCount;
+
+        /// The region that is currently written to
+        std::size_t region;
+
+        /// The next free element of the current region, relative to its start
+        std::size_t cursor;
+
+      public:
+
+        /**
+         * Constructs a RegionRing that starts at the first region
+         *
+         * @param regionCapacity the number of elements in each region
+         *
+         * @param regionCount the number of regions
+         *
+         * @throws IllegalArgumentException if regionCapacity is 0, or regionCount is less than 2
+         *
+         */
+        RegionRing(std::size_t regionCapacity, std::size_t regionCount);
+
+        /**
+         * Places a write after the previous one in the current region
+         *
+         * @param count the number of elements of the write
+         *
+         * @param alignment the offset of the write is made a multiple of this
+         *
+         * @param offset receives the offset of the write
+         *
+         * @return true if the write was placed, or false if what remains of the current region can not hold it
+         *
+         * @throws IllegalArgumentException if alignment is 0
+         *
+         */
+        bool allocate(std::size_t count, std::size_t alignment, std::size_t& offset);
+
+        /**
+         * Moves on to the next region (wrapping around to the first), which starts out empty
+         *
+         */
+        void advance() noexcept;
+
+        /**
+         * Enlarges every region to hold at least the provided number of elements (and at least double its
+         * previous size), and starts over at the first region.  Every previous write is discarded.
+         *
+         * @param required the number of elements that each region must hold
+         *
+         */
+        void grow(std::size_t required) noexcept;
+
+        /**
+         * Retrieves the region that is currently written to
+         *
+         * @return the index of the current region
+         *
+         */
+        std::size_t getRegion() const noexcept;
+
+        /**
+         * Retrieves the number of elements in each region
+         *
+         * @return the number of elements in each region
+         *
+         */
+        std::size_t getRegionCapacity() const noexcept;
+
+        /**
+         * Retrieves the number of regions
+         *
+         * @return the number of regions
+         *
+         */
+        std::size_t getRegionCount() const noexcept;
+
+        /**
+         * Retrieves the number of elements in the whole ring
+         *
+         * @return the number of elements in every region
+         *
+         */
+        std::size_t getCapacity() const noexcept;
+
+        /**
+         * Determines whether nothing has been written to the current region since the ring moved on to it
+         *
+         * @return true if the current region is empty, otherwise false
+         *
+         */
+        bool isRegionEmpty() const noexcept;
+    };
+}
+
+#include "RegionRing.inl"
+
+#endif
@@ -0,0 +1,226 @@
+#ifndef STREAMING_VERTEX_BUFFER_HPP
+#define STREAMING_VERTEX_BUFFER_HPP
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Platform.hpp"
+#include "RegionRing.hpp"
+#include "VertexBuffer.hpp"
+
+namespace midnight
+{
+    /**
+     * A VertexBuffer for data that is rewritten every frame, such as particles and debug geometry.
+     *
+     * The buffer object is allocated once, as a ring of regions (one per frame in flight, see RegionRing).
+     * Each write is placed after the previous one within the current region, and only finishFrame fences the
+     * region and moves on to the next, waiting for the GPU to finish with it only if it is still in use - so a
+     * region is never reused while a draw that reads it may still be issued.  Where ARB_buffer_storage is
+     * available the ring is mapped persistently and coherently, so writes go straight into GPU visible memory;
+     * otherwise they are staged and uploaded with glBufferSubData when the buffer is bound, and the
+     * implementation orders those uploads after the draws that read the region before.
+     *
+     * As successive writes land at different places in the ring, they must be drawn from getOffset (the
+     * first argument of glDrawArrays, or the base vertex of glDrawElementsBaseVertex) rather than from 0.
+     *
+     */
+    template<typename T, GLenum PolyType>
+    class StreamingVertexBuffer : public VertexBuffer<T>
+    {
+        static_assert(PolyType == GL_POINTS || PolyType == GL_LINES || PolyType == GL_TRIANGLES || PolyType == GL_QUADS,
+            "Invalid poly type template provided to StreamingVertexBuffer");
+
+        /// The implementation supplied handle to this buffer object
+        GLuint handle;
+
+        /// The persistent mapping of the ring, or nullptr if writes are staged
+        T* mapping;
+
+        /// The staged writes (when the ring is not mapped), as large as the ring
+        std::vector<T> staging;
+
+        /// The staged range [stagedFirst, stagedLast) of the ring that has yet to be uploaded
+        std::size_t stagedFirst;
+        std::size_t stagedLast;
+
+        /// The placement of writes into the regions of the ring
+        RegionRing ring;
+
+        /// The fence that follows the last use of each region, or nullptr if it is not in use (or the ring is
+        /// not mapped)
+        std::vector<GLsync> fences;
+
+        /// The latest write, as an element offset into the ring and a number of elements
+        std::size_t offset;
+        std::size_t count;
+
+        /// A list of attribute pointers that are associated with this buffer object
+        std::list<std::unique_ptr<detail::AttributePointerBase>> attributes;
+
+        /// The attribute pointers, as recorded for each program that this buffer object has been bound with
+        detail::VertexArrayCache vertexArrays;
+
+        /**
+         * Creates the buffer object of the ring (and maps it, if persistent mapping is available)
+         *
+         */
+        void allocateRing();
+
+        /**
+         * Deletes the buffer object of the ring and the fences of its regions
+         *
+         */
+        void releaseRing() noexcept;
+
+        /**
+         * Waits for the GPU to finish with the current region
+         *
+         */
+        void acquireRegion();
+
+      public:
+
+        /**
+         * Allocates a ring of the provided number of regions
+         *
+         * @param regionCapacity the number of elements that may be written to each region (the largest
+         * amount that is expected to be written in one frame)
+         *
+         * @param regionCount the number of regions (the number of frames that may be in flight, plus one)
+         *
+         * @throws IllegalArgumentException if regionCapacity is 0, or regionCount is less than 2
+         *
+         * @throws ResourceException if GPU memory could not be allocated
+         *
+         */
+        explicit StreamingVertexBuffer(std::size_t regionCapacity, std::size_t regionCount = 3);
+
+        StreamingVertexBuffer(const StreamingVertexBuffer&) = delete;
+
+        StreamingVertexBuffer& operator=(const StreamingVertexBuffer&) = delete;
+
+        /**
+         * Reserves space for the provided number of elements in the current region.  The returned memory must
+         * be filled before the buffer is next bound, and becomes the latest write.
+         *
+         * If the write exceeds the capacity of a region, and nothing has been written to the current region
+         * yet, the ring is reallocated with every region large enough to hold it.
+         *
+         * @param count the number of elements to reserve
+         *
+         * @param alignment the element offset of the write is made a multiple of this (the number of elements
+         * per vertex, when T is a component type)
+         *
+         * @return the memory to write the elements to
+         *
+         * @throws IllegalArgumentException if alignment is 0
+         *
+         * @throws ResourceException if what remains of the current region can not hold the write (finishFrame
+         * must be called first), or if GPU memory could not be allocated
+         *
+         */
+        T* allocate(std::size_t count, std::size_t alignment = 1);
+
+        /**
+         * Fences the current region, after the draws that read from it have been issued, and moves on to the
+         * next region.  This should be called once per frame.
+         *
+         */
+        void finishFrame();
+
+        /**
+         * Retrieves the element offset of the latest write into this StreamingVertexBuffer
+         *
+         * @return the element offset of the latest write
+         *
+         */
+        std::size_t getOffset() const noexcept;
+
+        /**
+         * Retrieves the number of vertices of the latest write into this StreamingVertexBuffer
+         *
+         * @return the number of vertices of the latest write
+         *
+         */
+        std::size_t vertexCount();
+
+        /**
+         * Writes the provided data to this StreamingVertexBuffer, without reallocating its buffer object
+         *
+         * @param data the new data
+         *
+         */
+        void setVertexData(std::vector<T>&& data);
+
+        /**
+         * Writes the provided data to this StreamingVertexBuffer, without reallocating its buffer object
+         *
+         * @param data the new data
+         *
+         */
+        void setVertexData(const std::vector<T>& data);
+
+        /**
+         * Replaces a range of the latest write, which must not yet have been drawn
+         *
+         * @throws IllegalArgumentException if the range extends past the end of the latest write
+         *
+         */
+        void updateVertexData(std::size_t offset, const T* data, std::size_t count);
+
+        /**
+         * Uploads the staged writes, if writes are staged - orphaning does not apply, as the ring already
+         * avoids writing to regions that are in use
+         *
+         */
+        void flush(bool orphan = false);
+
+        void bind();
+
+        void unbind() noexcept;
+
+        void resetAttributes() noexcept;
+
+        void addAttributePointer(const std::string& name,
+            GLint size,
+            GLenum type,
+            GLboolean normalized,
+            GLsizei stride,
+            const GLvoid* offset);
+
+        void addAttributeIPointer(const std::string& name,
+            GLint size,
+            GLenum type,
+            GLsizei stride,
+            const GLvoid* offset);
+
+        void addAttributeLPointer(const std::string& name,
+            GLint size,
+            GLsizei stride,
+            const GLvoid* offset);
+
+        ~StreamingVertexBuffer();
+    };
+}
+
+#include "StreamingVertexBuffer.inl"
+
+namespace midnight
+{
+    template<typename T>
+    using StreamingPointBuffer = StreamingVertexBuffer<T, GL_POINTS>;
+
+    template<typename T>
+    using StreamingLineBuffer = StreamingVertexBuffer<T, GL_LINES>;
+
+    template<typename T>
+    using StreamingTriangleBuffer = StreamingVertexBuffer<T, GL_TRIANGLES>;
+
+    template<typename T>
+    using StreamingQuadBuffer = StreamingVertexBuffer<T, GL_QUADS>;
+}
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef UPLOAD_QUEUE_HPP
+#define UPLOAD_QUEUE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace midnight
+{
+    /**
+     * Retrieves the number of bytes that the provided prepared data will upload, which is what the byte budget
+     * of an UploadQueue is spent on.  Data of other types counts for nothing (but is still bound by the time
+     * budget) unless an overload is provided for it.
+     *
+     */
+    template<typename T>
+    std::size_t uploadSize(const std::vector<T>& data) noexcept;
+
+    template<typename T>
+    std::size_t uploadSize(const T& data) noexcept;
+
+    /**
+     * Moves the creation of GPU resources off the critical path of the frame.
+     *
+     * Each submission is split into a prepare step, which builds the data to upload (decoding a file,
+     * generating and interleaving vertices, indexing terrain) on one of the worker threads of the queue, and an
+     * upload step, which creates the GPU resources from the prepared data on the GL thread.  The GL thread
+     * calls drain once per frame, which runs the upload steps whose data is ready until the byte or time
+     * budget of the frame is spent, so that streaming new content costs a bounded slice of each frame rather
+     * than a hitch.
+     *
+     * The result of each upload step is delivered through the returned future, so a node may be added to the
+     * Scene once it is ready (or the upload step may add it itself).  An exception thrown by either step is
+     * delivered through the future as well.
+     *
+     * For example, a MeshNode may be streamed in with
+     *
+     *     auto node = queue.submit([path]{ return PreparedMesh(loadMesh(path)); },
+     *         [](PreparedMesh&& mesh){ return std::make_shared<MeshNode>(std::move(mesh)); });
+     *
+     * which loads, interleaves and concatenates the Mesh on a worker thread, and leaves only the upload to the GL 
+     * thread (a Terrain is streamed in alike, by constructing its PreparedTerrain from files on the worker).
+     *
+     */
+    class UploadQueue
+    {
+        /**
+         * A type erased submission
+         *
+         */
+        struct Job
+        {
+            /// Prepares the data on a worker thread and returns the number of bytes to upload
+            std::function<std::size_t()> prepare;
+
+            /// Uploads the prepared data on the GL thread
+            std::function<void()> upload;
+
+            /// Delivers an exception thrown by prepare
+            std::function<void(std::exception_ptr)> fail;
+
+            /// The number of bytes to upload, once prepared
+            std::size_t bytes;
+        };
+
+        std::mutex mutex;
+
+        /// Signalled when a job is submitted, and when the queue is destroyed
+        std::condition_variable submitted;
+
+        /// Signalled when a job has been prepared (or has failed to be)
+        std::condition_variable prepared;
+
+        /// The jobs that await preparation, in order of submission
+        std::deque<Job> pending;
+
+        /// The jobs that await upload, in order of preparation
+        std::deque<Job> ready;
+
+        /// The number of jobs that are being prepared
+        std::size_t preparing;
+
+        bool stopping;
+
+        std::vector<std::thread> workers;
+
+        /**
+         * Prepares jobs until the queue is destroyed
+         *
+         */
+        void work();
+
+        /**
+         * Submits a type erased job
+         *
+         */
+        void submit(Job&& job);
+
+      public:
+
+        /**
+         * Constructs an UploadQueue and starts its worker threads
+         *
+         * @param threadCount the number of worker threads, or 0 to use one fewer than the number of hardware
+         * threads (leaving one to the GL thread)
+         *
+         */
+        explicit UploadQueue(std::size_t threadCount = 0);
+
+        UploadQueue(const UploadQueue&) = delete;
+
+        UploadQueue& operator=(const UploadQueue&) = delete;
+
+        /**
+         * Submits data to be prepared on a worker thread and then uploaded on the GL thread
+         *
+         * @param prepare a callable that takes no arguments and returns the data to upload - it must not make
+         * any GL call
+         *
+         * @param upload a callable that takes the prepared data (as an rvalue) and creates the GPU resources
+         * from it - it is invoked by drain, on the GL thread
+         *
+         * @return the future result of upload
+         *
+         */
+        template<typename Prepare, typename Upload>
+        std::future<typename std::result_of<Upload(typename std::result_of<Prepare()>::type&&)>::type> submit(Prepare prepare, Upload upload);
+
+        /**
+         * Runs the upload steps whose data is ready, in the order that it became ready, until the provided
+         * budget is spent.  At least one upload step is run (if any is ready) so that data larger than the
+         * budget still makes progress.  This must be called on the GL thread, usually once per frame.
+         *
+         * @param byteBudget the number of bytes that may be uploaded
+         *
+         * @param timeBudget the time that may be spent uploading
+         *
+         * @return the number of upload steps that were run
+         *
+         */
+        std::size_t drain(std::size_t byteBudget, std::chrono::microseconds timeBudget);
+
+        /**
+         * Waits for every submission to be prepared and runs every upload step, regardless of any budget (for
+         * loading screens, for instance).  This must be called on the GL thread.
+         *
+         * @return the number of upload steps that were run
+         *
+         */
+        std::size_t finish();
+
+        /**
+         * Retrieves the number of submissions that have yet to be uploaded
+         *
+         * @return the number of submissions that are being prepared or await upload
+         *
+         */
+        std::size_t getPendingCount();
+
+        /**
+         * Retrieves the number of submissions that have been prepared, and await upload by the next drain
+         *
+         * @return the number of submissions that are ready to be uploaded
+         *
+         */
+        std::size_t getReadyCount();
+
+        /**
+         * Stops the worker threads once they have prepared their current jobs.  Submissions that have not been
+         * uploaded are abandoned, and their futures report a broken promise.
+         *
+         */
+        ~UploadQueue();
+    };
+}
+
+#include "UploadQueue.inl"
+
+#endif
@@ -28,6 +28,9 @@ namespace midnight
  * 
  * Please refer to https://www.opengl.org/sdk/docs/man4/xhtml/glBufferData.xml to decide which to use.
  * 
+ * Each alias also takes what is kept of the data once it is uploaded (see BufferRetention), which defaults 
+ * to Discard for the static draw buffers and to Keep for the rest.
+ * 
  * More built-in types shall be added to this API as the opengl specification evolves.
  * 
  */
@@ -76,16 +79,46 @@ class VertexBuffer
      */
     virtual void setVertexData(const std::vector<T>& data) = 0;
 
+    /**
+     * Replaces a range of the data contained in this VertexBuffer without reallocating it
+     * 
+     * If the data is kept, the upload is deferred until this VertexBuffer is next flushed (or bound), so that 
+     * many small updates coalesce into few uploads.  Otherwise the elements are uploaded at once.
+     * 
+     * @param offset the index of the first element to replace
+     * 
+     * @param data the replacement elements
+     * 
+     * @param count the number of elements to replace
+     * 
+     * @throws IllegalArgumentException if the range extends past the end of this VertexBuffer
+     * 
+     */
+    virtual void updateVertexData(std::size_t offset, const T* data, std::size_t count) = 0;
+
+    /**
+     * Uploads every update that is pending to the GPU (this is done by bind as well)
+     * 
+     * @param orphan whether to respecify the whole buffer rather than only the updated ranges, so that the 
+     * implementation need not wait for draws that are still reading it
+     * 
+     */
+    virtual void flush(bool orphan = false) = 0;
+
     /**
      * Binds this VertexBuffer to the implementation based on the currently bound program
      * 
+     * The attribute pointers are recorded into a vertex array the first time that this VertexBuffer is bound 
+     * with each program, and later binds with that program merely bind the vertex array.  As the element 
+     * buffer binding belongs to the vertex array, an IndexBuffer must be bound after this VertexBuffer.
+     * 
      * @throws BindException if there is currently no program bound to the implementation
      * 
      */
     virtual void bind() = 0;
 
     /**
-     * Unbinds this VertexBuffer from the implementation
+     * Unbinds this VertexBuffer (and its vertex array) from the implementation
      * 
      */
     virtual void unbind() noexcept = 0;
@@ -172,60 +205,60 @@ class VertexBuffer
 namespace midnight
 {
     
-template<typename T>
-using StreamDrawTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_STREAM_DRAW>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_STREAM_DRAW>::value>
+using StreamDrawTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_STREAM_DRAW, Retention>;
 
-template<typename T>
-using StreamReadTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_STREAM_READ>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_STREAM_READ>::value>
+using StreamReadTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_STREAM_READ, Retention>;
 
-template<typename T>
-using StreamCopyTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_STREAM_COPY>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_STREAM_COPY>::value>
+using StreamCopyTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_STREAM_COPY, Retention>;
 
-template<typename T>
-using StaticDrawTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_STATIC_DRAW>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_STATIC_DRAW>::value>
+using StaticDrawTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_STATIC_DRAW, Retention>;
 
-template<typename T>
-using StaticReadTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_STATIC_READ>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_STATIC_READ>::value>
+using StaticReadTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_STATIC_READ, Retention>;
 
-template<typename T>
-using StaticCopyTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_STATIC_COPY>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_STATIC_COPY>::value>
+using StaticCopyTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_STATIC_COPY, Retention>;
 
-template<typename T>
-using DynamicDrawTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_DYNAMIC_DRAW>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_DYNAMIC_DRAW>::value>
+using DynamicDrawTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_DYNAMIC_DRAW, Retention>;
 
-template<typename T>
-using DynamicReadTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_DYNAMIC_READ>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_DYNAMIC_READ>::value>
+using DynamicReadTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_DYNAMIC_READ, Retention>;
 
-template<typename T>
-using DynamicCopyTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_DYNAMIC_COPY>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_DYNAMIC_COPY>::value>
+using DynamicCopyTriangleBuffer = detail::VertexBufferImpl<T, GL_TRIANGLES, GL_DYNAMIC_COPY, Retention>;
 
 
-template<typename T>
-using StreamDrawQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_STREAM_DRAW>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_STREAM_DRAW>::value>
+using StreamDrawQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_STREAM_DRAW, Retention>;
 
-template<typename T>
-using StreamReadQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_STREAM_READ>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_STREAM_READ>::value>
+using StreamReadQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_STREAM_READ, Retention>;
 
-template<typename T>
-using StreamCopyQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_STREAM_COPY>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_STREAM_COPY>::value>
+using StreamCopyQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_STREAM_COPY, Retention>;
 
-template<typename T>
-using StaticDrawQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_STATIC_DRAW>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_STATIC_DRAW>::value>
+using StaticDrawQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_STATIC_DRAW, Retention>;
 
-template<typename T>
-using StaticReadQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_STATIC_READ>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_STATIC_READ>::value>
+using StaticReadQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_STATIC_READ, Retention>;
 
-template<typename T>
-using StaticCopyQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_STATIC_COPY>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_STATIC_COPY>::value>
+using StaticCopyQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_STATIC_COPY, Retention>;
 
-template<typename T>
-using DynamicDrawQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_DYNAMIC_DRAW>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_DYNAMIC_DRAW>::value>
+using DynamicDrawQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_DYNAMIC_DRAW, Retention>;
 
-template<typename T>
-using DynamicReadQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_DYNAMIC_READ>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_DYNAMIC_READ>::value>
+using DynamicReadQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_DYNAMIC_READ, Retention>;
 
-template<typename T>
-using DynamicCopyQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_DYNAMIC_COPY>;
+template<typename T, BufferRetention Retention = detail::DefaultRetention<GL_DYNAMIC_COPY>::value>
+using DynamicCopyQuadBuffer = detail::VertexBufferImpl<T, GL_QUADS, GL_DYNAMIC_COPY, Retention>;
 
 }
 
@@ -1,9 +1,82 @@
 #ifndef PROGRAM_HPP
 #define PROGRAM_HPP
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "BuildConstraints.hpp"
 #include "Matrix.hpp"
 #include "Shader.hpp"
+#include "hash_code.hpp"
+
+/**
+ * The name of a uniform, along with its hash.  UniformNames are implicitly constructed from string literals and 
+ * std::strings, so that uniforms are set by name as ever.  A literal passed straight to setUniform is hashed at 
+ * run-time on every call; the hash is only computed at compile-time by declaring the UniformName constexpr, which 
+ * is how the uniforms of the engine's own shaders are named:
+ * 
+ *     constexpr UniformName PROJECTION("projection");
+ * 
+ * A UniformName does not copy its name, so one constructed from a std::string may only be used within the call 
+ * that it is passed to.
+ * 
+ */
+class UniformName
+{
+    /// The hash of the name (see hashCode)
+    std::size_t hash;
+    
+    /// The name, which must outlive this UniformName
+    const char* name;
+    
+  public:
+    
+    /**
+     * Constructs a UniformName from the provided c-string
+     * 
+     * @param name the name of the uniform
+     * 
+     */
+    constexpr UniformName(const char* name) noexcept : hash(hashCode(name)), name(name)
+    {
+        
+    }
+    
+    /**
+     * Constructs a UniformName from the provided std::string.  It refers to the characters of the std::string, so 
+     * it must not be stored, nor outlive the call that it is passed to.
+     * 
+     * @param name the name of the uniform, which must not be modified or destroyed while this UniformName is used
+     * 
+     */
+    UniformName(const std::string& name) noexcept : hash(hashCode(name.c_str())), name(name.c_str())
+    {
+        
+    }
+    
+    /**
+     * Retrieves the hash of the name
+     * 
+     * @return the hash of the name
+     * 
+     */
+    constexpr std::size_t getHash() const noexcept
+    {
+        return hash;
+    }
+    
+    /**
+     * Retrieves the name
+     * 
+     * @return the name
+     * 
+     */
+    constexpr const char* getName() const noexcept
+    {
+        return name;
+    }
+};
 
 /**
  * A wrapper class for a GLSL program.  Programs may not be copy-constructed 
@@ -13,12 +86,37 @@
  * also means that programs may not have shaders added or removed from them 
  * after construction, nor are they able to be re-linked.
  * 
+ * The locations of the active uniforms are resolved once after linking, and are looked up by the hash of their 
+ * name when a uniform is set, rather than being queried from the implementation every time.  The lookup is a 
+ * binary search of the (few) active uniforms, as hashes are too sparse to index an array with.
+ * 
  */
 class Program
 {
 
     /// The implementation provided handle to this Program    
     GLuint handle;
+    
+    /// The hash of the name and the location of each active uniform, in ascending order of hash
+    std::vector<std::pair<std::size_t, GLint>> uniformLocations;
+    
+    /**
+     * Resolves the locations of the active uniforms of this (linked) Program
+     * 
+     */
+    void resolveUniformLocations();
+    
+    /**
+     * Retrieves the location of the specified uniform
+     * 
+     * @param uniformID the uniform to locate
+     * 
+     * @return the location of the uniform
+     * 
+     * @throws UniformNotFoundException if the program has no such (active) uniform
+     * 
+     */
+    GLint getUniformLocation(const UniformName& uniformID) const;
 
   public:
 
@@ -132,7 +230,7 @@ class Program
      * 
      */
     template<typename... E>
-    void setUniform(const std::string& uniformID, E&&... tuples);
+    void setUniform(const UniformName& uniformID, E&&... tuples);
     
     /**
      * Sets the specified matrix uniform to the provided value
@@ -145,7 +243,19 @@ class Program
      * 
      */
     template<typename T, std::size_t Rows, std::size_t Columns>
-    void setMatrixUniform(const std::string& uniformID, const midnight::Matrix<T, Rows, Columns>& matrix);
+    void setMatrixUniform(const UniformName& uniformID, const midnight::Matrix<T, Rows, Columns>& matrix);
+
+    /**
+     * Attaches the specified uniform block to the provided uniform buffer binding point
+     * 
+     * @param blockID the uniform block to attach
+     * 
+     * @param binding the binding point to read the block from
+     * 
+     * @throws UniformNotFoundException if the program has no such (active) uniform block
+     * 
+     */
+    void setUniformBlockBinding(const std::string& blockID, GLuint binding);
 };
 
 #include "Program.inl"
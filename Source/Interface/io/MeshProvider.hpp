@@ -2,10 +2,14 @@
 #define MESH_LOADER_HPP
 
 #include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include "Mesh.hpp"
+#include "MeshCache.hpp"
+#include "ResourceException.hpp"
+#include "dynamic_warn.hpp"
 
 namespace midnight
 {
@@ -25,18 +29,106 @@ namespace spi
     
 namespace io
 {     
-    midnight::Mesh loadMesh(const std::string& fileName)
+namespace detail
+{
+    /**
+     * Loads the provided mesh file through its provider, recomputes its normals if any are missing or broken, 
+     * and writes a cache of it for the next run
+     *
+     */
+    midnight::Mesh loadAndCacheMesh(const std::string& fileName, const std::string& cacheName)
     {
         std::string extension = fileName.substr(fileName.find_last_of("."));
         for(auto provider : spi::meshProviders)
         {
             if(provider->isLoadableExtension(extension))
             {
-                return provider->loadMesh(fileName);
+                midnight::Mesh mesh = provider->loadMesh(fileName);
+                if(!mesh.hasValidNormals())
+                {
+                    /// Repaired once here, the normals are then loaded from the cache
+                    mesh.recomputeNormals();
+                }
+                try
+                {
+                    MeshCache::write(cacheName, mesh, fileName);
+                }
+                catch(const std::exception&)
+                {
+                    /// A read-only asset directory only costs the speedup
+                    dynamic_warn("Unable to write a mesh cache");
+                }
+                return mesh;
             }
         }
         throw std::runtime_error("No known provider for " + extension + " format");
     }
+}
+
+    /**
+     * Loads the provided mesh file.
+     *
+     * If a current mesh cache (fileName + MeshCache::EXTENSION) exists, it is mapped in place of parsing the
+     * file.  Otherwise the file is loaded through its provider, its normals are recomputed if any are missing 
+     * or broken, and a cache is written for the next run.
+     *
+     * This is the slow path, for callers that need a Mesh (to edit or optimize it): even from a cache, a 
+     * Vertex is built for every vertex.  A mesh that is only to be rendered should be loaded with 
+     * loadMeshCache and uploaded with MeshNode(const MeshCache&), which copy nothing on the CPU.
+     *
+     */
+    midnight::Mesh loadMesh(const std::string& fileName)
+    {
+        const std::string cacheName = fileName + MeshCache::EXTENSION;
+        if(MeshCache::isCurrent(cacheName, fileName))
+        {
+            try
+            {
+                return MeshCache(cacheName).toMesh();
+            }
+            catch(const ResourceException&)
+            {
+                dynamic_warn("Ignoring an unreadable mesh cache");
+            }
+        }
+        return detail::loadAndCacheMesh(fileName, cacheName);
+    }
+
+    /**
+     * Loads the provided mesh file as a MeshCache, which a MeshNode uploads straight from its mapping, without 
+     * building a Mesh.
+     *
+     * If there is no current mesh cache, the file is loaded and cached as loadMesh does, and the new cache is 
+     * mapped (or, if it could not be written, the Mesh is serialized to memory).
+     *
+     */
+    MeshCache loadMeshCache(const std::string& fileName)
+    {
+        const std::string cacheName = fileName + MeshCache::EXTENSION;
+        if(MeshCache::isCurrent(cacheName, fileName))
+        {
+            try
+            {
+                return MeshCache(cacheName);
+            }
+            catch(const ResourceException&)
+            {
+                dynamic_warn("Ignoring an unreadable mesh cache");
+            }
+        }
+
+        const midnight::Mesh mesh = detail::loadAndCacheMesh(fileName, cacheName);
+        try
+        {
+            return MeshCache(cacheName);
+        }
+        catch(const ResourceException&)
+        {
+            std::stringstream stream;
+            stream << mesh;
+            return MeshCache(stream);
+        }
+    }
 
 }
 }
@@ -24,6 +24,21 @@ namespace spi
 	  public:
 		virtual bool isLoadableExtension(const std::string& extension) const noexcept = 0;
 		virtual midnight::Texture loadTexture(const std::string& file) = 0;
+
+		/**
+		 * Decodes the provided image file to RGBA pixels, without making a GL call - so that it may be called 
+		 * from any thread (see UploadQueue)
+		 * 
+		 * @param file the image file to decode
+		 * 
+		 * @param width receives the width of the image
+		 * 
+		 * @param height receives the height of the image
+		 * 
+		 * @return the pixels of the image, 4 bytes (RGBA) per pixel, row by row
+		 * 
+		 */
+		virtual std::vector<unsigned char> loadPixels(const std::string& file, std::size_t& width, std::size_t& height) = 0;
 		virtual midnight::Heightmap loadHeightmap(const std::string& file) = 0;
 		virtual ~TextureProvider() = default;
 	};
@@ -59,6 +74,23 @@ midnight::Heightmap loadHeightmap(const std::string& fileName)
         }
         throw std::runtime_error("No known provider for " + extension + " format");
     }
+
+    /**
+     * Decodes the provided image file to RGBA pixels through its provider, which may be done off the GL thread
+     * 
+     */
+    std::vector<unsigned char> loadPixels(const std::string& fileName, std::size_t& width, std::size_t& height)
+    {
+        std::string extension = fileName.substr(fileName.find_last_of("."));
+        for(auto provider : midnight::spi::textureProviders)
+        {
+            if(provider->isLoadableExtension(extension))
+            {
+                return provider->loadPixels(fileName, width, height);
+            }
+        }
+        throw std::runtime_error("No known provider for " + extension + " format");
+    }
 }
 }
 
@@ -67,6 +67,17 @@ class Camera
      */
     Matrix4x4F getOrientation() const noexcept;
 
+    /**
+     * Extracts the planes of the view frustum of this Camera (Gribb & Hartmann) in world space, as the vertex
+     * shaders see it - positions are offset by the position of this Camera, then multiplied by the orientation
+     * and projection matrices.  This is meant to be called once per frame, rather than once per tested object.
+     * 
+     * @param planes receives the left, right, bottom, top, near and far planes (a, b, c, d), whose inside is
+     * where ax + by + cz + d >= 0
+     * 
+     */
+    void getFrustumPlanes(float (&planes)[6][4]) const noexcept;
+
     /**
      * Rotates this Camera around the provided axis by the provided angle
      * 
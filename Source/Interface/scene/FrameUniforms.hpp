@@ -0,0 +1,116 @@
+#ifndef FRAME_UNIFORMS_HPP
+#define FRAME_UNIFORMS_HPP
+
+#include "Camera.hpp"
+#include "Platform.hpp"
+#include "Tuple.hpp"
+
+namespace midnight
+{
+    /// The uniform buffer binding point that the Frame block is read from
+    constexpr GLuint FRAME_UNIFORM_BINDING = 0;
+
+    /// The name of the uniform block that FRAME_UNIFORM_BLOCK_SRC declares
+    constexpr const char FRAME_UNIFORM_BLOCK[] = "Frame";
+
+    /**
+     * The GLSL declaration of the Frame block, to follow the #version directive of a shader that reads it
+     *
+     */
+    constexpr const char FRAME_UNIFORM_BLOCK_SRC[] =
+        "#extension GL_ARB_uniform_buffer_object : require\n\
+        layout(std140) uniform Frame\n\
+        {\n\
+            mat4 projection;\n\
+            mat4 orientation;\n\
+            vec4 offset;\n\
+            vec4 sun_position;\n\
+            vec4 sun_color;\n\
+        };\n";
+
+    /**
+     * The camera and lighting data of a frame, shared by every Program through a uniform buffer.
+     *
+     * The data is uploaded once per frame by update (and only if it has changed since the previous frame), and
+     * is bound to FRAME_UNIFORM_BINDING.  A shader reads it by declaring FRAME_UNIFORM_BLOCK_SRC after its
+     * #version directive, and its Program is attached to the binding point with
+     *
+     *     program.setUniformBlockBinding(FRAME_UNIFORM_BLOCK, FRAME_UNIFORM_BINDING);
+     *
+     */
+    class FrameUniforms
+    {
+        /**
+         * The contents of the Frame block, laid out as std140 specifies
+         *
+         */
+        struct Block
+        {
+            float projection[16];
+            float orientation[16];
+            float offset[4];
+            float sunPosition[4];
+            float sunColor[4];
+        };
+
+        static_assert(sizeof(Block) == 176, "The Frame block must match its std140 layout");
+
+        /// The implementation supplied handle to the uniform buffer, or 0 until the first update
+        GLuint handle;
+
+        /// The contents of the uniform buffer
+        Block block;
+
+        /// Whether the uniform buffer holds the contents of block
+        bool uploaded;
+
+      public:
+
+        /**
+         * Constructs FrameUniforms with a yellow sun overhead.  No GL call is made until the first update.
+         *
+         */
+        FrameUniforms() noexcept;
+
+        FrameUniforms(const FrameUniforms&) = delete;
+
+        FrameUniforms& operator=(const FrameUniforms&) = delete;
+
+        /**
+         * Uploads the provided Camera (and the sun) if they have changed since the previous update, and binds
+         * the uniform buffer to FRAME_UNIFORM_BINDING.  This is called once per frame, before any node renders.
+         *
+         * @param camera the Camera that the frame is rendered from
+         *
+         * @throws ResourceException if the implementation fails to allocate the uniform buffer
+         *
+         */
+        void update(const Camera& camera);
+
+        /**
+         * Sets the position of the sun
+         *
+         * @param position the position of the sun, in world space
+         *
+         */
+        void setSunPosition(const Tuple4F& position) noexcept;
+
+        /**
+         * Sets the color of the sun
+         *
+         * @param color the color of the sun
+         *
+         */
+        void setSunColor(const Tuple4F& color) noexcept;
+
+        /**
+         * Deletes the uniform buffer
+         *
+         */
+        ~FrameUniforms();
+    };
+}
+
+#include "FrameUniforms.inl"
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef HALF_EDGE_MESH_HPP
+#define HALF_EDGE_MESH_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.hpp"
+
+namespace midnight
+{
+    /**
+     * The connectivity of a triangle list, as half-edges.
+     *
+     * Half-edge h is the edge of triangle h / 3 that leaves its corner h % 3, so the triangle, origin, next and
+     * previous half-edge of every half-edge are implied by the index list and only the twin of each half-edge
+     * is stored.  The outgoing half-edges of every vertex are also listed, so one-ring queries take time in
+     * proportion to the valence of the vertex, and work on non-manifold meshes too.
+     *
+     * Everything is held in flat arrays of 32-bit integers (12 bytes per triangle corner).  Edges that are
+     * shared by more than two triangles are not paired, and so are treated as boundary edges.
+     *
+     */
+    class HalfEdgeMesh
+    {
+      public:
+
+        /// Denotes the absence of a half-edge (the twin of a boundary half-edge)
+        static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+      private:
+
+        /// The origin vertex of each half-edge (the index list)
+        std::vector<uint32_t> origins;
+
+        /// The opposite half-edge of each half-edge, or NONE on a boundary
+        std::vector<uint32_t> twins;
+
+        /// The outgoing half-edges of vertex v are [outgoingOffsets[v], outgoingOffsets[v + 1]) of outgoing
+        std::vector<uint32_t> outgoingOffsets;
+        std::vector<uint32_t> outgoing;
+
+        /**
+         * Builds the half-edges of the provided triangle list
+         *
+         */
+        void build(const std::vector<std::size_t>& indices, std::size_t vertexCount, std::size_t threadCount);
+
+      public:
+
+        /**
+         * Builds the half-edges of the provided triangle list.  The twins are found in parallel.
+         *
+         * @param indices the triangle list
+         *
+         * @param vertexCount the number of vertices that the indices refer to
+         *
+         * @param threadCount the number of threads to build with, or 0 to use every hardware thread
+         *
+         * @throws IllegalArgumentException if the indices do not form a triangle list over vertexCount vertices, or
+         * hold 2^32 indices or more
+         *
+         */
+        HalfEdgeMesh(const std::vector<std::size_t>& indices, std::size_t vertexCount, std::size_t threadCount = 0);
+
+        /**
+         * Builds the half-edges of every sub-mesh of the provided Mesh, in order, as one triangle list
+         *
+         * @param mesh the Mesh to build from
+         *
+         * @param threadCount the number of threads to build with, or 0 to use every hardware thread
+         *
+         * @throws IllegalArgumentException if a sub-mesh is not a triangle list over the vertices of the Mesh
+         *
+         */
+        explicit HalfEdgeMesh(const Mesh& mesh, std::size_t threadCount = 0);
+
+        std::size_t getVertexCount() const noexcept
+        {
+            return outgoingOffsets.size() - 1;
+        }
+
+        std::size_t getTriangleCount() const noexcept
+        {
+            return origins.size() / 3;
+        }
+
+        std::size_t getHalfEdgeCount() const noexcept
+        {
+            return origins.size();
+        }
+
+        /// The triangle that holds the provided half-edge
+        uint32_t getTriangle(uint32_t halfEdge) const noexcept
+        {
+            return halfEdge / 3;
+        }
+
+        /// The vertex that the provided half-edge leaves
+        uint32_t getOrigin(uint32_t halfEdge) const noexcept
+        {
+            return origins[halfEdge];
+        }
+
+        /// The vertex that the provided half-edge enters
+        uint32_t getDestination(uint32_t halfEdge) const noexcept
+        {
+            return origins[getNext(halfEdge)];
+        }
+
+        /// The half-edge that follows the provided one around its triangle
+        uint32_t getNext(uint32_t halfEdge) const noexcept
+        {
+            return halfEdge % 3 == 2 ? halfEdge - 2 : halfEdge + 1;
+        }
+
+        /// The half-edge that precedes the provided one around its triangle
+        uint32_t getPrevious(uint32_t halfEdge) const noexcept
+        {
+            return halfEdge % 3 == 0 ? halfEdge + 2 : halfEdge - 1;
+        }
+
+        /// The opposite half-edge of the provided one, or NONE if it lies on a boundary
+        uint32_t getTwin(uint32_t halfEdge) const noexcept
+        {
+            return twins[halfEdge];
+        }
+
+        /// Whether the provided half-edge lies on a boundary
+        bool isBoundary(uint32_t halfEdge) const noexcept
+        {
+            return twins[halfEdge] == NONE;
+        }
+
+        /// The triangle across the provided edge (0, 1 or 2) of the provided triangle, or NONE on a boundary
+        uint32_t getNeighbour(uint32_t triangle, uint32_t edge) const noexcept
+        {
+            const uint32_t twin = twins[triangle * 3 + edge];
+            return twin == NONE ? NONE : twin / 3;
+        }
+
+        /// The number of half-edges that leave the provided vertex (and so the number of triangles around it)
+        std::size_t getValence(uint32_t vertex) const noexcept
+        {
+            return outgoingOffsets[vertex + 1] - outgoingOffsets[vertex];
+        }
+
+        /// The provided one of the half-edges that leave the provided vertex, in ascending order
+        uint32_t getOutgoing(uint32_t vertex, std::size_t i) const noexcept
+        {
+            return outgoing[outgoingOffsets[vertex] + i];
+        }
+
+        /**
+         * Determines whether the provided vertex lies on a boundary (or on an edge that is not manifold)
+         *
+         * @param vertex the vertex to test
+         *
+         * @return true if any edge around the vertex lacks a twin, otherwise false
+         *
+         */
+        bool isBoundaryVertex(uint32_t vertex) const noexcept;
+
+        /**
+         * Determines whether every edge of the mesh is shared by exactly two triangles
+         *
+         * @return true if the mesh has no boundary, otherwise false
+         *
+         */
+        bool isClosed() const noexcept;
+
+        /**
+         * Invokes the provided function with every vertex that shares an edge with the provided vertex, once each
+         *
+         * @param vertex the vertex whose one-ring to visit
+         *
+         * @param function invoked with each neighbouring vertex (a uint32_t)
+         *
+         */
+        template<typename F>
+        void forEachNeighbour(uint32_t vertex, F function) const;
+
+        /**
+         * Invokes the provided function with every triangle that uses the provided vertex
+         *
+         * @param vertex the vertex whose triangles to visit
+         *
+         * @param function invoked with each triangle (a uint32_t)
+         *
+         */
+        template<typename F>
+        void forEachTriangle(uint32_t vertex, F function) const;
+    };
+}
+
+#include "HalfEdgeMesh.inl"
+
+#endif
@@ -1,20 +1,79 @@
 #ifndef HEIGHTMAP_HPP
 #define HEIGHTMAP_HPP
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <vector>
 
 namespace midnight
 {
     class Heightmap
     {
+      public:
+        
+        /**
+         * A rectangle of samples, spanning the columns [x0, x1) and the rows [y0, y1)
+         * 
+         */
+        struct Region
+        {
+            std::size_t x0;
+            std::size_t y0;
+            std::size_t x1;
+            std::size_t y1;
+            
+            bool isEmpty() const
+            {
+                return x0 >= x1 || y0 >= y1;
+            }
+        };
+        
+        /**
+         * The orders in which the samples of a Heightmap may be stored
+         * 
+         */
+        enum class Layout
+        {
+            /// One row after another - the order in which samples are loaded and uploaded
+            ROW_MAJOR,
+            
+            /// Square tiles of TILE_SIZE x TILE_SIZE samples, stored one after another in row-major order and 
+            /// each stored row-major itself, so that 2D neighbourhoods share cache lines.  Partial tiles along 
+            /// the right and bottom edges are padded.
+            TILED
+        };
+        
+        /// The number of samples along each edge of a tile of the TILED layout
+        static constexpr std::size_t TILE_SIZE = 8;
+        
+      private:
+        
+        /// log2(TILE_SIZE)
+        static constexpr std::size_t TILE_SHIFT = 3;
+        
+        static_assert(TILE_SIZE == 1u << TILE_SHIFT, "TILE_SIZE must be a power of two");
+        
+        
         std::size_t width;
         std::size_t height;
         
         std::vector<unsigned char> samples;
         
+        /// The number of bytes that each sample occupies
+        std::size_t stride;
+        
+        /// The order in which the samples are stored
+        Layout layout;
+        
+        /// The number of tiles in each row of tiles (TILED layout only)
+        std::size_t tilesPerRow;
+        
         std::size_t scale;
         
+        /// The bounds of every sample that has been modified since the last call to clearDirtyRegion
+        Region dirty;
+        
         typedef typename std::vector<unsigned char>::allocator_type allocator_type;
         typedef typename std::vector<unsigned char>::const_iterator const_iterator;
         typedef typename std::vector<unsigned char>::const_pointer const_pointer;
@@ -28,6 +87,21 @@ namespace midnight
         typedef typename std::vector<unsigned char>::size_type size_type;
         typedef typename std::vector<unsigned char>::value_type value_type;
         
+        /**
+         * Retrieves the index of the first byte of the sample at the provided coordinates
+         * 
+         */
+        std::size_t getOffset(std::size_t x, std::size_t y) const
+        {
+            if(layout == Layout::ROW_MAJOR)
+            {
+                return (y * width + x) * stride;
+            }
+            const std::size_t tile = (y >> TILE_SHIFT) * tilesPerRow + (x >> TILE_SHIFT);
+            const std::size_t within = ((y & (TILE_SIZE - 1)) << TILE_SHIFT) | (x & (TILE_SIZE - 1));
+            return ((tile << (2 * TILE_SHIFT)) | within) * stride;
+        }
+        
       public:
 
         iterator begin()
@@ -54,7 +128,11 @@ namespace midnight
             width(width), 
             height(height), 
             samples(samples), 
-            scale(scale)
+            stride(width * height != 0 ? this->samples.size() / (width * height) : 0), 
+            layout(Layout::ROW_MAJOR), 
+            tilesPerRow(0), 
+            scale(scale),
+            dirty{0, 0, 0, 0}
         {
 
         }
@@ -63,7 +141,11 @@ namespace midnight
             width(width), 
             height(height), 
             samples(std::move(samples)), 
-            scale(scale)
+            stride(width * height != 0 ? this->samples.size() / (width * height) : 0), 
+            layout(Layout::ROW_MAJOR), 
+            tilesPerRow(0), 
+            scale(scale),
+            dirty{0, 0, 0, 0}
         {
 
         }
@@ -78,16 +160,206 @@ namespace midnight
             return height;
         }
 
+        /**
+         * Accesses a byte of the underlying storage of this Heightmap, which is ordered according to the layout
+         * 
+         */
         reference operator[](std::size_t index)
         {
             return samples[index];
         }
         
-/*        template<typename T>
-        T interpolate(const Point<T, 2>& point)
+        const_reference operator[](std::size_t index) const
+        {
+            return samples[index];
+        }
+        
+        /**
+         * Retrieves the number of bytes that each sample of this Heightmap occupies
+         * 
+         * @return the number of bytes that each sample of this Heightmap occupies
+         * 
+         */
+        std::size_t getStride() const
+        {
+            return stride;
+        }
+        
+        /**
+         * Retrieves the height sample at the provided coordinates
+         * 
+         * @param x the column of the sample
+         * 
+         * @param y the row of the sample
+         * 
+         * @return the height sample at the provided coordinates
+         * 
+         */
+        const_reference getSample(std::size_t x, std::size_t y) const
         {
-            return T();
-        }*/
+            return samples[getOffset(x, y)];
+        }
+        
+        /**
+         * Sets every channel of the height sample at the provided coordinates, and marks it as dirty
+         * 
+         * @param x the column of the sample
+         * 
+         * @param y the row of the sample
+         * 
+         * @param value the new height of the sample
+         * 
+         */
+        void setSample(std::size_t x, std::size_t y, unsigned char value)
+        {
+            std::fill_n(samples.begin() + getOffset(x, y), stride, value);
+            markDirty(Region{x, y, x + 1, y + 1});
+        }
+        
+        /**
+         * Marks the provided region as dirty - to be used after modifying samples through the iterators or 
+         * the subscript operator
+         * 
+         * @param region the region that has been modified
+         * 
+         */
+        void markDirty(const Region& region)
+        {
+            const Region clamped{region.x0, region.y0, std::min(region.x1, width), std::min(region.y1, height)};
+            if(clamped.isEmpty())
+            {
+                return;
+            }
+            if(dirty.isEmpty())
+            {
+                dirty = clamped;
+                return;
+            }
+            dirty.x0 = std::min(dirty.x0, clamped.x0);
+            dirty.y0 = std::min(dirty.y0, clamped.y0);
+            dirty.x1 = std::max(dirty.x1, clamped.x1);
+            dirty.y1 = std::max(dirty.y1, clamped.y1);
+        }
+        
+        /**
+         * Retrieves the bounds of every sample that has been modified since the last call to clearDirtyRegion
+         * 
+         * @return the dirty region of this Heightmap (empty if no sample has been modified)
+         * 
+         */
+        const Region& getDirtyRegion() const
+        {
+            return dirty;
+        }
+        
+        /**
+         * Marks every sample of this Heightmap as clean
+         * 
+         */
+        void clearDirtyRegion()
+        {
+            dirty = Region{0, 0, 0, 0};
+        }
+        
+        /**
+         * Bilinearly interpolates the height at the provided (fractional) sample coordinates
+         * 
+         * @param x the column to sample, within [0, width - 1]
+         * 
+         * @param y the row to sample, within [0, height - 1]
+         * 
+         * @return the interpolated height, in the same units as the samples
+         * 
+         */
+        template<typename T>
+        T interpolate(T x, T y) const
+        {
+            const std::size_t x0 = std::min(static_cast<std::size_t>(x), width - 1);
+            const std::size_t y0 = std::min(static_cast<std::size_t>(y), height - 1);
+            const std::size_t x1 = std::min(x0 + 1, width - 1);
+            const std::size_t y1 = std::min(y0 + 1, height - 1);
+            const T u = x - static_cast<T>(x0);
+            const T v = y - static_cast<T>(y0);
+            const T top = static_cast<T>(getSample(x0, y0)) + u * (static_cast<T>(getSample(x1, y0)) - static_cast<T>(getSample(x0, y0)));
+            const T bottom = static_cast<T>(getSample(x0, y1)) + u * (static_cast<T>(getSample(x1, y1)) - static_cast<T>(getSample(x0, y1)));
+            return top + v * (bottom - top);
+        }
+        
+        /**
+         * Retrieves the order in which the samples of this Heightmap are stored
+         * 
+         * @return the order in which the samples of this Heightmap are stored
+         * 
+         */
+        Layout getLayout() const
+        {
+            return layout;
+        }
+        
+        /**
+         * Reorders the samples of this Heightmap.  The sample accessors behave identically for every layout; 
+         * only the iterators and the subscript operator expose the underlying order.
+         * 
+         * @param layout the order in which to store the samples of this Heightmap
+         * 
+         */
+        void setLayout(Layout layout)
+        {
+            if(layout == this->layout)
+            {
+                return;
+            }
+            if(layout == Layout::ROW_MAJOR)
+            {
+                samples = toRowMajor();
+                this->layout = layout;
+                tilesPerRow = 0;
+                return;
+            }
+            
+            tilesPerRow = (width + TILE_SIZE - 1) >> TILE_SHIFT;
+            const std::size_t tilesPerColumn = (height + TILE_SIZE - 1) >> TILE_SHIFT;
+            std::vector<unsigned char> tiled(tilesPerRow * tilesPerColumn * TILE_SIZE * TILE_SIZE * stride);
+            
+            /// Each row of each tile is contiguous in both layouts
+            for(std::size_t y = 0; y < height; ++y)
+            {
+                for(std::size_t x = 0; x < width; x += TILE_SIZE)
+                {
+                    const std::size_t run = width - x < TILE_SIZE ? width - x : TILE_SIZE;
+                    const std::size_t tile = (y >> TILE_SHIFT) * tilesPerRow + (x >> TILE_SHIFT);
+                    const std::size_t within = (y & (TILE_SIZE - 1)) << TILE_SHIFT;
+                    std::memcpy(&tiled[((tile << (2 * TILE_SHIFT)) | within) * stride], &samples[(y * width + x) * stride], run * stride);
+                }
+            }
+            samples = std::move(tiled);
+            this->layout = layout;
+        }
+        
+        /**
+         * Copies the samples of this Heightmap into row-major order (i.e. for uploading as a texture)
+         * 
+         * @return the samples of this Heightmap, in row-major order
+         * 
+         */
+        std::vector<unsigned char> toRowMajor() const
+        {
+            if(layout == Layout::ROW_MAJOR)
+            {
+                return samples;
+            }
+            
+            std::vector<unsigned char> rows(width * height * stride);
+            for(std::size_t y = 0; y < height; ++y)
+            {
+                for(std::size_t x = 0; x < width; x += TILE_SIZE)
+                {
+                    const std::size_t run = width - x < TILE_SIZE ? width - x : TILE_SIZE;
+                    std::memcpy(&rows[(y * width + x) * stride], &samples[getOffset(x, y)], run * stride);
+                }
+            }
+            return rows;
+        }
     };    
 }
 
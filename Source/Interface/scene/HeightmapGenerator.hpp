@@ -0,0 +1,170 @@
+#ifndef HEIGHTMAP_GENERATOR_HPP
+#define HEIGHTMAP_GENERATOR_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "Heightmap.hpp"
+
+namespace midnight
+{
+    /**
+     * Generates Heightmaps procedurally from fractal gradient noise.
+     *
+     * The output depends solely upon the seed, the parameters and the requested dimensions - not upon the
+     * number of threads that are used - so the same generator always produces the same Heightmap.  Samples
+     * are evaluated in fixed-size batches of branch-free arithmetic (four at a time with SSE2, where it is
+     * available), and rows are distributed among worker threads.  The gradient of each lattice point is
+     * selected from an arithmetic hash of its coordinates rather than from a permutation table, so that
+     * evaluating a batch involves no table lookups.
+     *
+     * The generated Heightmaps hold a single byte per sample.
+     *
+     */
+    class HeightmapGenerator
+    {
+      public:
+
+        /**
+         * The kinds of fractal that may be generated
+         *
+         */
+        enum class Variant
+        {
+            /// Fractional Brownian motion - the sum of octaves of noise
+            FBM,
+
+            /// Sharp crests formed by inverting the absolute value of each octave
+            RIDGED,
+
+            /// Fractional Brownian motion sampled at coordinates displaced by two other fBm fields
+            DOMAIN_WARP
+        };
+
+        /// The number of samples that are evaluated together
+        static constexpr std::size_t BATCH_SIZE = 64;
+
+      private:
+
+        /// The low half of the seed, mixed so that neighbouring seeds produce unrelated noise
+        uint32_t seed;
+
+        /// The high half of the seed, as the hash of the lattice column that it translates the noise by
+        uint32_t seedShift;
+
+        /// The kind of fractal to generate
+        Variant variant;
+
+        /// The number of octaves to sum
+        std::size_t octaves;
+
+        /// The frequency of the first octave, in cycles per sample
+        float frequency;
+
+        /// The frequency multiplier between consecutive octaves
+        float lacunarity;
+
+        /// The amplitude multiplier between consecutive octaves
+        float gain;
+
+        /// The distance, in samples, that DOMAIN_WARP displaces coordinates by
+        float warpStrength;
+
+        /// The number of threads to generate with (0 selects the number of hardware threads)
+        std::size_t threadCount;
+
+        /**
+         * Evaluates gradient noise at BATCH_SIZE points
+         *
+         */
+        void noise(const float* xs, const float* ys, float* out) const noexcept;
+
+        /**
+         * Evaluates the configured fractal (excluding any domain warping) at BATCH_SIZE points
+         *
+         */
+        void fractal(const float* xs, const float* ys, float* out, bool ridged) const noexcept;
+
+        /**
+         * Generates the provided range of rows
+         *
+         */
+        void generateRows(std::size_t width, std::size_t firstRow, std::size_t lastRow, unsigned char* samples) const noexcept;
+
+      public:
+
+        /**
+         * Constructs a HeightmapGenerator
+         *
+         * @param seed the seed of the noise
+         *
+         * @param variant the kind of fractal to generate
+         *
+         */
+        explicit HeightmapGenerator(uint32_t seed, Variant variant = Variant::FBM);
+
+        /**
+         * Sets the number of octaves to sum
+         *
+         * @param octaves the number of octaves to sum (defaults to 6)
+         *
+         */
+        void setOctaves(std::size_t octaves) noexcept;
+
+        /**
+         * Sets the frequency of the first octave
+         *
+         * @param frequency the frequency of the first octave, in cycles per sample (defaults to 1/256)
+         *
+         */
+        void setFrequency(float frequency) noexcept;
+
+        /**
+         * Sets the frequency multiplier between consecutive octaves
+         *
+         * @param lacunarity the frequency multiplier between consecutive octaves (defaults to 2)
+         *
+         */
+        void setLacunarity(float lacunarity) noexcept;
+
+        /**
+         * Sets the amplitude multiplier between consecutive octaves
+         *
+         * @param gain the amplitude multiplier between consecutive octaves (defaults to 0.5)
+         *
+         */
+        void setGain(float gain) noexcept;
+
+        /**
+         * Sets the distance that DOMAIN_WARP displaces coordinates by
+         *
+         * @param warpStrength the distance, in samples, to displace coordinates by (defaults to 64)
+         *
+         */
+        void setWarpStrength(float warpStrength) noexcept;
+
+        /**
+         * Sets the number of threads to generate with
+         *
+         * @param threadCount the number of threads to generate with, or 0 to use every hardware thread
+         *
+         */
+        void setThreadCount(std::size_t threadCount) noexcept;
+
+        /**
+         * Generates a Heightmap
+         *
+         * @param width the number of samples in each row
+         *
+         * @param height the number of rows
+         *
+         * @return the generated Heightmap
+         *
+         */
+        Heightmap generate(std::size_t width, std::size_t height) const;
+    };
+}
+
+#include "HeightmapGenerator.inl"
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef HEIGHTMAP_PYRAMID_HPP
+#define HEIGHTMAP_PYRAMID_HPP
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Heightmap.hpp"
+#include "Line.hpp"
+#include "Point.hpp"
+#include "Vector.hpp"
+
+namespace midnight
+{
+    /**
+     * A hierarchy of minimum and maximum heights (a "maximum mipmap") built over the cells of a Heightmap.
+     *
+     * Level 0 holds the height range of each cell (the quad between four neighbouring samples), and every
+     * subsequent level holds the range of a 2x2 block of the level below, up until a single root range.  Ray
+     * queries descend the hierarchy front-to-back and only test the two triangles of the cells whose ranges
+     * the ray actually passes through.
+     *
+     * All queries take place in heightmap space, where x and z are sample coordinates and y is the raw
+     * sample value.  The cells are triangulated in the same manner as a Terrain.
+     *
+     */
+    class HeightmapPyramid
+    {
+      public:
+
+        /**
+         * The result of a successful ray query
+         *
+         */
+        template<typename T>
+        struct Hit
+        {
+            /// The distance along the ray, in multiples of the ray's vector, to the point of intersection
+            T distance;
+
+            /// The point of intersection
+            Point<T, 3> point;
+
+            /// The unit-length, upward-facing normal of the surface at the point of intersection
+            Vector<T, 3> normal;
+        };
+
+      private:
+
+        /// The lowest and highest sample of a block of cells
+        struct Range
+        {
+            uint8_t minimum;
+            uint8_t maximum;
+        };
+
+        /// A single entry of the traversal stack
+        struct Node
+        {
+            std::size_t level;
+            std::size_t x;
+            std::size_t z;
+        };
+
+        /// The number of samples in each row of the Heightmap
+        std::size_t width;
+
+        /// The number of rows of the Heightmap
+        std::size_t height;
+
+        /// A copy of the samples of the Heightmap (one byte per sample)
+        std::vector<uint8_t> samples;
+
+        /// The number of nodes in each row of each level
+        std::vector<std::size_t> levelWidths;
+
+        /// The number of rows of each level
+        std::vector<std::size_t> levelHeights;
+
+        /// The height ranges of each level, stored row-major
+        std::vector<std::vector<Range>> levels;
+
+        /**
+         * Recomputes the ranges of the provided block of level 0 cells, spanning the columns [x0, x1) and the 
+         * rows [z0, z1), along with the ranges of every node above them
+         * 
+         */
+        void refresh(std::size_t x0, std::size_t z0, std::size_t x1, std::size_t z1) noexcept;
+
+        /**
+         * Computes the interval over which the provided ray passes through the bounds of the provided node
+         *
+         * @return true if the ray passes through the node between near and far, otherwise false
+         *
+         */
+        template<typename T>
+        bool clip(const Node& node, const T origin[3], const T inverse[3], T& near, T& far) const noexcept;
+
+        /**
+         * Intersects the provided ray with the two triangles of the provided cell
+         *
+         * @return true if the ray intersects the cell before the provided limit, otherwise false
+         *
+         */
+        template<typename T>
+        bool intersectCell(std::size_t x, std::size_t z, const T origin[3], const T direction[3], T limit, Hit<T>& hit) const noexcept;
+
+      public:
+
+        /**
+         * Builds the hierarchy over the provided Heightmap
+         *
+         * @param heightmap the Heightmap to build the hierarchy over
+         *
+         * @throws IllegalArgumentException if the Heightmap is smaller than 2x2 samples
+         *
+         */
+        explicit HeightmapPyramid(const Heightmap& heightmap);
+
+        /**
+         * Brings the hierarchy up to date with the provided region of the Heightmap that it was built over
+         *
+         * @param heightmap the modified Heightmap
+         *
+         * @param region the region of samples that has been modified
+         *
+         * @throws IllegalArgumentException if the dimensions of the Heightmap have changed
+         *
+         */
+        void update(const Heightmap& heightmap, const Heightmap::Region& region);
+
+        /**
+         * Finds the nearest intersection of the provided ray with the surface of the Heightmap
+         *
+         * @param ray the ray to cast (in heightmap space)
+         *
+         * @param hit the Hit to populate upon success
+         *
+         * @param limit the distance, in multiples of the ray's vector, past which intersections are ignored
+         *
+         * @return true if the ray intersects the surface, otherwise false
+         *
+         */
+        template<typename T>
+        bool intersect(const Line<T, 3>& ray, Hit<T>& hit, T limit = std::numeric_limits<T>::infinity()) const noexcept;
+
+        /**
+         * Retrieves the number of levels in this hierarchy
+         *
+         * @return the number of levels in this hierarchy
+         *
+         */
+        std::size_t getLevelCount() const noexcept;
+
+        /**
+         * Retrieves the lowest sample beneath the provided node
+         *
+         * @param level the level of the node
+         *
+         * @param x the column of the node
+         *
+         * @param z the row of the node
+         *
+         * @return the lowest sample beneath the provided node
+         *
+         */
+        uint8_t getMinimum(std::size_t level, std::size_t x, std::size_t z) const noexcept;
+
+        /**
+         * Retrieves the highest sample beneath the provided node
+         *
+         * @param level the level of the node
+         *
+         * @param x the column of the node
+         *
+         * @param z the row of the node
+         *
+         * @return the highest sample beneath the provided node
+         *
+         */
+        uint8_t getMaximum(std::size_t level, std::size_t x, std::size_t z) const noexcept;
+    };
+}
+
+#include "HeightmapPyramid.inl"
+
+#endif
@@ -9,53 +9,52 @@
 #include "Vertex.hpp"
 
 #include "Material.hpp"
+#include "MeshOptimizer.hpp"
+#include "Meshlet.hpp"
 
 namespace midnight
 {
     /// Forward Declaration for our friends
     class Mesh;
-}
 
-/**
- * Inserts the provided Mesh into the provided output stream
- * 
- * @param stream the output stream to write to
- * 
- * @param mesh the Mesh to insert
- * 
- * @return the provided output stream
- * 
- */
-
-std::ostream& operator<<(std::ostream& stream, const midnight::Mesh& mesh);
-
-/**
- * Inserts the provided Mesh into the provided output stream
- * 
- * @param stream the output stream to write to
- * 
- * @param mesh the Mesh to insert
- * 
- * @return the provided output stream
- * 
- * @note [optimization] this method should be preferred when the provided Mesh is not used by the calling method
- * 
- */
-
-std::ostream& operator<<(std::ostream& stream, midnight::Mesh&& mesh);
-
-/**
- * Extracts a Mesh from the provided input stream
- * 
- * @param stream the input stream to read from
- * 
- * @param mesh the Mesh to populate with the extracted data
- * 
- * @return the provided input stream
- * 
- */
-
-std::istream& operator>>(std::istream& stream, midnight::Mesh& mesh);
+    /**
+     * Inserts the provided Mesh into the provided output stream, in the binary mesh cache format (see MeshCache)
+     * 
+     * @param stream the output stream to write to - it should be opened in binary mode
+     * 
+     * @param mesh the Mesh to insert
+     * 
+     * @return the provided output stream
+     * 
+     */
+    std::ostream& operator<<(std::ostream& stream, const midnight::Mesh& mesh);
+
+    /**
+     * Inserts the provided Mesh into the provided output stream, in the binary mesh cache format (see MeshCache)
+     * 
+     * @param stream the output stream to write to - it should be opened in binary mode
+     * 
+     * @param mesh the Mesh to insert
+     * 
+     * @return the provided output stream
+     * 
+     * @note [optimization] this method should be preferred when the provided Mesh is not used by the calling method
+     * 
+     */
+    std::ostream& operator<<(std::ostream& stream, midnight::Mesh&& mesh);
+
+    /**
+     * Extracts a Mesh, in the binary mesh cache format (see MeshCache), from the provided input stream
+     * 
+     * @param stream the input stream to read from - it should be opened in binary mode
+     * 
+     * @param mesh the Mesh to populate with the extracted data
+     * 
+     * @return the provided input stream, which has its failbit set if it did not hold a compatible Mesh
+     * 
+     */
+    std::istream& operator>>(std::istream& stream, midnight::Mesh& mesh);
+}
 
 namespace midnight
 {
@@ -86,11 +85,17 @@ namespace midnight
             /// The list of indices of this sub-mesh
             std::vector<std::size_t> indices;
             
+            /// The clusters of the indices of this sub-mesh (empty unless built by Mesh::buildMeshlets)
+            std::vector<Meshlet> meshlets;
+            
             Renderable(std::size_t materialIndex) : materialIndex(materialIndex)
             {
                 
             }
         };
+        /// The number of floats that each vertex occupies in interleaved form (position, normal, texture coordinates)
+        static constexpr std::size_t INTERLEAVED_SIZE = 8;
+        
       private:
         
         std::vector<Vertex32F> vertices;
@@ -104,18 +109,116 @@ namespace midnight
       public:
         
         Mesh(const std::vector<Vertex32F>& vertices, const std::vector<midnight::Material>& materials, const std::vector<midnight::Mesh::Renderable>& renderables);
+        
+        Mesh(std::vector<Vertex32F>&& vertices, std::vector<midnight::Material>&& materials, std::vector<midnight::Mesh::Renderable>&& renderables);
 
         const std::vector<Vertex32F>& getVertices() const noexcept
         {
             return vertices;
         }
-        const std::vector<Renderable> getMeshes() const noexcept
+        const std::vector<Renderable>& getMeshes() const noexcept
         {
             return meshes;
         }
+        
+        const std::vector<Material>& getMaterials() const noexcept
+        {
+            return materials;
+        }
+        
+        /**
+         * Builds the interleaved vertex data of this Mesh, ready to be uploaded to a VertexBuffer
+         * 
+         * Each vertex occupies INTERLEAVED_SIZE consecutive floats: three of position, three of normal and two of 
+         * texture coordinates.  The result is allocated once, at its final size.
+         * 
+         * @return the interleaved vertex data of this Mesh
+         * 
+         */
+        std::vector<float> getInterleavedVertices() const;
+        
+        /**
+         * Reorders this Mesh for rendering: the triangles of each sub-mesh are ordered for the post-transform 
+         * vertex cache and then for overdraw (see optimizeVertexCache and optimizeOverdraw), after which the 
+         * vertices are ordered by first use so that they are fetched sequentially.  Unused vertices are moved to 
+         * the end.
+         * 
+         * This is intended to run once, at import time - the result may be cached along with the Mesh.  Any 
+         * Meshlets are discarded, as the triangles are no longer in their order.
+         * 
+         * @param overdrawThreshold the largest acceptable ratio by which overdraw ordering may degrade the 
+         * vertex cache miss ratio of each sub-mesh
+         * 
+         * @throws IllegalArgumentException if a sub-mesh is not a triangle list over the vertices of this Mesh
+         * 
+         */
+        void optimize(float overdrawThreshold = 1.05f);
+        
+        /**
+         * Merges the duplicate vertices of this Mesh (see weldVertices) and remaps the indices of its sub-meshes
+         * 
+         * @param epsilon the quantization step of every vertex attribute (0 merges identical vertices only)
+         * 
+         * @param threadCount the number of threads to hash with, or 0 to use every hardware thread
+         * 
+         * @return the number of vertices that remain
+         * 
+         * @throws IllegalArgumentException if epsilon is negative
+         * 
+         */
+        std::size_t weld(float epsilon = 0.0f, std::size_t threadCount = 0);
+        
+        /**
+         * Splits every sub-mesh of this Mesh into Meshlets (see buildMeshlets), so that the clusters that face 
+         * away from the viewer may be skipped when it is drawn
+         * 
+         * @param maxTriangles the largest number of triangles in a Meshlet
+         * 
+         * @param maxVertices the largest number of distinct vertices in a Meshlet
+         * 
+         * @throws IllegalArgumentException if a sub-mesh is not a triangle list over the vertices of this Mesh
+         * 
+         */
+        void buildMeshlets(std::size_t maxTriangles = 124, std::size_t maxVertices = 64);
+        
+        /**
+         * Determines whether every vertex of this Mesh has a finite, unit-length normal
+         * 
+         * @return true if the normals of this Mesh are usable, otherwise false
+         * 
+         */
+        bool hasValidNormals() const noexcept;
+        
+        /**
+         * Replaces the normals of this Mesh with smooth normals computed from the faces of every sub-mesh (see 
+         * computeVertexNormals)
+         * 
+         * @param weighting how the faces around each vertex contribute to its normal
+         * 
+         * @param threadCount the number of threads to compute with, or 0 to use every hardware thread
+         * 
+         * @throws IllegalArgumentException if a sub-mesh is not a triangle list over the vertices of this Mesh
+         * 
+         */
+        void recomputeNormals(NormalWeighting weighting = NormalWeighting::AREA_AND_ANGLE, std::size_t threadCount = 0);
+        
+        /**
+         * Computes the tangent frames of this Mesh from the faces of every sub-mesh (see computeVertexTangents)
+         * 
+         * @param threadCount the number of threads to compute with, or 0 to use every hardware thread
+         * 
+         * @return four floats per vertex: a unit tangent and the handedness of the bitangent
+         * 
+         * @throws IllegalArgumentException if a sub-mesh is not a triangle list over the vertices of this Mesh
+         * 
+         */
+        std::vector<float> computeTangents(std::size_t threadCount = 0) const;
     };
 
 }
 
 #include "Mesh.inl"
+
+/// Defines the stream operators of Mesh
+#include "MeshCache.hpp"
 #endif
\ No newline at end of file
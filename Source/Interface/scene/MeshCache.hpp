@@ -0,0 +1,279 @@
+#ifndef MESH_CACHE_HPP
+#define MESH_CACHE_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "Mesh.hpp"
+
+namespace midnight
+{
+    namespace detail
+    {
+        /**
+         * The header of a mesh cache file.
+         *
+         * Every section starts on a MeshCache::ALIGNMENT boundary and every offset is relative to the start of
+         * the file, so once the file is mapped its sections are addressed in place.
+         *
+         */
+        struct MeshCacheHeader
+        {
+            /// MeshCache::MAGIC
+            char magic[8];
+
+            /// MeshCache::VERSION
+            uint32_t version;
+
+            /// MeshCache::BYTE_ORDER_MARK, as written by the producing machine
+            uint32_t byteOrder;
+
+            /// The size of the file that the cache was built from (0 if unknown)
+            uint64_t sourceSize;
+
+            /// The modification time of the file that the cache was built from, in nanoseconds (0 if unknown)
+            int64_t sourceModified;
+
+            /// The size of the cache file itself
+            uint64_t fileSize;
+
+            /// Mesh::INTERLEAVED_SIZE floats per vertex
+            uint64_t vertexCount;
+            uint64_t vertexOffset;
+
+            /// MeshCacheMaterial records
+            uint64_t materialCount;
+            uint64_t materialOffset;
+
+            /// MeshCacheRenderable records
+            uint64_t renderableCount;
+            uint64_t renderableOffset;
+        };
+
+        /**
+         * A Material, as stored in a mesh cache file
+         *
+         */
+        struct MeshCacheMaterial
+        {
+            uint32_t lightingMode;
+            uint32_t cullingMode;
+            uint32_t autoNormalize;
+            uint32_t reserved;
+            float ambience[4];
+            float diffusion[4];
+            float emission[4];
+            float specularity[4];
+        };
+
+        /**
+         * A Mesh::Renderable, as stored in a mesh cache file - the indices are 32-bit and live in their own section
+         *
+         */
+        struct MeshCacheRenderable
+        {
+            uint64_t materialIndex;
+            uint64_t indexCount;
+            uint64_t indexOffset;
+        };
+
+        /**
+         * Writes the provided Mesh to the provided stream in the mesh cache format
+         *
+         * @throws IllegalArgumentException if the Mesh has too many vertices to be addressed with 32-bit indices
+         *
+         */
+        void writeMeshCache(std::ostream& stream, const Mesh& mesh, uint64_t sourceSize, int64_t sourceModified);
+    }
+
+    /**
+     * A read-only view of a Mesh in the binary mesh cache format, backed by a memory-mapped file.
+     *
+     * The vertices are stored interleaved exactly as MeshNode uploads them (see Mesh::getInterleavedVertices) and
+     * the indices as 32-bit integers, so loading a cache involves mapping the file and validating its header,
+     * but no per-vertex parsing.  Mesh caches are only portable between machines of the same byte order.
+     *
+     */
+    class MeshCache
+    {
+      public:
+
+        /// The identifier at the start of every mesh cache file
+        static constexpr const char* MAGIC = "MIDMESH";
+
+        /// The revision of the format, which is incremented upon every incompatible change
+        static constexpr uint32_t VERSION = 2;
+
+        /// Distinguishes the byte order of the producing machine
+        static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+        /// The alignment (in bytes) of every section of the file
+        static constexpr std::size_t ALIGNMENT = 64;
+
+        /// The suffix that is appended to the name of a source file to name its cache
+        static constexpr const char* EXTENSION = ".mcache";
+
+      private:
+
+        /// The mapping of the cache file (when loaded from a file)
+        std::unique_ptr<internal::MappedFile> file;
+
+        /// The contents of the cache (when loaded from a stream), as 8-byte words to keep every section aligned
+        std::vector<uint64_t> buffer;
+
+        /// The start of the cache
+        const char* base;
+
+        /// The header of the cache file
+        const detail::MeshCacheHeader* header;
+
+        /// The interleaved vertices
+        const float* vertices;
+
+        /// The material records
+        const detail::MeshCacheMaterial* materials;
+
+        /// The renderable records
+        const detail::MeshCacheRenderable* renderables;
+
+        /**
+         * Validates the cache at base and fixes up the pointers into its sections
+         *
+         * @throws ResourceException if the cache is not compatible, or is corrupt
+         *
+         */
+        void attach(const void* data, uint64_t size, const std::string& name);
+
+      public:
+
+        /**
+         * Maps the provided mesh cache file
+         *
+         * @param path the path of the cache file
+         *
+         * @throws ResourceException if the file can not be mapped, or is not a compatible mesh cache
+         *
+         */
+        explicit MeshCache(const std::string& path);
+
+        /**
+         * Reads a mesh cache from the remainder of the provided stream
+         *
+         * @param stream the stream to read from, opened in binary mode
+         *
+         * @throws ResourceException if the stream does not hold a compatible mesh cache
+         *
+         */
+        explicit MeshCache(std::istream& stream);
+
+        /**
+         * Determines whether the provided cache file exists, is compatible and was built from the current
+         * revision of the provided source file
+         *
+         * @param path the path of the cache file
+         *
+         * @param source the path of the file that the cache was built from
+         *
+         * @return true if the cache may be used in place of the source file, otherwise false
+         *
+         */
+        static bool isCurrent(const std::string& path, const std::string& source) noexcept;
+
+        /**
+         * Writes a cache of the provided Mesh.  The file is written under a temporary name and then renamed, so
+         * that a partially written cache is never mapped.
+         *
+         * @param path the path of the cache file
+         *
+         * @param mesh the Mesh to write
+         *
+         * @param source the path of the file that the Mesh was loaded from (or empty if there is none)
+         *
+         * @throws ResourceException if the file can not be written
+         *
+         * @throws IllegalArgumentException if the Mesh has too many vertices to be addressed with 32-bit indices
+         *
+         */
+        static void write(const std::string& path, const Mesh& mesh, const std::string& source = "");
+
+        /**
+         * Retrieves the number of vertices in the cached Mesh
+         *
+         * @return the number of vertices in the cached Mesh
+         *
+         */
+        std::size_t getVertexCount() const noexcept;
+
+        /**
+         * Retrieves the interleaved vertices of the cached Mesh (Mesh::INTERLEAVED_SIZE floats per vertex)
+         *
+         * @return the interleaved vertices of the cached Mesh
+         *
+         */
+        const float* getInterleavedVertices() const noexcept;
+
+        /**
+         * Retrieves the number of sub-meshes in the cached Mesh
+         *
+         * @return the number of sub-meshes in the cached Mesh
+         *
+         */
+        std::size_t getRenderableCount() const noexcept;
+
+        /**
+         * Retrieves the Material index of the provided sub-mesh
+         *
+         * @param renderable the index of the sub-mesh
+         *
+         * @return the Material index of the provided sub-mesh
+         *
+         */
+        std::size_t getMaterialIndex(std::size_t renderable) const noexcept;
+
+        /**
+         * Retrieves the number of indices in the provided sub-mesh
+         *
+         * @param renderable the index of the sub-mesh
+         *
+         * @return the number of indices in the provided sub-mesh
+         *
+         */
+        std::size_t getIndexCount(std::size_t renderable) const noexcept;
+
+        /**
+         * Retrieves the indices of the provided sub-mesh
+         *
+         * @param renderable the index of the sub-mesh
+         *
+         * @return the indices of the provided sub-mesh
+         *
+         */
+        const uint32_t* getIndices(std::size_t renderable) const noexcept;
+
+        /**
+         * Retrieves the indices of every sub-mesh, in order, as they are concatenated for upload (see
+         * AdaptiveIndexBuffer) - each sub-mesh starts where the previous one ends
+         *
+         * @return the indices of each sub-mesh, as pairs of the first index and the number of indices
+         *
+         */
+        std::vector<std::pair<const uint32_t*, std::size_t>> getIndexLists() const;
+
+        /**
+         * Builds a Mesh from this cache
+         *
+         * @return the cached Mesh
+         *
+         */
+        Mesh toMesh() const;
+    };
+}
+
+#include "MeshCache.inl"
+
+#endif
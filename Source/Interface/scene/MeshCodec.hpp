@@ -0,0 +1,118 @@
+#ifndef MESH_CODEC_HPP
+#define MESH_CODEC_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.hpp"
+
+namespace midnight
+{
+    /**
+     * The number of bits to which each attribute of an encoded vertex stream is quantized, where 0 keeps the
+     * attribute exact.
+     *
+     * A quantized attribute is stored as an integer within the range of that attribute over the stream, so its
+     * error is at most half of that range divided by 2^bits - 1.
+     *
+     */
+    struct VertexQuantization
+    {
+        /// The bits of each position component
+        unsigned positionBits;
+
+        /// The bits of each normal component
+        unsigned normalBits;
+
+        /// The bits of each texture coordinate
+        unsigned textureBits;
+
+        VertexQuantization(unsigned positionBits = 0, unsigned normalBits = 0, unsigned textureBits = 0) noexcept :
+            positionBits(positionBits),
+            normalBits(normalBits),
+            textureBits(textureBits)
+        {
+
+        }
+    };
+
+    /**
+     * Encodes the provided indices into a compact byte stream.
+     *
+     * Each index is stored as the zig-zag encoded difference from the index before it, and the differences are
+     * stored in blocks of 16 as separate byte planes, leaving out the planes that are all zero.  The indices of
+     * an optimized Mesh (see Mesh::optimize) need about two bytes each, and what remains is laid out to suit a
+     * general purpose compressor.
+     *
+     * @param indices the indices to encode
+     *
+     * @param count the number of indices
+     *
+     * @return the encoded indices
+     *
+     */
+    std::vector<uint8_t> encodeIndices(const uint32_t* indices, std::size_t count);
+
+    /**
+     * Decodes indices that were encoded with encodeIndices
+     *
+     * @param data the encoded indices
+     *
+     * @param size the number of bytes available at data
+     *
+     * @param indices receives the decoded indices
+     *
+     * @param count the number of indices that were encoded
+     *
+     * @return the number of bytes of data that were consumed
+     *
+     * @throws ResourceException if data is too short to hold count indices
+     *
+     */
+    std::size_t decodeIndices(const uint8_t* data, std::size_t size, uint32_t* indices, std::size_t count);
+
+    /**
+     * Encodes the provided interleaved vertices (see Mesh::getInterleavedVertices) into a compact byte stream.
+     *
+     * Each attribute is encoded as a separate column, optionally quantized, as the zig-zag encoded differences
+     * between consecutive vertices in the byte-plane blocks of encodeIndices.  Exact attributes are differenced
+     * as the bit patterns of their floats.  Like a mesh cache, the stream is only portable between machines of
+     * the same byte order.
+     *
+     * @param interleaved the vertices, Mesh::INTERLEAVED_SIZE floats each
+     *
+     * @param vertexCount the number of vertices
+     *
+     * @param quantization the precision to keep of each attribute
+     *
+     * @return the encoded vertices
+     *
+     * @throws IllegalArgumentException if an attribute is quantized to more than 24 bits, or a quantized
+     * attribute is not finite
+     *
+     */
+    std::vector<uint8_t> encodeVertices(const float* interleaved, std::size_t vertexCount,
+        const VertexQuantization& quantization = VertexQuantization());
+
+    /**
+     * Decodes vertices that were encoded with encodeVertices
+     *
+     * @param data the encoded vertices
+     *
+     * @param size the number of bytes available at data
+     *
+     * @param interleaved receives the decoded vertices, Mesh::INTERLEAVED_SIZE floats each
+     *
+     * @param vertexCount the number of vertices that were encoded
+     *
+     * @return the number of bytes of data that were consumed
+     *
+     * @throws ResourceException if data is too short to hold vertexCount vertices, or is corrupt
+     *
+     */
+    std::size_t decodeVertices(const uint8_t* data, std::size_t size, float* interleaved, std::size_t vertexCount);
+}
+
+#include "MeshCodec.inl"
+
+#endif
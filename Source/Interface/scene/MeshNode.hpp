@@ -2,66 +2,223 @@
 #define MESH_NODE_HPP
 
 #include "AbstractSceneGraphNode.hpp"
+#include "ArenaVertexBuffer.hpp"
+#include "BufferArena.hpp"
+#include "DrawCommandBuffer.hpp"
+#include "FrameUniforms.hpp"
+#include "IllegalArgumentException.hpp"
 #include "IndexBuffer.hpp"
 #include "VertexBuffer.hpp"
 #include "Mesh.hpp"
+#include "MeshCache.hpp"
 #include "Vertex.hpp"
 #include "Program.hpp"
 #include "constexpr_math.hpp"
 
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <utility>
 
 namespace midnight
 {
+    /**
+     * The data of a MeshNode that is prepared off the GL thread (see UploadQueue) - the interleaved vertices and 
+     * the indices of every sub-mesh, concatenated - so that constructing the MeshNode from it on the GL thread 
+     * only uploads.
+     * 
+     */
+    struct PreparedMesh
+    {
+        /**
+         * The range of a sub-mesh within the index buffer
+         * 
+         */
+        struct SubMesh
+        {
+            std::size_t materialIndex;
+            std::size_t firstIndex;
+            std::size_t indexCount;
+        };
+        
+        /// The interleaved vertices (see Mesh::getInterleavedVertices)
+        std::vector<float> vertices;
+        
+        /// The indices of every sub-mesh, concatenated
+        std::vector<uint32_t> indices;
+        
+        std::vector<SubMesh> subMeshes;
+        
+        /// The Meshlets of each sub-mesh (empty for those that are drawn whole)
+        std::vector<std::vector<Meshlet>> meshlets;
+        
+        /**
+         * Interleaves the vertices and concatenates the indices of the provided Mesh
+         * 
+         * @param mesh the Mesh to prepare
+         * 
+         * @throws IllegalArgumentException if the Mesh has too many vertices to be addressed with 32-bit indices
+         * 
+         */
+        explicit PreparedMesh(const Mesh& mesh) : vertices(mesh.getInterleavedVertices())
+        {
+            if(mesh.getVertices().size() > std::numeric_limits<uint32_t>::max())
+            {
+                throw IllegalArgumentException("A MeshNode can not address more than 2^32 vertices");
+            }
+            for(const Mesh::Renderable& renderable : mesh.getMeshes())
+            {
+                subMeshes.push_back(SubMesh{renderable.materialIndex, indices.size(), renderable.indices.size()});
+                indices.insert(indices.end(), renderable.indices.begin(), renderable.indices.end());
+                meshlets.push_back(renderable.meshlets);
+            }
+        }
+    };
+    
+    /**
+     * Retrieves the number of bytes that constructing a MeshNode from the provided PreparedMesh uploads (at most, 
+     * as the indices may be narrowed)
+     * 
+     */
+    inline std::size_t uploadSize(const PreparedMesh& mesh) noexcept
+    {
+        return sizeof(float) * mesh.vertices.size() + sizeof(uint32_t) * mesh.indices.size();
+    }
+    
     class MeshNode : public AbstractSceneGraphNode
     {
+        /// Shares the shaders of MeshNode
+        friend class StaticBatchNode;
+        
+        /// The interleaved vertices, in a buffer object of their own or in a range of a BufferArena
+        std::unique_ptr<VertexBuffer<float>> buffer;
+        
+        /// The indices of every sub-mesh, concatenated and stored at the narrowest sufficient width
+        std::unique_ptr<StaticDrawAdaptiveIndexBuffer> indexBuffer;
+        
+        /// The vertices (as buffer, which owns them) and indices when they are allocated from a BufferArena, in 
+        /// which case indexBuffer is not used
+        ArenaTriangleBuffer<float>* arenaBuffer = nullptr;
+        std::unique_ptr<ArenaIndexBuffer> arenaIndexBuffer;
+        
+        /// The range of a sub-mesh within the index buffer
+        typedef PreparedMesh::SubMesh SubMesh;
+        
+        std::vector<SubMesh> subMeshes;
         
-        Mesh mesh;
+        /// The Meshlets of each sub-mesh (empty for those that are drawn whole)
+        std::vector<std::vector<Meshlet>> meshlets;
         
-        std::unique_ptr<StaticDrawTriangleBuffer<float>> buffer;
-        std::vector<std::pair<std::size_t, std::unique_ptr<StaticDrawIndexBuffer<std::size_t>>>> indexBuffers;
+        /// The draws of the current frame (retained to avoid reallocating every frame)
+        DrawCommandBuffer commands;
         
         Program program;
         const static std::string VERTEX_SHADER_SRC;
         const static std::string FRAGMENT_SHADER_SRC;
         
+        /**
+         * Creates the attribute pointers of the vertex buffer, and attaches the program to the FrameUniforms
+         * 
+         */
+        void addAttributes()
+        {
+            program.setUniformBlockBinding(FRAME_UNIFORM_BLOCK, FRAME_UNIFORM_BINDING);
+            
+            constexpr GLsizei STRIDE = Mesh::INTERLEAVED_SIZE * sizeof(float);
+            buffer->addAttributePointer("position", 3, GL_FLOAT, GL_FALSE, STRIDE, reinterpret_cast<GLvoid*>(0));
+            buffer->addAttributePointer("uv_in", 2, GL_FLOAT, GL_FALSE, STRIDE, reinterpret_cast<GLvoid*>(6 * sizeof(float)));
+        }
+        
       public:
         
-        MeshNode(const Mesh& mesh) : mesh(mesh), program(VertexShader(VERTEX_SHADER_SRC), FragmentShader(FRAGMENT_SHADER_SRC))
+        /**
+         * Uploads the provided Mesh
+         * 
+         * The interleaved vertex data is built in a single pass and moved into the VertexBuffer, so no copy of the 
+         * Mesh is retained by this MeshNode.  The Meshlets of sub-meshes that have them (see Mesh::buildMeshlets) 
+         * are tested against the viewpoint every frame, and those that face away from it are not drawn.  The indices 
+         * of every sub-mesh share one index buffer, so the visible sub-meshes and Meshlets are submitted together 
+         * (see DrawCommandBuffer).  The camera is read from the FrameUniforms of the frame.
+         * 
+         * @param mesh the Mesh to render
+         * 
+         */
+        explicit MeshNode(const Mesh& mesh) : program(VertexShader(VERTEX_SHADER_SRC), FragmentShader(FRAGMENT_SHADER_SRC))
         {
-            std::vector<float> data;
-            
-
-            data.resize(mesh.getVertices().size() * 8);
-            
-            for(auto entry : mesh.getVertices())
+            std::vector<std::pair<const std::size_t*, std::size_t>> indices;
+            std::size_t firstIndex = 0;
+            for(const Mesh::Renderable& renderable : mesh.getMeshes())
             {
-                data.push_back(entry.getPosition()[0]);
-                data.push_back(entry.getPosition()[1]);
-                data.push_back(entry.getPosition()[2]);
-                data.push_back(entry.getNormal()[0]);
-                data.push_back(entry.getNormal()[1]);
-                data.push_back(entry.getNormal()[2]);
-                data.push_back(entry.getTexCoord()[0]);
-                data.push_back(entry.getTexCoord()[1]);
+                subMeshes.push_back(SubMesh{renderable.materialIndex, firstIndex, renderable.indices.size()});
+                indices.emplace_back(renderable.indices.data(), renderable.indices.size());
+                firstIndex += renderable.indices.size();
+                meshlets.push_back(renderable.meshlets);
             }
-            
-            
-            for(auto renderable : mesh.getMeshes())               
+            indexBuffer.reset(new StaticDrawAdaptiveIndexBuffer(indices));
+            buffer.reset(new StaticDrawTriangleBuffer<float>(mesh.getInterleavedVertices()));
+            addAttributes();
+        }
+        
+        /**
+         * Uploads the provided PreparedMesh, which is all that is left to do on the GL thread once a Mesh has been 
+         * prepared (see UploadQueue)
+         * 
+         * @param mesh the PreparedMesh to render
+         * 
+         */
+        explicit MeshNode(PreparedMesh&& mesh) : 
+            subMeshes(std::move(mesh.subMeshes)), 
+            meshlets(std::move(mesh.meshlets)), 
+            program(VertexShader(VERTEX_SHADER_SRC), FragmentShader(FRAGMENT_SHADER_SRC))
+        {
+            indexBuffer.reset(new StaticDrawAdaptiveIndexBuffer(mesh.indices));
+            buffer.reset(new StaticDrawTriangleBuffer<float>(std::move(mesh.vertices)));
+            addAttributes();
+        }
+        
+        /**
+         * Uploads the provided PreparedMesh to the provided BufferArena, so that it shares buffer objects with 
+         * the other meshes of the arena.  The base vertex and first index of the draws are looked up from the 
+         * ranges every frame, so the BufferArena may be defragmented between frames.
+         * 
+         * @param mesh the PreparedMesh to render
+         * 
+         * @param arena the BufferArena to allocate the vertices and indices from, which must outlive this MeshNode
+         * 
+         */
+        MeshNode(PreparedMesh&& mesh, BufferArena& arena) : 
+            subMeshes(std::move(mesh.subMeshes)), 
+            meshlets(std::move(mesh.meshlets)), 
+            program(VertexShader(VERTEX_SHADER_SRC), FragmentShader(FRAGMENT_SHADER_SRC))
+        {
+            arenaBuffer = new ArenaTriangleBuffer<float>(arena, mesh.vertices, Mesh::INTERLEAVED_SIZE * sizeof(float));
+            buffer.reset(arenaBuffer);
+            arenaIndexBuffer.reset(new ArenaIndexBuffer(arena, mesh.indices));
+            addAttributes();
+        }
+        
+        /**
+         * Uploads the provided MeshCache straight from its mapping, without building a Mesh (see io::loadMeshCache)
+         * 
+         * The MeshCache may be released once this MeshNode is constructed.  Cached meshes have no Meshlets, so 
+         * every sub-mesh is drawn whole.
+         * 
+         * @param cache the MeshCache to render
+         * 
+         */
+        explicit MeshNode(const MeshCache& cache) : program(VertexShader(VERTEX_SHADER_SRC), FragmentShader(FRAGMENT_SHADER_SRC))
+        {
+            std::size_t firstIndex = 0;
+            for(std::size_t i = 0; i < cache.getRenderableCount(); ++i)
             {
-                std::vector<std::size_t> indices;
-                for(auto index : renderable.indices)
-                    indices.push_back(index);
-                indexBuffers.push_back(std::make_pair(renderable.materialIndex, std::unique_ptr<StaticDrawIndexBuffer<std::size_t>>(new StaticDrawIndexBuffer<std::size_t>(indices))));
+                subMeshes.push_back(SubMesh{cache.getMaterialIndex(i), firstIndex, cache.getIndexCount(i)});
+                firstIndex += cache.getIndexCount(i);
             }
-            
-            buffer.reset(new StaticDrawTriangleBuffer<float>(data));
-            
-            buffer->addAttributePointer("position", 3, GL_FLOAT, GL_FALSE, 0, 0);
-            buffer->addAttributePointer("uv_in", 2, GL_FLOAT, GL_FALSE, 0, reinterpret_cast<GLvoid*>(48 * 6));
+            meshlets.resize(subMeshes.size());
+            indexBuffer.reset(new StaticDrawAdaptiveIndexBuffer(cache.getIndexLists()));
+            buffer.reset(new StaticDrawTriangleBuffer<float>(cache.getInterleavedVertices(), cache.getVertexCount() * Mesh::INTERLEAVED_SIZE));
+            addAttributes();
         }
-
-        MeshNode(Mesh&& mesh);
         
         virtual void render(const Camera& camera) override
         {
@@ -75,15 +232,51 @@ namespace midnight
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP);*/
         
 		program.bind();
-		program.setUniform("offset", camera.getPosition());
-		program.setMatrixUniform("projection", camera.getProjection());
-		program.setMatrixUniform("orientation", camera.getOrientation());
 		buffer->bind();
-        glDrawElements(
-     GL_TRIANGLES, 
-     static_cast<GLsizei>(mesh.getMeshes()[0].indices.size()),
-     GL_UNSIGNED_INT, 
-     (void*)0);
+        /// The vertex shader offsets positions by the camera position, so the viewpoint is its negation
+        const float eye[3] = {-camera.getPosition()[0], -camera.getPosition()[1], -camera.getPosition()[2]};
+        float planes[6][4];
+        camera.getFrustumPlanes(planes);
+        
+        /// Draws from a BufferArena are offset by its ranges
+        GLint baseVertex = 0;
+        std::size_t baseIndex = 0;
+        if(arenaBuffer != nullptr)
+        {
+            baseVertex = arenaBuffer->getBaseVertex();
+            baseIndex = arenaIndexBuffer->getFirstIndex();
+        }
+        commands.clear();
+        for(std::size_t i = 0; i < subMeshes.size(); ++i)
+        {
+            if(meshlets[i].empty())
+            {
+                commands.add(static_cast<GLuint>(subMeshes[i].indexCount), static_cast<GLuint>(baseIndex + subMeshes[i].firstIndex), baseVertex);
+                continue;
+            }
+            /// Meshlets index from the start of their sub-mesh, and adjacent visible ones are merged by add
+            for(const Meshlet& meshlet : meshlets[i])
+            {
+                /// The sphere test is the cheaper of the two, and rejects more of a typical scene
+                if(!isOutside(meshlet, planes, 6) && !isBackFacing(meshlet, eye))
+                {
+                    commands.add(static_cast<GLuint>(meshlet.indexCount), 
+                        static_cast<GLuint>(baseIndex + subMeshes[i].firstIndex + meshlet.firstIndex), baseVertex);
+                }
+            }
+        }
+        if(arenaIndexBuffer)
+        {
+            arenaIndexBuffer->bind();
+            commands.submit(GL_TRIANGLES, arenaIndexBuffer->getType());
+            arenaIndexBuffer->unbind();
+        }
+        else
+        {
+            indexBuffer->bind();
+            commands.submit(GL_TRIANGLES, indexBuffer->getType());
+            indexBuffer->unbind();
+        }
         // TODO: Vertex Class with equ-ops
 //		glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(mesh.getMeshes()[0].indices.size()));
 		buffer->unbind();
@@ -100,14 +293,11 @@ namespace midnight
         }
     };
     
-    const std::string MeshNode::VERTEX_SHADER_SRC = 
-        "#version 130\n\
+    const std::string MeshNode::VERTEX_SHADER_SRC = std::string(
+        "#version 130\n") + FRAME_UNIFORM_BLOCK_SRC + "\
         in vec3 position;\n\
         in vec2 uv_in;\n\
         out vec2 uv_out;\n\
-        uniform vec3 offset;\n\
-        uniform mat4 projection;\n\
-        uniform mat4 orientation;\n\
         void main()\n\
         {\n\
             vec4 cameraPos = vec4(position.x, position.y, position.z, 1.0) + vec4(offset.x, offset.y, offset.z, 0.0);\n\
@@ -0,0 +1,151 @@
+#ifndef MESH_OPTIMIZER_HPP
+#define MESH_OPTIMIZER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "Vertex.hpp"
+
+namespace midnight
+{
+    /**
+     * An enumeration of the ways in which the faces around a vertex may contribute to its normal
+     *
+     */
+    enum class NormalWeighting
+    {
+        AREA, /** Each face contributes in proportion to its area */
+        ANGLE, /** Each face contributes in proportion to its angle at the vertex */
+        AREA_AND_ANGLE /** Each face contributes in proportion to both */
+    };
+
+    /**
+     * Computes the average cache miss ratio (transformed vertices per triangle) of the provided triangle list
+     * under a FIFO post-transform cache
+     *
+     * @param indices the triangle list to measure
+     *
+     * @param vertexCount the number of vertices that the indices refer to
+     *
+     * @param cacheSize the number of entries in the simulated cache
+     *
+     * @return the average number of cache misses per triangle (between 0.5 and 3 for meaningful meshes)
+     *
+     * @throws IllegalArgumentException if the indices do not form a triangle list over vertexCount vertices
+     *
+     */
+    float computeACMR(const std::vector<std::size_t>& indices, std::size_t vertexCount, std::size_t cacheSize = 16);
+
+    /**
+     * Reorders the triangles of the provided triangle list so that they reuse recently transformed vertices,
+     * using Tom Forsyth's linear-speed vertex cache optimization.
+     *
+     * The result is tuned to an LRU cache of 32 entries, which also performs well on the FIFO caches of real
+     * hardware.
+     *
+     * @param indices the triangle list to reorder
+     *
+     * @param vertexCount the number of vertices that the indices refer to
+     *
+     * @throws IllegalArgumentException if the indices do not form a triangle list over vertexCount vertices
+     *
+     */
+    void optimizeVertexCache(std::vector<std::size_t>& indices, std::size_t vertexCount);
+
+    /**
+     * Reorders clusters of a cache-optimized triangle list so that outward-facing clusters are drawn first,
+     * which lets early depth testing reject more of the hidden fragments.
+     *
+     * The triangle list is split where the cache is cold (every vertex of a triangle misses), and the clusters
+     * are sorted by how far they face away from the centre of the mesh.  The reordering is abandoned if it
+     * would raise the cache miss ratio above the provided threshold.
+     *
+     * @param indices the cache-optimized triangle list to reorder
+     *
+     * @param vertices the vertices that the indices refer to
+     *
+     * @param threshold the largest acceptable ratio of the resulting cache miss ratio to the original one
+     *
+     * @throws IllegalArgumentException if the indices do not form a triangle list over the provided vertices
+     *
+     */
+    void optimizeOverdraw(std::vector<std::size_t>& indices, const std::vector<Vertex32F>& vertices, float threshold = 1.05f);
+
+    /**
+     * Finds the duplicate vertices of the provided array.
+     *
+     * Every attribute (position, normal and texture coordinates) is quantized to a grid of the provided
+     * epsilon, and vertices whose quantized attributes all match are merged into the first of them.  Vertices
+     * that are closer than epsilon but fall on either side of a grid line are not merged.  An epsilon of zero
+     * merges bitwise-identical vertices only (treating -0 as 0).
+     *
+     * The vertices are hashed into a shared open-addressing table by several threads; the result does not
+     * depend upon the number of threads.
+     *
+     * @param vertices the vertices to weld
+     *
+     * @param remap populated with the new index of each vertex - unique vertices are numbered in order of
+     * their first occurrence
+     *
+     * @param epsilon the quantization step of every attribute
+     *
+     * @param threadCount the number of threads to hash with, or 0 to use every hardware thread
+     *
+     * @return the number of unique vertices
+     *
+     * @throws IllegalArgumentException if epsilon is negative
+     *
+     */
+    std::size_t weldVertices(const std::vector<Vertex32F>& vertices, std::vector<std::size_t>& remap, float epsilon = 0.0f,
+        std::size_t threadCount = 0);
+
+    /**
+     * Computes smooth vertex normals from the faces of the provided triangle list.
+     *
+     * The faces are first evaluated in parallel into structure-of-arrays form, and then each vertex gathers the
+     * faces around it through a vertex-to-face adjacency, so no thread ever writes to shared data.  The result
+     * does not depend upon the number of threads.
+     *
+     * @param vertices the vertices that the indices refer to
+     *
+     * @param indices the triangle list
+     *
+     * @param weighting how the faces around each vertex contribute to its normal
+     *
+     * @param threadCount the number of threads to compute with, or 0 to use every hardware thread
+     *
+     * @return three floats (a unit normal) per vertex - vertices that no face with an area uses keep their
+     * current normal
+     *
+     * @throws IllegalArgumentException if the indices do not form a triangle list over the provided vertices
+     *
+     */
+    std::vector<float> computeVertexNormals(const std::vector<Vertex32F>& vertices, const std::vector<std::size_t>& indices,
+        NormalWeighting weighting = NormalWeighting::AREA_AND_ANGLE, std::size_t threadCount = 0);
+
+    /**
+     * Computes the tangent frames of the provided vertices from their texture coordinates, in the same manner
+     * as computeVertexNormals.
+     *
+     * The tangent of each face points along increasing u; the faces around each vertex are weighted by their
+     * angle at it, and the sum is made orthogonal to the normal of the vertex.
+     *
+     * @param vertices the vertices that the indices refer to, with their final normals
+     *
+     * @param indices the triangle list
+     *
+     * @param threadCount the number of threads to compute with, or 0 to use every hardware thread
+     *
+     * @return four floats per vertex: a unit tangent, and the handedness (1 or -1) of the bitangent, which is
+     * the cross product of the normal and the tangent multiplied by the handedness
+     *
+     * @throws IllegalArgumentException if the indices do not form a triangle list over the provided vertices
+     *
+     */
+    std::vector<float> computeVertexTangents(const std::vector<Vertex32F>& vertices, const std::vector<std::size_t>& indices,
+        std::size_t threadCount = 0);
+}
+
+#include "MeshOptimizer.inl"
+
+#endif
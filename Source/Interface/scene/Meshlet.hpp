@@ -0,0 +1,96 @@
+#ifndef MESHLET_HPP
+#define MESHLET_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "Vertex.hpp"
+
+namespace midnight
+{
+    /**
+     * A small cluster of the triangles of a sub-mesh, with the bounds needed to reject it before it is drawn.
+     *
+     * The normal cone bounds the facing of every triangle of the cluster: when the cluster is seen from within
+     * the cone (relative to its bounding sphere), every one of its triangles faces away from the viewer.
+     *
+     */
+    struct Meshlet
+    {
+        /// The first index of this Meshlet within the indices of its sub-mesh
+        std::size_t firstIndex;
+
+        /// The number of indices in this Meshlet
+        std::size_t indexCount;
+
+        /// The centre of the bounding sphere of this Meshlet
+        float center[3];
+
+        /// The radius of the bounding sphere of this Meshlet
+        float radius;
+
+        /// The (unit) axis of the normal cone of this Meshlet
+        float coneAxis[3];
+
+        /// The sine of the half-angle of the normal cone of this Meshlet, or 1 if the cone can never cull it
+        float coneCutoff;
+    };
+
+    /**
+     * Splits the provided triangle list into Meshlets.
+     *
+     * Each Meshlet is grown from a seed triangle by repeatedly adding the neighbouring triangle that brings in
+     * the fewest new vertices (preferring those that face the same way as the Meshlet), until either limit is
+     * reached.  The triangles are reordered so that those of each Meshlet are contiguous, so that each Meshlet
+     * may be drawn as a range of the indices.
+     *
+     * This is intended to run once, at import time, after any other reordering (see Mesh::optimize).
+     *
+     * @param indices the triangle list to split, which is reordered in place
+     *
+     * @param vertices the vertices that the indices refer to
+     *
+     * @param maxTriangles the largest number of triangles in a Meshlet
+     *
+     * @param maxVertices the largest number of distinct vertices in a Meshlet
+     *
+     * @return the Meshlets, in the order of their indices
+     *
+     * @throws IllegalArgumentException if the indices do not form a triangle list over the provided vertices, or
+     * if a limit is too small to hold a triangle
+     *
+     */
+    std::vector<Meshlet> buildMeshlets(std::vector<std::size_t>& indices, const std::vector<Vertex32F>& vertices,
+        std::size_t maxTriangles = 124, std::size_t maxVertices = 64);
+
+    /**
+     * Determines whether every triangle of the provided Meshlet faces away from the provided viewpoint
+     *
+     * @param meshlet the Meshlet to test
+     *
+     * @param eye the viewpoint, in the space of the Meshlet
+     *
+     * @return true if the Meshlet may be skipped, otherwise false
+     *
+     */
+    bool isBackFacing(const Meshlet& meshlet, const float eye[3]) noexcept;
+
+    /**
+     * Determines whether the bounding sphere of the provided Meshlet lies wholly outside any of the provided planes
+     *
+     * @param meshlet the Meshlet to test
+     *
+     * @param planes the planes (a, b, c, d), whose inside is where ax + by + cz + d >= 0, in the space of the
+     * Meshlet - the frustum planes of the viewer, for instance
+     *
+     * @param planeCount the number of planes
+     *
+     * @return true if the Meshlet may be skipped, otherwise false
+     *
+     */
+    bool isOutside(const Meshlet& meshlet, const float (*planes)[4], std::size_t planeCount) noexcept;
+}
+
+#include "Meshlet.inl"
+
+#endif
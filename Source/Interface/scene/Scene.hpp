@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "Camera.hpp"
+#include "FrameUniforms.hpp"
 #include "Program.hpp"
 #include "SceneGraphNode.hpp"
 
@@ -20,6 +21,9 @@ class Scene
 //    Program program;
     
     Camera camera;
+    
+    /// The camera and lighting data that every node reads
+    FrameUniforms frameUniforms;
    
   public:
 
@@ -34,8 +38,26 @@ class Scene
         sceneGraph.push_back(node);
     }
 
+    /**
+     * Retrieves the per-frame uniforms of this Scene, to set its lighting
+     * 
+     * @return the per-frame uniforms of this Scene
+     * 
+     */
+    FrameUniforms& getFrameUniforms() noexcept
+    {
+        return frameUniforms;
+    }
+
+    /**
+     * Uploads the camera and lighting data of the frame once, then renders every node
+     * 
+     * @param camera the Camera to render from
+     * 
+     */
     void render(const Camera& camera)
     {
+        frameUniforms.update(camera);
         for(const auto& node : sceneGraph)
         {
             node->render(camera);
@@ -18,6 +18,7 @@
 
 #include "Program.hpp"
 #include "AbstractSceneGraphNode.hpp"
+#include "FrameUniforms.hpp"
 #include "Texture.hpp"
 #include "VertexBuffer.hpp"
 
@@ -0,0 +1,141 @@
+#ifndef STATIC_BATCH_HPP
+#define STATIC_BATCH_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "Matrix.hpp"
+#include "Mesh.hpp"
+
+namespace midnight
+{
+    /**
+     * Merges many static meshes into one vertex array and one index array per Material, so that they may be
+     * drawn with a single buffer bind and one draw call per Material.
+     *
+     * Vertices are transformed into world space as they are added, so the batch is only suitable for meshes
+     * that never move.  Every sub-mesh that is added is recorded as a Range of its Material's indices along
+     * with a bounding sphere, so that culled sub-meshes may still be skipped when the batch is drawn.
+     *
+     */
+    class StaticBatch
+    {
+      public:
+
+        /**
+         * The indices of every sub-mesh that shares a Material
+         *
+         */
+        struct Group
+        {
+            /// The Material of this Group
+            Material material;
+
+            /// The triangle list of this Group, indexing the vertices of the batch
+            std::vector<uint32_t> indices;
+
+            explicit Group(const Material& material) : material(material)
+            {
+
+            }
+        };
+
+        /**
+         * A single sub-mesh of the batch
+         *
+         */
+        struct Range
+        {
+            /// The index of the Group that holds this Range
+            std::size_t group;
+
+            /// The first index of this Range, within its Group
+            std::size_t firstIndex;
+
+            /// The number of indices in this Range
+            std::size_t indexCount;
+
+            /// The centre of the world-space bounding sphere of this Range
+            float center[3];
+
+            /// The radius of the world-space bounding sphere of this Range
+            float radius;
+        };
+
+      private:
+
+        /// The interleaved (Mesh::INTERLEAVED_SIZE floats) world-space vertices of every added mesh
+        std::vector<float> vertices;
+
+        /// The Groups, in order of their first use
+        std::vector<Group> groups;
+
+        /// The Ranges, in the order that they were added
+        std::vector<Range> ranges;
+
+        /**
+         * Finds the Group of the provided Material, creating it if there is none
+         *
+         */
+        std::size_t findGroup(const Material& material);
+
+      public:
+
+        StaticBatch() = default;
+
+        /**
+         * Adds the provided Mesh to this batch, placed by the provided transformation
+         *
+         * Normals are transformed by the inverse transpose of the transformation and renormalized, and the
+         * winding of each triangle is reversed if the transformation mirrors the Mesh.
+         *
+         * @param mesh the Mesh to add
+         *
+         * @param transformation the transformation from the space of the Mesh to world space, applied to row vectors
+         * (as Camera and Matrix::translate do)
+         *
+         * @return the index of the Range of the first sub-mesh of the Mesh - the other sub-meshes follow it in
+         * order
+         *
+         * @throws IllegalArgumentException if the batch would address more than 2^32 vertices
+         *
+         */
+        std::size_t add(const Mesh& mesh, const Matrix4x4F& transformation = Matrix4x4F::IDENTITY());
+
+        /**
+         * Retrieves the number of vertices in this batch
+         *
+         * @return the number of vertices in this batch
+         *
+         */
+        std::size_t getVertexCount() const noexcept;
+
+        /**
+         * Retrieves the interleaved world-space vertices of this batch (see Mesh::getInterleavedVertices)
+         *
+         * @return the interleaved world-space vertices of this batch
+         *
+         */
+        const std::vector<float>& getVertices() const noexcept;
+
+        /**
+         * Retrieves the Groups of this batch
+         *
+         * @return the Groups of this batch
+         *
+         */
+        const std::vector<Group>& getGroups() const noexcept;
+
+        /**
+         * Retrieves the Ranges of this batch
+         *
+         * @return the Ranges of this batch, in the order that they were added
+         *
+         */
+        const std::vector<Range>& getRanges() const noexcept;
+    };
+}
+
+#include "StaticBatch.inl"
+
+#endif
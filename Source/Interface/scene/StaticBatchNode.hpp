@@ -0,0 +1,250 @@
+#ifndef STATIC_BATCH_NODE_HPP
+#define STATIC_BATCH_NODE_HPP
+
+#include "AbstractSceneGraphNode.hpp"
+#include "ArenaVertexBuffer.hpp"
+#include "BufferArena.hpp"
+#include "DrawCommandBuffer.hpp"
+#include "IndexBuffer.hpp"
+#include "VertexBuffer.hpp"
+#include "MeshNode.hpp"
+#include "StaticBatch.hpp"
+#include "Program.hpp"
+
+#include <memory>
+
+namespace midnight
+{
+    namespace detail
+    {
+        /**
+         * The Ranges of a StaticBatch, arranged by Group in the order that StaticBatchNode concatenates the
+         * indices of the Groups
+         *
+         */
+        class StaticBatchRanges
+        {
+            /// The Ranges of the batch
+            std::vector<StaticBatch::Range> ranges;
+
+            /// The first index of each Group within the concatenated indices
+            std::vector<std::size_t> groupOffsets;
+
+            /// The Ranges of each Group, in ascending order of their first index
+            std::vector<std::vector<std::size_t>> groupRanges;
+
+          public:
+
+            explicit StaticBatchRanges(const StaticBatch& batch) :
+                ranges(batch.getRanges()),
+                groupRanges(batch.getGroups().size())
+            {
+                std::size_t offset = 0;
+                for(const StaticBatch::Group& group : batch.getGroups())
+                {
+                    groupOffsets.push_back(offset);
+                    offset += group.indices.size();
+                }
+                for(std::size_t i = 0; i < ranges.size(); ++i)
+                {
+                    groupRanges[ranges[i].group].push_back(i);
+                }
+            }
+
+            /**
+             * Retrieves the Ranges of the batch
+             *
+             * @return the Ranges of the batch, in the order that they were added
+             *
+             */
+            const std::vector<StaticBatch::Range>& getRanges() const noexcept
+            {
+                return ranges;
+            }
+
+            /**
+             * Adds a draw of each visible Range to the provided DrawCommandBuffer, Group by Group, which merges
+             * the runs of Ranges that are adjacent in the concatenated indices into one draw
+             *
+             * @param visible whether each Range is to be drawn
+             *
+             * @param firstIndex the position of the concatenated indices within the element buffer
+             *
+             * @param baseVertex the position of the vertices of the batch within the vertex buffer
+             *
+             * @param commands the DrawCommandBuffer to add the draws to
+             *
+             */
+            void addDraws(const std::vector<bool>& visible, std::size_t firstIndex, GLint baseVertex, DrawCommandBuffer& commands) const
+            {
+                for(std::size_t group = 0; group < groupRanges.size(); ++group)
+                {
+                    for(std::size_t range : groupRanges[group])
+                    {
+                        if(visible[range])
+                        {
+                            commands.add(static_cast<GLuint>(ranges[range].indexCount),
+                                static_cast<GLuint>(firstIndex + groupOffsets[group] + ranges[range].firstIndex), baseVertex);
+                        }
+                    }
+                }
+            }
+        };
+    }
+
+    /**
+     * Renders a StaticBatch with one vertex buffer, one index buffer and one submission of draws
+     * (see DrawCommandBuffer).
+     *
+     * The vertices and indices are allocated from a BufferArena, which may be shared by many StaticBatchNodes
+     * so that they share buffer objects.  The base vertex and first index of the draws are looked up from the
+     * ranges every frame, so the BufferArena may be defragmented between frames.
+     *
+     * Every Range of the batch is visible by default.  Ranges that are hidden (for instance by a culling pass
+     * that tests the bounding sphere of each Range) are left out of the draw, and runs of adjacent visible
+     * Ranges are drawn as one.
+     *
+     * The Materials of the Groups are not applied yet: every Group is drawn with the textured shader of
+     * MeshNode, so the grouping only decides the order of the indices.
+     *
+     */
+    class StaticBatchNode : public AbstractSceneGraphNode
+    {
+        /// The BufferArena of this StaticBatchNode alone, if it was not given one to share
+        std::unique_ptr<BufferArena> ownedArena;
+
+        std::unique_ptr<ArenaTriangleBuffer<float>> buffer;
+
+        /// The indices of every Group, concatenated
+        std::unique_ptr<ArenaIndexBuffer> indexBuffer;
+
+        /// The Ranges of the batch, by Group
+        detail::StaticBatchRanges ranges;
+
+        /// Whether each Range is to be drawn
+        std::vector<bool> visible;
+
+        /// The draws of the current frame (retained to avoid reallocating every frame)
+        DrawCommandBuffer commands;
+
+        Program program;
+
+        /**
+         * Uploads the provided StaticBatch to the provided BufferArena, or to one of its own if there is none
+         *
+         */
+        StaticBatchNode(const StaticBatch& batch, BufferArena* arena) :
+            ranges(batch),
+            visible(batch.getRanges().size(), true),
+            program(VertexShader(MeshNode::VERTEX_SHADER_SRC), FragmentShader(MeshNode::FRAGMENT_SHADER_SRC))
+        {
+            constexpr GLsizei STRIDE = Mesh::INTERLEAVED_SIZE * sizeof(float);
+            std::vector<uint32_t> indices;
+            for(const StaticBatch::Group& group : batch.getGroups())
+            {
+                indices.insert(indices.end(), group.indices.begin(), group.indices.end());
+            }
+            if(arena == nullptr)
+            {
+                /// Large enough for the vertices and the widest indices after them (with the padding that aligns them)
+                ownedArena.reset(new BufferArena(sizeof(float) * batch.getVertices().size() + sizeof(uint32_t) * (indices.size() + 1)));
+                arena = ownedArena.get();
+            }
+            buffer.reset(new ArenaTriangleBuffer<float>(*arena, batch.getVertices(), STRIDE));
+            indexBuffer.reset(new ArenaIndexBuffer(*arena, indices));
+            program.setUniformBlockBinding(FRAME_UNIFORM_BLOCK, FRAME_UNIFORM_BINDING);
+
+            /// The vertices are already in world space, so the shader of MeshNode applies unchanged
+            buffer->addAttributePointer("position", 3, GL_FLOAT, GL_FALSE, STRIDE, reinterpret_cast<GLvoid*>(0));
+            buffer->addAttributePointer("uv_in", 2, GL_FLOAT, GL_FALSE, STRIDE, reinterpret_cast<GLvoid*>(6 * sizeof(float)));
+        }
+
+      public:
+
+        /**
+         * Uploads the provided StaticBatch to a BufferArena of its own
+         *
+         * @param batch the StaticBatch to render
+         *
+         */
+        explicit StaticBatchNode(const StaticBatch& batch) :
+            StaticBatchNode(batch, nullptr)
+        {
+        }
+
+        /**
+         * Uploads the provided StaticBatch to the provided BufferArena
+         *
+         * @param batch the StaticBatch to render
+         *
+         * @param arena the BufferArena to allocate the vertices and indices from, which must outlive this
+         * StaticBatchNode
+         *
+         */
+        StaticBatchNode(const StaticBatch& batch, BufferArena& arena) :
+            StaticBatchNode(batch, &arena)
+        {
+        }
+
+        /**
+         * Retrieves the Ranges of the batch, whose bounding spheres may be tested to decide their visibility
+         *
+         * @return the Ranges of the batch
+         *
+         */
+        const std::vector<StaticBatch::Range>& getRanges() const noexcept
+        {
+            return ranges.getRanges();
+        }
+
+        /**
+         * Shows or hides the provided Range
+         *
+         * @param range the index of the Range
+         *
+         * @param visible whether the Range is to be drawn
+         *
+         */
+        void setVisible(std::size_t range, bool visible)
+        {
+            this->visible.at(range) = visible;
+        }
+
+        /**
+         * Determines whether the provided Range is to be drawn
+         *
+         * @param range the index of the Range
+         *
+         * @return true if the Range is to be drawn, otherwise false
+         *
+         */
+        bool isVisible(std::size_t range) const
+        {
+            return visible.at(range);
+        }
+
+        virtual void render(const Camera& camera) override
+        {
+            program.bind();
+            buffer->bind();
+            indexBuffer->bind();
+            /// No Material state changes between Groups yet, so every visible Range is submitted together
+            commands.clear();
+            ranges.addDraws(visible, indexBuffer->getFirstIndex(), buffer->getBaseVertex(), commands);
+            commands.submit(GL_TRIANGLES, indexBuffer->getType());
+            indexBuffer->unbind();
+            buffer->unbind();
+            program.unbind();
+
+            /// Render my children
+            this->AbstractSceneGraphNode::render(camera);
+        }
+
+        virtual bool isPickable() override
+        {
+            return true;
+        }
+    };
+}
+
+#endif
@@ -8,7 +8,10 @@
 #include "DirectionalLight.hpp"
 
 #include "Heightmap.hpp"
+#include "HeightmapPyramid.hpp"
 #include "AbstractSceneGraphNode.hpp"
+#include "FrameUniforms.hpp"
+#include "TerrainIndexer.hpp"
 #include "TextureProvider.hpp"
 #include "Program.hpp"
 
@@ -18,15 +21,92 @@
 
 namespace midnight
 {
+    /**
+     * The data of a Terrain that is prepared off the GL thread (see UploadQueue) - its heightmap and min/max 
+     * pyramid, its interleaved vertices and strip indices, and the pixels of its texture - so that constructing 
+     * the Terrain from it on the GL thread only uploads.
+     * 
+     */
+    template<typename T>
+    struct PreparedTerrain
+    {
+        T verticalScale;
+        
+        T horizontalScale;
+        
+        Heightmap heightmap;
+        
+        HeightmapPyramid pyramid;
+        
+        /// The interleaved vertices of the whole heightmap
+        std::vector<T> vertices;
+        
+        /// The strip indices and tiles of the whole heightmap
+        TerrainIndexer indexer;
+        
+        /// The dimensions and RGBA pixels of the texture
+        std::size_t textureWidth;
+        std::size_t textureHeight;
+        std::vector<unsigned char> texturePixels;
+        
+        /**
+         * Builds the vertices, indices and pyramid of the provided heightmap
+         * 
+         * @param heightmap the heightmap of the Terrain
+         * 
+         * @param textureWidth the width of the texture of the Terrain
+         * 
+         * @param textureHeight the height of the texture of the Terrain
+         * 
+         * @param texturePixels the pixels of the texture of the Terrain, 4 bytes (RGBA) per pixel
+         * 
+         * @param verticalScale the vertical scale of the Terrain
+         * 
+         * @param horizontalScale the horizontal scale of the Terrain
+         * 
+         */
+        PreparedTerrain(Heightmap&& heightmap, std::size_t textureWidth, std::size_t textureHeight, 
+                std::vector<unsigned char>&& texturePixels, T verticalScale = 1.0f, T horizontalScale = 1.0f);
+        
+        /**
+         * Loads the heightmap and decodes the texture of a Terrain through their providers (see 
+         * io::loadHeightmap and io::loadPixels), and builds its vertices, indices and pyramid
+         * 
+         * @param heightmapFile the file to load the heightmap of the Terrain from
+         * 
+         * @param texturemapFile the file to load the texture of the Terrain from
+         * 
+         * @param verticalScale the vertical scale of the Terrain
+         * 
+         * @param horizontalScale the horizontal scale of the Terrain
+         * 
+         */
+        PreparedTerrain(const std::string& heightmapFile, const std::string& texturemapFile, T verticalScale = 1.0f, 
+                T horizontalScale = 1.0f);
+    };
+    
+    /**
+     * Retrieves the number of bytes that constructing a Terrain from the provided PreparedTerrain uploads
+     * 
+     */
+    template<typename T>
+    std::size_t uploadSize(const PreparedTerrain<T>& terrain) noexcept;
+    
     template<typename T>
     class Terrain : public AbstractSceneGraphNode
     {
+        /// Builds the vertices of the Terrain
+        friend struct PreparedTerrain<T>;
+        
         /// The vertex shader source for static Terrains
         static const std::string VERTEX_SHADER_SRC;
         
         /// The fragment shader source for static Terrains
         static const std::string FRAGMENT_SHADER_SRC;
         
+        /// The number of elements in each vertex (position, texture coordinates and normal)
+        static constexpr std::size_t DATA_COUNT = 8;
+        
         /// The vertical scale of this Terrain
         T verticalScale;
         
@@ -36,6 +116,9 @@ namespace midnight
         /// The height samples of this Terrain
         Heightmap heightmap;
         
+        /// The min/max hierarchy used to accelerate ray queries against this Terrain
+        HeightmapPyramid pyramid;
+        
         /// The texture of this Terrain
         Texture texture;
         
@@ -43,10 +126,19 @@ namespace midnight
         Program program;
 
         /// A triangle buffer that holds the vertex data of this Terrain
-        std::unique_ptr<StaticDrawTriangleBuffer<T>> vertexData;
+        std::unique_ptr<VertexBuffer<T>> vertexData;
+        
+        /// The triangle strip indices of this triangle buffer to render (see TerrainIndexer)
+        std::unique_ptr<StaticDrawIndexBuffer<uint16_t>> indexBuffer;
         
-        /// The indices of this triangle buffer to render
-        std::unique_ptr<StaticDrawIndexBuffer<uint32_t>> indexBuffer;
+        /// The number of indices in each tile of the index buffer
+        std::vector<GLsizei> tileCounts;
+        
+        /// The byte offset of each tile in the index buffer
+        std::vector<const GLvoid*> tileOffsets;
+        
+        /// The vertex that the indices of each tile are relative to
+        std::vector<GLint> tileBaseVertices;
         
         /// The ambient lighting of this Terrain
         AmbientLight<float> ambientLighting;
@@ -54,16 +146,110 @@ namespace midnight
         /// The directional lighting of this Terrain
         DirectionalLight<float> directionalLighting;
         
+        /**
+         * Transforms the provided ray from world space into heightmap space
+         * 
+         */
+        Line<T, 3> toHeightmapSpace(const Line<T, 3>& ray) const;
+        
+        /**
+         * Computes the position of the vertex at the provided sample coordinates of the provided heightmap
+         * 
+         */
+        static Point<T, 3> getPosition(const Heightmap& heightmap, T verticalScale, std::size_t i, std::size_t j);
+        
+        /**
+         * Builds the interleaved vertex data of the provided region of the provided heightmap, in row-major order
+         * 
+         * @param heightmap the heightmap to build the vertices of
+         * 
+         * @param verticalScale the vertical scale of the Terrain
+         * 
+         * @param region the region of vertices to build
+         * 
+         * @param vertices populated with DATA_COUNT elements for each vertex of the region
+         * 
+         */
+        static void buildVertices(const Heightmap& heightmap, T verticalScale, const Heightmap::Region& region, std::vector<T>& vertices);
+        
+        
       public:
 
-        Terrain(const std::string& heightmapFile, const std::string& texturemapFile, T verticalScale = 1.0f, T horizontalScale = 1.0f);
+        /**
+         * Constructs a Terrain
+         * 
+         * @param heightmapFile the file to load the heightmap of this Terrain from
+         * 
+         * @param texturemapFile the file to load the texture of this Terrain from
+         * 
+         * @param verticalScale the vertical scale of this Terrain
+         * 
+         * @param horizontalScale the horizontal scale of this Terrain
+         * 
+         * @param editable whether the heightmap of this Terrain is expected to be modified frequently
+         * 
+         */
+        Terrain(const std::string& heightmapFile, const std::string& texturemapFile, T verticalScale = 1.0f, T horizontalScale = 1.0f, bool editable = false);
+        
+        /**
+         * Constructs a Terrain from data that was prepared off the GL thread, which is only uploaded
+         * 
+         * @param prepared the PreparedTerrain to upload
+         * 
+         * @param editable whether the heightmap of this Terrain is expected to be modified frequently
+         * 
+         */
+        explicit Terrain(PreparedTerrain<T>&& prepared, bool editable = false);
         
         void render(const Camera& camera) override;
             
         const Heightmap& getHeightmap() const;
+        
+        /**
+         * Retrieves the heightmap of this Terrain for modification
+         * 
+         * Samples that are modified through Heightmap::setSample (or marked with Heightmap::markDirty) are 
+         * applied to this Terrain by the next call to synchronize or render.
+         * 
+         * @return the heightmap of this Terrain
+         * 
+         */
+        Heightmap& getHeightmap();
+        
+        /**
+         * Applies the dirty region of the heightmap to this Terrain, recomputing and re-uploading only the 
+         * vertices within (and bordering) it
+         * 
+         */
+        void synchronize();
 
         virtual bool isPickable() override;
         
+        /**
+         * Finds the nearest intersection of the provided ray with the surface of this Terrain
+         * 
+         * @param ray the ray to cast (in world space)
+         * 
+         * @param hit populated with the distance (in multiples of the ray's vector), world space point 
+         * and world space normal of the intersection upon success
+         * 
+         * @return true if the ray intersects this Terrain, otherwise false
+         * 
+         */
+        bool pick(const Line<T, 3>& ray, HeightmapPyramid::Hit<T>& hit) const;
+        
+        /**
+         * Determines whether the surface of this Terrain obstructs the line of sight between two points
+         * 
+         * @param from the world space point to look from
+         * 
+         * @param to the world space point to look at
+         * 
+         * @return true if no part of this Terrain lies between the two points, otherwise false
+         * 
+         */
+        bool isVisible(const Point<T, 3>& from, const Point<T, 3>& to) const;
+        
         void setAmbience(const AmbientLight<float>& ambience);
         
     };
@@ -0,0 +1,101 @@
+#ifndef TERRAIN_INDEXER_HPP
+#define TERRAIN_INDEXER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "IllegalArgumentException.hpp"
+
+namespace midnight
+{
+    /**
+     * Generates the element indices for a regular grid of vertices (such as the one built by a Terrain).
+     *
+     * The grid is split into tiles that are at most TILE_QUADS quads wide.  Each tile is emitted as one
+     * triangle strip per row of quads, with consecutive strips separated by RESTART_INDEX.  Narrow tiles
+     * keep the previous strip's vertices in the post-transform cache, and since every index is relative to
+     * the first vertex of its tile, the indices of every tile fit into 16 bits.
+     *
+     * The vertices of the grid are expected to be laid out row-major (index = row * width + column).
+     *
+     */
+    class TerrainIndexer
+    {
+      public:
+
+        /// The maximum number of quads that a single tile spans horizontally
+        static constexpr std::size_t TILE_QUADS = 32;
+
+        /// The index that terminates a triangle strip (must be enabled via glPrimitiveRestartIndex)
+        static constexpr uint16_t RESTART_INDEX = 0xFFFF;
+
+        /**
+         * A contiguous range of indices that must be drawn relative to a base vertex
+         *
+         */
+        struct Tile
+        {
+            /// The offset (in indices, not bytes) of the first index of this Tile
+            std::size_t first;
+
+            /// The number of indices in this Tile (including restart indices)
+            std::size_t count;
+
+            /// The vertex that every index of this Tile is relative to
+            std::size_t baseVertex;
+        };
+
+      private:
+
+        /// The strip indices of every Tile
+        std::vector<uint16_t> indices;
+
+        /// The Tiles that partition the indices
+        std::vector<Tile> tiles;
+
+      public:
+
+        /**
+         * Generates the indices for a width * height grid of vertices
+         *
+         * @param width the number of vertices in each row of the grid
+         *
+         * @param height the number of rows in the grid
+         *
+         * @throws IllegalArgumentException if the grid is smaller than 2x2 or too wide to be addressed with
+         * 16 bit indices
+         *
+         */
+        TerrainIndexer(std::size_t width, std::size_t height);
+
+        /**
+         * Retrieves the generated indices
+         *
+         * @return the generated indices
+         *
+         */
+        const std::vector<uint16_t>& getIndices() const noexcept;
+
+        /**
+         * Retrieves the generated indices
+         *
+         * @return the generated indices
+         *
+         * @note [optimization] this method should be preferred when this TerrainIndexer is no longer needed
+         *
+         */
+        std::vector<uint16_t>&& releaseIndices() noexcept;
+
+        /**
+         * Retrieves the Tiles that partition the generated indices
+         *
+         * @return the Tiles that partition the generated indices
+         *
+         */
+        const std::vector<Tile>& getTiles() const noexcept;
+    };
+}
+
+#include "TerrainIndexer.inl"
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include "Platform.hpp"
+
+#if defined(MIDNIGHT_WINDOWS)
+#   error Support Coming Soon!
+#elif defined(MIDNIGHT_LINUX)
+#   include "MappedFile_Linux.hpp"
+#elif defined(MIDNIGHT_MAC)
+#   error Unsupported Platform
+#endif
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef MAPPED_FILE_LINUX
+#define MAPPED_FILE_LINUX
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "ResourceException.hpp"
+
+namespace midnight
+{
+    namespace internal
+    {
+        /**
+         * Retrieves the size and modification time (in nanoseconds since the epoch) of the provided file
+         * 
+         * @return true if the file exists, otherwise false
+         * 
+         */
+        inline bool getFileStatus(const std::string& path, uint64_t& size, int64_t& modified) noexcept
+        {
+            struct stat status;
+            if(::stat(path.c_str(), &status) != 0)
+            {
+                return false;
+            }
+            size = static_cast<uint64_t>(status.st_size);
+            /// To the nanosecond, so that a file that is rewritten within the same second is still told apart
+            modified = static_cast<int64_t>(status.st_mtim.tv_sec) * 1000000000 + static_cast<int64_t>(status.st_mtim.tv_nsec);
+            return true;
+        }
+        
+        /**
+         * A read-only, page-aligned mapping of an entire file
+         * 
+         */
+        class MappedFile
+        {
+            const void* data;
+            std::size_t size;
+            
+          public:
+            
+            explicit MappedFile(const std::string& path) :
+                data(nullptr),
+                size(0)
+            {
+                const int descriptor = ::open(path.c_str(), O_RDONLY);
+                if(descriptor == -1)
+                {
+                    throw midnight::ResourceException("Unable to open " + path + ": " + std::strerror(errno));
+                }
+                struct stat status;
+                if(::fstat(descriptor, &status) != 0)
+                {
+                    ::close(descriptor);
+                    throw midnight::ResourceException("Unable to stat " + path + ": " + std::strerror(errno));
+                }
+                size = static_cast<std::size_t>(status.st_size);
+                if(size != 0)
+                {
+                    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+                    if(mapping == MAP_FAILED)
+                    {
+                        ::close(descriptor);
+                        throw midnight::ResourceException("Unable to map " + path + ": " + std::strerror(errno));
+                    }
+                    data = mapping;
+                }
+                /// The mapping outlives the descriptor
+                ::close(descriptor);
+            }
+            
+            MappedFile(const MappedFile&) = delete;
+            
+            MappedFile& operator=(const MappedFile&) = delete;
+            
+            MappedFile(MappedFile&& rhs) noexcept :
+                data(rhs.data),
+                size(rhs.size)
+            {
+                rhs.data = nullptr;
+                rhs.size = 0;
+            }
+            
+            const void* getData() const noexcept
+            {
+                return data;
+            }
+            
+            std::size_t getSize() const noexcept
+            {
+                return size;
+            }
+            
+            ~MappedFile()
+            {
+                if(data != nullptr)
+                {
+                    ::munmap(const_cast<void*>(data), size);
+                }
+            }
+        };
+    }
+}
+
+#endif
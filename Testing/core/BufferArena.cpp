@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "Platform.hpp"
+#include "ArenaVertexBuffer.hpp"
+#include "BufferArena.hpp"
+#include "GLState.hpp"
+#include "IndexBuffer.hpp"
+using namespace midnight;
+
+namespace
+{
+	/// Reads back a range of the buffer object that holds the provided Handle
+	std::vector<uint8_t> readBack(const BufferArena& arena, BufferArena::Handle handle, std::size_t size)
+	{
+		std::vector<uint8_t> data(size);
+		GLState::current().bindBuffer(GL_COPY_READ_BUFFER, arena.getBuffer(handle));
+		glGetBufferSubData(GL_COPY_READ_BUFFER, static_cast<GLintptr>(arena.getOffset(handle)), static_cast<GLsizeiptr>(size), data.data());
+		GLState::current().bindBuffer(GL_COPY_READ_BUFFER, 0);
+		return data;
+	}
+
+	std::vector<uint8_t> pattern(std::size_t size, uint8_t seed)
+	{
+		std::vector<uint8_t> data(size);
+		for(std::size_t i = 0; i < size; ++i)
+		{
+			data[i] = static_cast<uint8_t>(seed + i * 7);
+		}
+		return data;
+	}
+}
+
+TEST(BufferArena, StateMachineInitialization)
+{
+	char* argv = new char[1];
+	int one = 1;
+	glutInit(&one, &argv);
+	glutInitDisplayMode(GLUT_DEPTH | GLUT_DOUBLE | GLUT_RGBA);
+	glutInitWindowPosition(100, 100);
+	glutInitWindowSize(320, 320);
+	glutCreateWindow("");
+	glewInit();
+}
+
+TEST(BufferArena, InvalidAllocation)
+{
+	ASSERT_THROW(BufferArena(0), IllegalArgumentException);
+
+	BufferArena arena(256);
+	ASSERT_THROW(arena.allocate(0, 4), IllegalArgumentException);
+	ASSERT_THROW(arena.allocate(16, 0), IllegalArgumentException);
+
+	/// No buffer object is created for a rejected allocation
+	ASSERT_EQ(0u, arena.getArenaCount());
+}
+
+TEST(BufferArena, Allocate)
+{
+	BufferArena arena(256);
+	const BufferArena::Handle a = arena.allocate(10, 1);
+	const BufferArena::Handle b = arena.allocate(24, 12);
+	ASSERT_EQ(1u, arena.getArenaCount());
+	ASSERT_EQ(0u, arena.getOffset(a));
+	ASSERT_EQ(12u, arena.getOffset(b));
+	ASSERT_EQ(1, arena.getBaseVertex(b, 12));
+	ASSERT_EQ(arena.getBuffer(a), arena.getBuffer(b));
+	ASSERT_EQ(256u - 34u, arena.getFreeSize(0));
+
+	/// An allocation that fits no buffer object gets a new one, and one larger than arenaSize a larger one
+	const BufferArena::Handle c = arena.allocate(240, 4);
+	const BufferArena::Handle d = arena.allocate(1000, 4);
+	ASSERT_EQ(3u, arena.getArenaCount());
+	ASSERT_NE(arena.getBuffer(a), arena.getBuffer(c));
+	ASSERT_NE(arena.getBuffer(c), arena.getBuffer(d));
+	ASSERT_EQ(0u, arena.getOffset(d));
+	ASSERT_EQ(0u, arena.getFreeSize(2));
+
+	/// Released Handles are reused
+	arena.release(b);
+	arena.release(b);
+	ASSERT_EQ(b, arena.allocate(8, 4));
+	ASSERT_EQ(d + 1, arena.allocate(8, 4));
+}
+
+TEST(BufferArena, Upload)
+{
+	BufferArena arena(256);
+	const BufferArena::Handle a = arena.allocate(3, 1);
+	const BufferArena::Handle b = arena.allocate(64, 16);
+	const std::vector<uint8_t> data = pattern(64, 3);
+	arena.upload(b, data.data(), 64);
+	ASSERT_EQ(data, readBack(arena, b, 64));
+
+	const std::vector<uint8_t> part = pattern(8, 100);
+	arena.upload(b, part.data(), 8, 56);
+	std::vector<uint8_t> expected = data;
+	std::copy(part.begin(), part.end(), expected.begin() + 56);
+	ASSERT_EQ(expected, readBack(arena, b, 64));
+
+	ASSERT_THROW(arena.upload(a, data.data(), 4), IllegalArgumentException);
+	ASSERT_THROW(arena.upload(b, data.data(), 8, 57), IllegalArgumentException);
+}
+
+TEST(BufferArena, Defragment)
+{
+	BufferArena arena(256);
+	std::vector<BufferArena::Handle> handles;
+	for(std::size_t i = 0; i < 6; ++i)
+	{
+		handles.push_back(arena.allocate(32, 8));
+		const std::vector<uint8_t> data = pattern(32, static_cast<uint8_t>(i * 40));
+		arena.upload(handles.back(), data.data(), 32);
+	}
+
+	/// A buffer object whose allocations are all released, which defragment deletes
+	const BufferArena::Handle lone = arena.allocate(200, 4);
+	ASSERT_EQ(2u, arena.getArenaCount());
+	arena.release(lone);
+
+	/// The remaining allocations move down past the released ones, each by at least its own size
+	arena.release(handles[0]);
+	arena.release(handles[3]);
+	const GLuint buffer = arena.getBuffer(handles[1]);
+	ASSERT_TRUE(arena.defragment());
+	ASSERT_EQ(1u, arena.getArenaCount());
+	ASSERT_EQ(256u - 4 * 32u, arena.getFreeSize(0));
+
+	const std::size_t live[] = {1, 2, 4, 5};
+	for(std::size_t i = 0; i < 4; ++i)
+	{
+		const BufferArena::Handle handle = handles[live[i]];
+		ASSERT_EQ(buffer, arena.getBuffer(handle));
+		ASSERT_EQ(i * 32, arena.getOffset(handle));
+		ASSERT_EQ(pattern(32, static_cast<uint8_t>(live[i] * 40)), readBack(arena, handle, 32));
+	}
+	ASSERT_FALSE(arena.defragment());
+}
+
+TEST(BufferArena, DefragmentOverlapping)
+{
+	BufferArena arena(256);
+	const BufferArena::Handle gap = arena.allocate(16, 1);
+	const BufferArena::Handle moved = arena.allocate(96, 1);
+	const std::vector<uint8_t> data = pattern(96, 9);
+	arena.upload(moved, data.data(), 96);
+	arena.release(gap);
+
+	ASSERT_TRUE(arena.defragment());
+	ASSERT_EQ(0u, arena.getOffset(moved));
+	ASSERT_EQ(data, readBack(arena, moved, 96));
+}
+
+TEST(ArenaVertexBuffer, BaseVertex)
+{
+	BufferArena arena(256);
+	arena.allocate(5, 1);
+	const std::vector<float> vertices = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+	ArenaTriangleBuffer<float> buffer(arena, vertices, 3 * sizeof(float));
+	ASSERT_EQ(1, buffer.getBaseVertex());
+	ASSERT_EQ(2u, buffer.vertexCount());
+
+	ASSERT_THROW(ArenaTriangleBuffer<float>(arena, std::vector<float>(), 3 * sizeof(float)), IllegalArgumentException);
+	ASSERT_THROW(ArenaTriangleBuffer<float>(arena, vertices, 0), IllegalArgumentException);
+}
+
+TEST(ArenaVertexBuffer, SetVertexData)
+{
+	BufferArena arena(256);
+	ArenaTriangleBuffer<float> buffer(arena, std::vector<float>(9, 1.0f), 3 * sizeof(float));
+	const BufferArena::Handle range = buffer.getRange();
+
+	/// Data of the same size is uploaded in place
+	const std::vector<float> same = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f};
+	buffer.setVertexData(same);
+	ASSERT_EQ(range, buffer.getRange());
+
+	/// Data of another size is reallocated, and the old range released
+	const std::vector<float> larger(18, 2.0f);
+	buffer.setVertexData(larger);
+	const std::vector<uint8_t> bytes = readBack(arena, buffer.getRange(), larger.size() * sizeof(float));
+	ASSERT_EQ(0, std::memcmp(larger.data(), bytes.data(), bytes.size()));
+	ASSERT_EQ(256u - larger.size() * sizeof(float), arena.getFreeSize(0));
+	ASSERT_EQ(6u, buffer.vertexCount());
+
+	/// Moved to the start of the buffer object by defragment (through the scratch buffer, as the ranges
+	/// overlap), where the base vertex follows it
+	ASSERT_TRUE(arena.defragment());
+	ASSERT_EQ(0, buffer.getBaseVertex());
+	ASSERT_EQ(bytes, readBack(arena, buffer.getRange(), bytes.size()));
+}
+
+TEST(ArenaIndexBuffer, Narrowing)
+{
+	BufferArena arena(256);
+	arena.allocate(3, 1);
+	const std::vector<uint32_t> indices = {0, 300, 65535, 2};
+	ArenaIndexBuffer buffer(arena, indices);
+	ASSERT_EQ(static_cast<GLenum>(GL_UNSIGNED_SHORT), buffer.getType());
+	ASSERT_EQ(4u, buffer.getCount());
+	ASSERT_EQ(2u, buffer.getFirstIndex());
+
+	const std::vector<uint8_t> bytes = readBack(arena, buffer.getRange(), indices.size() * sizeof(uint16_t));
+	uint16_t narrowed[4];
+	std::memcpy(narrowed, bytes.data(), bytes.size());
+	for(std::size_t i = 0; i < indices.size(); ++i)
+	{
+		ASSERT_EQ(indices[i], narrowed[i]);
+	}
+
+	ArenaIndexBuffer bytesBuffer(arena, std::vector<uint32_t>{1, 2, 255});
+	ASSERT_EQ(static_cast<GLenum>(GL_UNSIGNED_BYTE), bytesBuffer.getType());
+	ASSERT_EQ(arena.getOffset(bytesBuffer.getRange()), bytesBuffer.getFirstIndex());
+
+	ASSERT_THROW(ArenaIndexBuffer(arena, std::vector<uint32_t>()), IllegalArgumentException);
+}
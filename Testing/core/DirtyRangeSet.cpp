@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include "DirtyRangeSet.hpp"
+using namespace midnight;
+
+namespace
+{
+	std::vector<std::pair<std::size_t, std::size_t>> ranges(const DirtyRangeSet& set)
+	{
+		std::vector<std::pair<std::size_t, std::size_t>> result;
+		for(const DirtyRangeSet::Range& range : set.getRanges())
+		{
+			result.emplace_back(range.first, range.last);
+		}
+		return result;
+	}
+
+	typedef std::vector<std::pair<std::size_t, std::size_t>> Ranges;
+}
+
+TEST(DirtyRangeSet, Add)
+{
+	DirtyRangeSet set;
+	ASSERT_TRUE(set.isEmpty());
+	set.add(5, 5);
+	ASSERT_TRUE(set.isEmpty());
+
+	set.add(10, 20);
+	set.add(40, 50);
+	set.add(0, 2);
+	ASSERT_EQ((Ranges{{0, 2}, {10, 20}, {40, 50}}), ranges(set));
+
+	/// Overlapping and touching ranges merge, and contained ones vanish
+	set.add(20, 25);
+	set.add(12, 14);
+	ASSERT_EQ((Ranges{{0, 2}, {10, 25}, {40, 50}}), ranges(set));
+	set.add(8, 45);
+	ASSERT_EQ((Ranges{{0, 2}, {8, 50}}), ranges(set));
+	ASSERT_EQ(44u, set.getSize());
+
+	set.clear();
+	ASSERT_TRUE(set.isEmpty());
+	ASSERT_EQ(0u, set.getSize());
+}
+
+TEST(DirtyRangeSet, Coalesce)
+{
+	DirtyRangeSet set;
+	for(std::size_t row = 0; row < 4; ++row)
+	{
+		set.add(row * 100, row * 100 + 10);
+	}
+	set.add(1000, 1010);
+
+	set.coalesce(89);
+	ASSERT_EQ(5u, set.getRanges().size());
+	set.coalesce(90);
+	ASSERT_EQ((Ranges{{0, 310}, {1000, 1010}}), ranges(set));
+	set.coalesce(1000);
+	ASSERT_EQ((Ranges{{0, 1010}}), ranges(set));
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include "Platform.hpp"
+#include "DrawCommandBuffer.hpp"
+using namespace midnight;
+
+TEST(DrawCommandBuffer, MergeContiguous)
+{
+	DrawCommandBuffer commands;
+	commands.add(6, 0, 4);
+	commands.add(3, 6, 4);
+	commands.add(9, 9, 4);
+	ASSERT_EQ(1u, commands.getCommands().size());
+	ASSERT_EQ(18u, commands.getCommands()[0].count);
+	ASSERT_EQ(0u, commands.getCommands()[0].firstIndex);
+	ASSERT_EQ(4, commands.getCommands()[0].baseVertex);
+	ASSERT_EQ(1u, commands.getCommands()[0].instanceCount);
+	ASSERT_EQ(0u, commands.getCommands()[0].baseInstance);
+}
+
+TEST(DrawCommandBuffer, KeepSeparate)
+{
+	DrawCommandBuffer commands;
+	commands.add(6, 0);
+
+	/// A gap, a draw that goes back, and a draw that differs in each of the other fields
+	commands.add(3, 9);
+	commands.add(3, 0);
+	commands.add(3, 3, 1);
+	commands.add(3, 6, 1, 2);
+	commands.add(3, 9, 1, 2, 5);
+	ASSERT_EQ(6u, commands.getCommands().size());
+
+	const GLuint firstIndices[] = {0, 9, 0, 3, 6, 9};
+	for(std::size_t i = 0; i < 6; ++i)
+	{
+		ASSERT_EQ(firstIndices[i], commands.getCommands()[i].firstIndex);
+	}
+	ASSERT_EQ(6u, commands.getCommands()[0].count);
+	ASSERT_EQ(2u, commands.getCommands()[4].instanceCount);
+	ASSERT_EQ(5u, commands.getCommands()[5].baseInstance);
+
+	/// Only the last draw is merged into
+	commands.add(3, 12, 1, 2, 5);
+	ASSERT_EQ(6u, commands.getCommands().size());
+	ASSERT_EQ(6u, commands.getCommands()[5].count);
+	commands.add(3, 3);
+	ASSERT_EQ(7u, commands.getCommands().size());
+}
+
+TEST(DrawCommandBuffer, EmptyDraws)
+{
+	DrawCommandBuffer commands;
+	commands.add(0, 0);
+	commands.add(3, 0, 0, 0);
+	ASSERT_TRUE(commands.getCommands().empty());
+
+	/// An empty draw does not interrupt a merge
+	commands.add(3, 0);
+	commands.add(0, 9);
+	commands.add(3, 3);
+	ASSERT_EQ(1u, commands.getCommands().size());
+	ASSERT_EQ(6u, commands.getCommands()[0].count);
+
+	commands.clear();
+	ASSERT_TRUE(commands.getCommands().empty());
+}
@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>
+
+#include "Platform.hpp"
+#include "VertexBuffer.hpp"
+#include "IndexBuffer.hpp"
+using namespace midnight;
+
+TEST(IndexBuffer, Type)
+{
+	ASSERT_EQ(static_cast<GLenum>(GL_UNSIGNED_BYTE), detail::IndexType<uint8_t>::value);
+	ASSERT_EQ(static_cast<GLenum>(GL_UNSIGNED_SHORT), detail::IndexType<uint16_t>::value);
+	ASSERT_EQ(static_cast<GLenum>(GL_UNSIGNED_INT), detail::IndexType<uint32_t>::value);
+	ASSERT_EQ(0u, detail::IndexType<uint64_t>::value);
+}
+
+TEST(AdaptiveIndexBuffer, SelectType)
+{
+	ASSERT_EQ(static_cast<GLenum>(GL_UNSIGNED_BYTE), StaticDrawAdaptiveIndexBuffer::selectType(0));
+	ASSERT_EQ(static_cast<GLenum>(GL_UNSIGNED_BYTE), StaticDrawAdaptiveIndexBuffer::selectType(255));
+	ASSERT_EQ(static_cast<GLenum>(GL_UNSIGNED_SHORT), StaticDrawAdaptiveIndexBuffer::selectType(256));
+	ASSERT_EQ(static_cast<GLenum>(GL_UNSIGNED_SHORT), StaticDrawAdaptiveIndexBuffer::selectType(65535));
+	ASSERT_EQ(static_cast<GLenum>(GL_UNSIGNED_INT), StaticDrawAdaptiveIndexBuffer::selectType(65536));
+	ASSERT_EQ(static_cast<GLenum>(GL_UNSIGNED_INT), StaticDrawAdaptiveIndexBuffer::selectType(0xFFFFFFFFu));
+	ASSERT_THROW(StaticDrawAdaptiveIndexBuffer::selectType(std::size_t(1) << 32), IllegalArgumentException);
+
+	ASSERT_EQ(1u, StaticDrawAdaptiveIndexBuffer::sizeOf(GL_UNSIGNED_BYTE));
+	ASSERT_EQ(2u, StaticDrawAdaptiveIndexBuffer::sizeOf(GL_UNSIGNED_SHORT));
+	ASSERT_EQ(4u, StaticDrawAdaptiveIndexBuffer::sizeOf(GL_UNSIGNED_INT));
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "RangeAllocator.hpp"
+#include "IllegalArgumentException.hpp"
+using namespace midnight;
+
+TEST(RangeAllocator, Allocate)
+{
+	RangeAllocator allocator(1000);
+	std::size_t a, b, c;
+	ASSERT_TRUE(allocator.allocate(100, 1, a));
+	ASSERT_TRUE(allocator.allocate(30, 32, b));
+	ASSERT_EQ(0u, a);
+	ASSERT_EQ(128u, b);
+
+	/// The padding before b is still free, and is the best fit for a small allocation
+	ASSERT_TRUE(allocator.allocate(20, 4, c));
+	ASSERT_EQ(100u, c);
+	ASSERT_EQ(1000u - 150u, allocator.getFreeSize());
+
+	std::size_t d;
+	ASSERT_FALSE(allocator.allocate(900, 1, d));
+	ASSERT_THROW(allocator.allocate(0, 1, d), IllegalArgumentException);
+	ASSERT_THROW(allocator.allocate(1, 0, d), IllegalArgumentException);
+}
+
+TEST(RangeAllocator, Release)
+{
+	RangeAllocator allocator(400);
+	std::size_t offsets[4];
+	for(std::size_t& offset : offsets)
+	{
+		ASSERT_TRUE(allocator.allocate(100, 1, offset));
+	}
+	ASSERT_EQ(0u, allocator.getFreeSize());
+
+	/// Released neighbours merge back into a single range
+	allocator.release(offsets[0], 100);
+	allocator.release(offsets[2], 100);
+	ASSERT_EQ(2u, allocator.getFreeRangeCount());
+	ASSERT_EQ(100u, allocator.getLargestFreeSize());
+	allocator.release(offsets[1], 100);
+	ASSERT_EQ(1u, allocator.getFreeRangeCount());
+	ASSERT_EQ(300u, allocator.getLargestFreeSize());
+	allocator.release(offsets[3], 100);
+	ASSERT_EQ(400u, allocator.getLargestFreeSize());
+}
+
+TEST(RangeAllocator, Random)
+{
+	/// Random allocations never overlap, and releasing them all restores a single free range
+	std::mt19937 random(3);
+	RangeAllocator allocator(1 << 16);
+	std::vector<std::pair<std::size_t, std::size_t>> live;
+	for(int step = 0; step < 2000; ++step)
+	{
+		if(live.empty() || random() % 3 != 0)
+		{
+			const std::size_t size = 1 + random() % 500;
+			std::size_t offset;
+			if(allocator.allocate(size, std::size_t(1) << (random() % 5), offset))
+			{
+				for(const std::pair<std::size_t, std::size_t>& other : live)
+				{
+					ASSERT_TRUE(offset + size <= other.first || other.first + other.second <= offset);
+				}
+				ASSERT_LE(offset + size, allocator.getCapacity());
+				live.emplace_back(offset, size);
+			}
+		}
+		else
+		{
+			const std::size_t i = random() % live.size();
+			allocator.release(live[i].first, live[i].second);
+			live[i] = live.back();
+			live.pop_back();
+		}
+	}
+	for(const std::pair<std::size_t, std::size_t>& range : live)
+	{
+		allocator.release(range.first, range.second);
+	}
+	ASSERT_EQ(1u, allocator.getFreeRangeCount());
+	ASSERT_EQ(allocator.getCapacity(), allocator.getLargestFreeSize());
+}
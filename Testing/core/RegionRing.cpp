@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "RegionRing.hpp"
+#include "IllegalArgumentException.hpp"
+using namespace midnight;
+
+TEST(RegionRing, Construct)
+{
+	ASSERT_THROW(RegionRing(0, 3), IllegalArgumentException);
+	ASSERT_THROW(RegionRing(16, 1), IllegalArgumentException);
+
+	RegionRing ring(16, 3);
+	ASSERT_EQ(0u, ring.getRegion());
+	ASSERT_EQ(16u, ring.getRegionCapacity());
+	ASSERT_EQ(3u, ring.getRegionCount());
+	ASSERT_EQ(48u, ring.getCapacity());
+	ASSERT_TRUE(ring.isRegionEmpty());
+}
+
+TEST(RegionRing, Advance)
+{
+	RegionRing ring(16, 3);
+	std::size_t offset;
+	ASSERT_TRUE(ring.allocate(10, 1, offset));
+	ASSERT_EQ(0u, offset);
+	ASSERT_TRUE(ring.allocate(6, 1, offset));
+	ASSERT_EQ(10u, offset);
+	ASSERT_FALSE(ring.isRegionEmpty());
+
+	/// A full region is never left on its own - the write fails until the ring is advanced
+	ASSERT_FALSE(ring.allocate(1, 1, offset));
+	ASSERT_EQ(0u, ring.getRegion());
+
+	ring.advance();
+	ASSERT_EQ(1u, ring.getRegion());
+	ASSERT_TRUE(ring.isRegionEmpty());
+	ASSERT_TRUE(ring.allocate(4, 1, offset));
+	ASSERT_EQ(16u, offset);
+
+	/// The last region wraps around to the first
+	ring.advance();
+	ASSERT_TRUE(ring.allocate(16, 1, offset));
+	ASSERT_EQ(32u, offset);
+	ring.advance();
+	ASSERT_EQ(0u, ring.getRegion());
+	ASSERT_TRUE(ring.allocate(1, 1, offset));
+	ASSERT_EQ(0u, offset);
+}
+
+TEST(RegionRing, Alignment)
+{
+	RegionRing ring(10, 3);
+	std::size_t offset;
+	ASSERT_TRUE(ring.allocate(1, 1, offset));
+	ASSERT_TRUE(ring.allocate(3, 3, offset));
+	ASSERT_EQ(3u, offset);
+	ASSERT_TRUE(ring.allocate(3, 3, offset));
+	ASSERT_EQ(6u, offset);
+
+	/// 9 is aligned, but the write would end past the region
+	ASSERT_FALSE(ring.allocate(3, 3, offset));
+
+	/// The second region starts at 10, so its first aligned write is at 12
+	ring.advance();
+	ASSERT_TRUE(ring.allocate(6, 3, offset));
+	ASSERT_EQ(12u, offset);
+	ASSERT_FALSE(ring.allocate(3, 3, offset));
+
+	/// The alignment may leave no room at all
+	ring.advance();
+	ASSERT_TRUE(ring.allocate(10, 1, offset));
+	ring.advance();
+	ASSERT_TRUE(ring.allocate(0, 4, offset));
+	ASSERT_EQ(0u, offset);
+	ASSERT_THROW(ring.allocate(1, 0, offset), IllegalArgumentException);
+}
+
+TEST(RegionRing, Grow)
+{
+	RegionRing ring(16, 3);
+	std::size_t offset;
+	ring.advance();
+	ASSERT_TRUE(ring.allocate(8, 1, offset));
+
+	/// Growing at least doubles the regions, and starts over at the first one
+	ring.grow(20);
+	ASSERT_EQ(32u, ring.getRegionCapacity());
+	ASSERT_EQ(96u, ring.getCapacity());
+	ASSERT_EQ(0u, ring.getRegion());
+	ASSERT_TRUE(ring.isRegionEmpty());
+
+	ring.grow(100);
+	ASSERT_EQ(100u, ring.getRegionCapacity());
+	ASSERT_TRUE(ring.allocate(100, 1, offset));
+	ASSERT_EQ(0u, offset);
+	ring.advance();
+	ASSERT_TRUE(ring.allocate(1, 1, offset));
+	ASSERT_EQ(100u, offset);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <thread>
+
+#include "UploadQueue.hpp"
+using namespace midnight;
+
+TEST(UploadQueue, Finish)
+{
+	UploadQueue queue(3);
+	std::vector<std::future<std::size_t>> results;
+	std::thread::id uploader;
+	for(std::size_t i = 0; i < 20; ++i)
+	{
+		results.push_back(queue.submit([i]
+		{
+			return std::vector<float>(i, 1.0f);
+		}, [&uploader](std::vector<float>&& data)
+		{
+			uploader = std::this_thread::get_id();
+			return data.size();
+		}));
+	}
+	ASSERT_EQ(20u, queue.finish());
+	ASSERT_EQ(0u, queue.getPendingCount());
+	ASSERT_EQ(std::this_thread::get_id(), uploader);
+	for(std::size_t i = 0; i < results.size(); ++i)
+	{
+		ASSERT_EQ(i, results[i].get());
+	}
+}
+
+TEST(UploadQueue, Budget)
+{
+	UploadQueue queue(2);
+	std::size_t uploaded = 0;
+	for(std::size_t i = 0; i < 10; ++i)
+	{
+		queue.submit([]
+		{
+			return std::vector<uint32_t>(256);
+		}, [&uploaded](std::vector<uint32_t>&&)
+		{
+			++uploaded;
+		});
+	}
+	while(queue.getReadyCount() != 10)
+	{
+		std::this_thread::yield();
+	}
+
+	/// Each job uploads 1 KiB, and one is always run however small the budget
+	ASSERT_EQ(1u, queue.drain(0, std::chrono::microseconds(0)));
+	ASSERT_EQ(9u, queue.getReadyCount());
+	ASSERT_EQ(3u, queue.drain(3 * 1024, std::chrono::seconds(1)));
+	ASSERT_EQ(1u, queue.drain(512, std::chrono::seconds(1)));
+	ASSERT_EQ(5u, queue.drain(static_cast<std::size_t>(-1), std::chrono::seconds(1)));
+	ASSERT_EQ(10u, uploaded);
+	ASSERT_EQ(0u, queue.drain(static_cast<std::size_t>(-1), std::chrono::seconds(1)));
+}
+
+TEST(UploadQueue, Exceptions)
+{
+	UploadQueue queue(1);
+	std::future<int> prepareFailure = queue.submit([]() -> int
+	{
+		throw std::runtime_error("prepare");
+	}, [](int&& value)
+	{
+		return value;
+	});
+	std::future<void> uploadFailure = queue.submit([]
+	{
+		return 1;
+	}, [](int&&)
+	{
+		throw std::runtime_error("upload");
+	});
+	ASSERT_EQ(1u, queue.finish());
+	ASSERT_THROW(prepareFailure.get(), std::runtime_error);
+	ASSERT_THROW(uploadFailure.get(), std::runtime_error);
+}
+
+TEST(UploadQueue, Abandon)
+{
+	std::future<int> result;
+	{
+		UploadQueue queue(1);
+		result = queue.submit([]
+		{
+			return 1;
+		}, [](int&& value)
+		{
+			return value;
+		});
+	}
+	ASSERT_THROW(result.get(), std::future_error);
+}
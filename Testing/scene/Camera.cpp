@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "Camera.hpp"
+using namespace midnight;
+
+namespace
+{
+	/// The clip coordinates of the provided point, computed the way the vertex shaders do
+	void clip(const Camera& camera, const float point[3], float result[4])
+	{
+		const Matrix4x4F projection = camera.getProjection();
+		const Matrix4x4F orientation = camera.getOrientation();
+		const float v[4] = {point[0] + camera.getPosition()[0], point[1] + camera.getPosition()[1], point[2] + camera.getPosition()[2], 1.0f};
+		float oriented[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+		for(std::size_t c = 0; c < 4; ++c)
+		{
+			for(std::size_t r = 0; r < 4; ++r)
+			{
+				oriented[c] += v[r] * orientation(r, c);
+			}
+		}
+		for(std::size_t c = 0; c < 4; ++c)
+		{
+			result[c] = 0.0f;
+			for(std::size_t r = 0; r < 4; ++r)
+			{
+				result[c] += oriented[r] * projection(r, c);
+			}
+		}
+	}
+}
+
+TEST(Camera, FrustumPlanesMatchClipSpace)
+{
+	Camera camera(60.0f, 1.0f, 0.5f, 50.0f);
+	camera.setPosition(Point3F(3.0f, -2.0f, 1.0f));
+	camera.rotate(Vector3F(0.0f, 1.0f, 0.0f), Radians<float>(0.7f));
+	float planes[6][4];
+	camera.getFrustumPlanes(planes);
+
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> coordinate(-60.0f, 60.0f);
+	std::size_t inside = 0;
+	for(std::size_t i = 0; i < 20000; ++i)
+	{
+		const float point[3] = {coordinate(random), coordinate(random), coordinate(random)};
+		float c[4];
+		clip(camera, point, c);
+		const float margin = 1e-3f * std::fabs(c[3]) + 1e-3f;
+		bool clipInside = true;
+		bool nearBoundary = false;
+		for(std::size_t axis = 0; axis < 3; ++axis)
+		{
+			clipInside = clipInside && std::fabs(c[axis]) <= c[3];
+			nearBoundary = nearBoundary || std::fabs(std::fabs(c[axis]) - std::fabs(c[3])) < margin;
+		}
+		if(nearBoundary)
+		{
+			continue;
+		}
+
+		bool planeInside = true;
+		for(std::size_t p = 0; p < 6; ++p)
+		{
+			planeInside = planeInside && planes[p][0] * point[0] + planes[p][1] * point[1] + planes[p][2] * point[2] + planes[p][3] >= 0.0f;
+		}
+		ASSERT_EQ(clipInside, planeInside);
+		inside += planeInside ? 1 : 0;
+	}
+
+	/// Make sure both outcomes were exercised
+	EXPECT_GT(inside, 0u);
+	EXPECT_LT(inside, 20000u);
+}
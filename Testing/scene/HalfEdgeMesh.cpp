@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include "HalfEdgeMesh.hpp"
+#include "IllegalArgumentException.hpp"
+using namespace midnight;
+
+namespace
+{
+	/// A copy of HalfEdgeMesh::NONE that the assertions may take by reference
+	const uint32_t NONE = HalfEdgeMesh::NONE;
+
+	/// The triangles of a unit cube whose faces share its eight corners
+	const std::vector<std::size_t> CUBE =
+	{
+		0, 2, 3, 0, 3, 1,
+		4, 5, 7, 4, 7, 6,
+		0, 4, 6, 0, 6, 2,
+		1, 3, 7, 1, 7, 5,
+		0, 1, 5, 0, 5, 4,
+		2, 6, 7, 2, 7, 3
+	};
+
+	/// A grid of size x size quads over (size + 1)^2 vertices
+	std::vector<std::size_t> grid(std::size_t size)
+	{
+		std::vector<std::size_t> indices;
+		for(std::size_t y = 0; y < size; ++y)
+		{
+			for(std::size_t x = 0; x < size; ++x)
+			{
+				const std::size_t v = y * (size + 1) + x;
+				indices.insert(indices.end(), {v, v + 1, v + size + 2, v, v + size + 2, v + size + 1});
+			}
+		}
+		return indices;
+	}
+
+	std::set<uint32_t> neighbours(const HalfEdgeMesh& mesh, uint32_t vertex)
+	{
+		std::set<uint32_t> result;
+		std::size_t visits = 0;
+		mesh.forEachNeighbour(vertex, [&](uint32_t neighbour)
+		{
+			result.insert(neighbour);
+			++visits;
+		});
+		EXPECT_EQ(result.size(), visits);
+		return result;
+	}
+}
+
+TEST(HalfEdgeMesh, Closed)
+{
+	const HalfEdgeMesh mesh(CUBE, 8);
+	ASSERT_EQ(8u, mesh.getVertexCount());
+	ASSERT_EQ(12u, mesh.getTriangleCount());
+	ASSERT_TRUE(mesh.isClosed());
+
+	for(uint32_t h = 0; h < mesh.getHalfEdgeCount(); ++h)
+	{
+		const uint32_t twin = mesh.getTwin(h);
+		ASSERT_NE(NONE, twin);
+		ASSERT_EQ(h, mesh.getTwin(twin));
+		ASSERT_EQ(mesh.getOrigin(h), mesh.getDestination(twin));
+		ASSERT_EQ(mesh.getDestination(h), mesh.getOrigin(twin));
+		ASSERT_EQ(h, mesh.getNext(mesh.getPrevious(h)));
+	}
+
+	/// Corner 0 meets the three adjacent corners and the diagonals of the faces whose triangles it splits
+	ASSERT_EQ((std::set<uint32_t>{1, 2, 3, 4, 5, 6}), neighbours(mesh, 0));
+	ASSERT_EQ(6u, mesh.getValence(0));
+	ASSERT_FALSE(mesh.isBoundaryVertex(0));
+
+	std::set<uint32_t> triangles;
+	mesh.forEachTriangle(7, [&](uint32_t triangle)
+	{
+		triangles.insert(triangle);
+	});
+	ASSERT_EQ((std::set<uint32_t>{2, 3, 6, 7, 10, 11}), triangles);
+	ASSERT_EQ(11u, mesh.getNeighbour(0, 1));
+}
+
+TEST(HalfEdgeMesh, Boundary)
+{
+	/// 3x3 quads over 4x4 vertices
+	const HalfEdgeMesh mesh(grid(3), 16);
+	ASSERT_FALSE(mesh.isClosed());
+
+	std::size_t boundaryEdges = 0;
+	for(uint32_t h = 0; h < mesh.getHalfEdgeCount(); ++h)
+	{
+		boundaryEdges += mesh.isBoundary(h) ? 1 : 0;
+	}
+	ASSERT_EQ(12u, boundaryEdges);
+
+	ASSERT_TRUE(mesh.isBoundaryVertex(0));
+	ASSERT_TRUE(mesh.isBoundaryVertex(1));
+	ASSERT_FALSE(mesh.isBoundaryVertex(5));
+
+	/// A corner that splits its quad, one that does not, an edge vertex and an interior vertex
+	ASSERT_EQ((std::set<uint32_t>{1, 4, 5}), neighbours(mesh, 0));
+	ASSERT_EQ((std::set<uint32_t>{2, 7}), neighbours(mesh, 3));
+	ASSERT_EQ((std::set<uint32_t>{0, 2, 5, 6}), neighbours(mesh, 1));
+	ASSERT_EQ((std::set<uint32_t>{0, 1, 4, 6, 9, 10}), neighbours(mesh, 5));
+	ASSERT_EQ(NONE, mesh.getNeighbour(0, 0));
+}
+
+TEST(HalfEdgeMesh, NonManifold)
+{
+	/// Three triangles that share the edge 0-1
+	const HalfEdgeMesh mesh(std::vector<std::size_t>{0, 1, 2, 1, 0, 3, 1, 0, 4}, 5);
+	for(uint32_t h = 0; h < mesh.getHalfEdgeCount(); ++h)
+	{
+		ASSERT_TRUE(mesh.isBoundary(h));
+	}
+	ASSERT_EQ((std::set<uint32_t>{1, 2, 3, 4}), neighbours(mesh, 0));
+}
+
+TEST(HalfEdgeMesh, ThreadCountIndependence)
+{
+	const std::vector<std::size_t> indices = grid(64);
+	const HalfEdgeMesh single(indices, 65 * 65, 1);
+	const HalfEdgeMesh multiple(indices, 65 * 65, 7);
+	for(uint32_t h = 0; h < single.getHalfEdgeCount(); ++h)
+	{
+		ASSERT_EQ(single.getTwin(h), multiple.getTwin(h));
+	}
+}
+
+TEST(HalfEdgeMesh, InvalidTriangleList)
+{
+	ASSERT_THROW(HalfEdgeMesh(std::vector<std::size_t>{0, 1}, 2), IllegalArgumentException);
+	ASSERT_THROW(HalfEdgeMesh(std::vector<std::size_t>{0, 1, 2}, 2), IllegalArgumentException);
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <string>
+
+#include "Heightmap.hpp"
+#include "HeightmapTesting.hpp"
+using namespace midnight;
+
+TEST(Heightmap, DirtyRegion)
+{
+	Heightmap heightmap(8, 6, std::vector<unsigned char>(8 * 6 * 4, 0));
+	ASSERT_TRUE(heightmap.getDirtyRegion().isEmpty());
+
+	heightmap.setSample(3, 2, 200);
+	ASSERT_EQ(200, heightmap.getSample(3, 2));
+	ASSERT_EQ(200, heightmap[(2 * 8 + 3) * 4 + 3]);
+	ASSERT_EQ(0, heightmap.getSample(4, 2));
+
+	heightmap.setSample(6, 1, 10);
+	heightmap.markDirty(Heightmap::Region{1, 4, 100, 100});
+	const Heightmap::Region& dirty = heightmap.getDirtyRegion();
+	ASSERT_EQ(1u, dirty.x0);
+	ASSERT_EQ(1u, dirty.y0);
+	ASSERT_EQ(8u, dirty.x1);
+	ASSERT_EQ(6u, dirty.y1);
+
+	heightmap.clearDirtyRegion();
+	ASSERT_TRUE(heightmap.getDirtyRegion().isEmpty());
+}
+
+namespace
+{
+	/// Sums central-difference normals over 64x64 blocks, as chunked normal generation would walk them
+	double generateNormals(const Heightmap& heightmap)
+	{
+		double sum = 0.0;
+		for(std::size_t by = 1; by < heightmap.getHeight() - 1; by += 64)
+		{
+			for(std::size_t bx = 1; bx < heightmap.getWidth() - 1; bx += 64)
+			{
+				for(std::size_t y = by; y < std::min(by + 64, heightmap.getHeight() - 1); ++y)
+				{
+					for(std::size_t x = bx; x < std::min(bx + 64, heightmap.getWidth() - 1); ++x)
+					{
+						const float dx = static_cast<float>(heightmap.getSample(x + 1, y)) - heightmap.getSample(x - 1, y);
+						const float dy = static_cast<float>(heightmap.getSample(x, y + 1)) - heightmap.getSample(x, y - 1);
+						sum += 2.0f / std::sqrt(dx * dx + dy * dy + 4.0f);
+					}
+				}
+			}
+		}
+		return sum;
+	}
+
+	/// Bilinearly samples along random short walks, as placement and physics queries would
+	double sample(const Heightmap& heightmap, unsigned seed)
+	{
+		std::mt19937 generator(seed);
+		std::uniform_real_distribution<float> column(0.0f, static_cast<float>(heightmap.getWidth() - 1));
+		std::uniform_real_distribution<float> row(0.0f, static_cast<float>(heightmap.getHeight() - 1));
+		std::uniform_real_distribution<float> step(-0.7f, 0.7f);
+		double sum = 0.0;
+		for(int walk = 0; walk < 20000; ++walk)
+		{
+			float x = column(generator);
+			float y = row(generator);
+			const float dx = step(generator);
+			const float dy = step(generator);
+			for(int i = 0; i < 64; ++i)
+			{
+				sum += heightmap.interpolate(x, y);
+				x = std::min(std::max(x + dx, 0.0f), static_cast<float>(heightmap.getWidth() - 1));
+				y = std::min(std::max(y + dy, 0.0f), static_cast<float>(heightmap.getHeight() - 1));
+			}
+		}
+		return sum;
+	}
+}
+
+TEST(Heightmap, Layout)
+{
+	for(std::size_t stride : {1u, 4u})
+	{
+		/// Deliberately not a multiple of the tile size
+		Heightmap heightmap = randomHeightmap(37, 21, stride, 1);
+		const std::vector<unsigned char> rows(heightmap.begin(), heightmap.end());
+
+		heightmap.setLayout(Heightmap::Layout::TILED);
+		ASSERT_EQ(Heightmap::Layout::TILED, heightmap.getLayout());
+		ASSERT_EQ(stride, heightmap.getStride());
+		for(std::size_t y = 0; y < 21; ++y)
+		{
+			for(std::size_t x = 0; x < 37; ++x)
+			{
+				ASSERT_EQ(rows[(y * 37 + x) * stride], heightmap.getSample(x, y));
+			}
+		}
+		ASSERT_EQ(rows, heightmap.toRowMajor());
+
+		heightmap.setSample(36, 20, 7);
+		heightmap.setLayout(Heightmap::Layout::ROW_MAJOR);
+		ASSERT_EQ(7, heightmap.getSample(36, 20));
+		ASSERT_EQ(rows.size(), static_cast<std::size_t>(heightmap.end() - heightmap.begin()));
+	}
+}
+
+TEST(Heightmap, Interpolate)
+{
+	Heightmap heightmap(2, 2, std::vector<unsigned char>{0, 100, 50, 250});
+	ASSERT_FLOAT_EQ(0.0f, heightmap.interpolate(0.0f, 0.0f));
+	ASSERT_FLOAT_EQ(250.0f, heightmap.interpolate(1.0f, 1.0f));
+	ASSERT_FLOAT_EQ(50.0f, heightmap.interpolate(0.5f, 0.0f));
+	ASSERT_FLOAT_EQ(100.0f, heightmap.interpolate(0.5f, 0.5f));
+}
+
+/// Run with --gtest_also_run_disabled_tests to compare the layouts
+TEST(Heightmap, DISABLED_LayoutBenchmark)
+{
+	for(std::size_t stride : {1u, 4u})
+	{
+		Heightmap heightmap = randomHeightmap(4096, 4096, stride, 2);
+		double rowMajorResults[2];
+		const double rowMajorNormals = seconds([&]{ rowMajorResults[0] = generateNormals(heightmap); });
+		const double rowMajorSampling = seconds([&]{ rowMajorResults[1] = sample(heightmap, 3); });
+
+		double tiledResults[2];
+		const double conversion = seconds([&]{ heightmap.setLayout(Heightmap::Layout::TILED); });
+		const double tiledNormals = seconds([&]{ tiledResults[0] = generateNormals(heightmap); });
+		const double tiledSampling = seconds([&]{ tiledResults[1] = sample(heightmap, 3); });
+		const double upload = seconds([&]{ heightmap.toRowMajor(); });
+
+		ASSERT_DOUBLE_EQ(rowMajorResults[0], tiledResults[0]);
+		ASSERT_DOUBLE_EQ(rowMajorResults[1], tiledResults[1]);
+
+		/// Reported in milliseconds, per stride
+		const std::string prefix = "Stride" + std::to_string(stride);
+		RecordProperty(prefix + "RowMajorNormals", static_cast<int>(rowMajorNormals * 1000.0));
+		RecordProperty(prefix + "TiledNormals", static_cast<int>(tiledNormals * 1000.0));
+		RecordProperty(prefix + "RowMajorSampling", static_cast<int>(rowMajorSampling * 1000.0));
+		RecordProperty(prefix + "TiledSampling", static_cast<int>(tiledSampling * 1000.0));
+		RecordProperty(prefix + "ToTiled", static_cast<int>(conversion * 1000.0));
+		RecordProperty(prefix + "ToRowMajor", static_cast<int>(upload * 1000.0));
+	}
+}
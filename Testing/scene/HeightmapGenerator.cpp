@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "HeightmapGenerator.hpp"
+#include "HeightmapTesting.hpp"
+using namespace midnight;
+
+namespace
+{
+	std::vector<unsigned char> samplesOf(const Heightmap& heightmap)
+	{
+		return std::vector<unsigned char>(heightmap.begin(), heightmap.end());
+	}
+}
+
+TEST(HeightmapGenerator, Dimensions)
+{
+	Heightmap heightmap = HeightmapGenerator(1).generate(100, 37);
+	ASSERT_EQ(100u, heightmap.getWidth());
+	ASSERT_EQ(37u, heightmap.getHeight());
+	ASSERT_EQ(1u, heightmap.getStride());
+}
+
+TEST(HeightmapGenerator, ThreadCountIndependence)
+{
+	HeightmapGenerator generator(42, HeightmapGenerator::Variant::DOMAIN_WARP);
+	generator.setThreadCount(1);
+	std::vector<unsigned char> single = samplesOf(generator.generate(300, 200));
+	generator.setThreadCount(7);
+	ASSERT_EQ(single, samplesOf(generator.generate(300, 200)));
+}
+
+TEST(HeightmapGenerator, SeedDependence)
+{
+	ASSERT_EQ(samplesOf(HeightmapGenerator(3).generate(64, 64)), samplesOf(HeightmapGenerator(3).generate(64, 64)));
+	ASSERT_NE(samplesOf(HeightmapGenerator(3).generate(64, 64)), samplesOf(HeightmapGenerator(4).generate(64, 64)));
+	ASSERT_NE(samplesOf(HeightmapGenerator(3).generate(64, 64)),
+			samplesOf(HeightmapGenerator(3, HeightmapGenerator::Variant::RIDGED).generate(64, 64)));
+}
+
+TEST(HeightmapGenerator, Smoothness)
+{
+	/// Neighbouring samples of low-frequency noise should never be far apart
+	HeightmapGenerator generator(9);
+	generator.setOctaves(1);
+	Heightmap heightmap = generator.generate(512, 512);
+	for(std::size_t y = 0; y < 512; ++y)
+	{
+		for(std::size_t x = 1; x < 512; ++x)
+		{
+			ASSERT_LE(std::abs(heightmap.getSample(x, y) - heightmap.getSample(x - 1, y)), 4);
+		}
+	}
+}
+
+TEST(HeightmapGenerator, ScalarMatchesSSE2)
+{
+#if defined(__SSE2__)
+	/// Points on either side of the origin, and exactly on lattice lines, where floor and truncation differ
+	std::mt19937 random(5);
+	std::uniform_real_distribution<float> coordinate(-70000.0f, 70000.0f);
+	std::vector<float> xs(4096);
+	std::vector<float> ys(4096);
+	for(std::size_t i = 0; i < xs.size(); ++i)
+	{
+		xs[i] = i % 16 == 0 ? std::floor(coordinate(random)) : coordinate(random);
+		ys[i] = i % 24 == 0 ? std::floor(coordinate(random)) : coordinate(random);
+	}
+
+	const uint32_t seeds[][2] = {{0, 0}, {detail::mixLattice(42), 0x1234}, {0xFFFF, 0xFFFF}};
+	for(const uint32_t* seed : seeds)
+	{
+		std::vector<float> scalar(xs.size());
+		std::vector<float> vector(xs.size());
+		detail::gradientNoiseScalar(xs.data(), ys.data(), scalar.data(), xs.size(), seed[0], seed[1]);
+		detail::gradientNoiseSSE2(xs.data(), ys.data(), vector.data(), xs.size(), seed[0], seed[1]);
+		for(std::size_t i = 0; i < xs.size(); ++i)
+		{
+			ASSERT_NEAR(scalar[i], vector[i], 1e-5f) << "at (" << xs[i] << ", " << ys[i] << ")";
+		}
+	}
+#endif
+}
+
+TEST(HeightmapGenerator, DISABLED_Benchmark)
+{
+	const HeightmapGenerator::Variant variants[] = {HeightmapGenerator::Variant::FBM, HeightmapGenerator::Variant::RIDGED,
+			HeightmapGenerator::Variant::DOMAIN_WARP};
+	const char* names[] = {"FBMMilliseconds", "RidgedMilliseconds", "DomainWarpMilliseconds"};
+	for(std::size_t i = 0; i < 3; ++i)
+	{
+		/// 8192x8192 samples on one thread
+		HeightmapGenerator generator(7, variants[i]);
+		generator.setThreadCount(1);
+		std::size_t checksum = 0;
+		const double elapsed = seconds([&]
+		{
+			Heightmap heightmap = generator.generate(8192, 8192);
+			for(unsigned char sample : heightmap)
+			{
+				checksum += sample;
+			}
+		});
+		ASSERT_NE(0u, checksum);
+		RecordProperty(names[i], static_cast<int>(elapsed * 1000.0));
+	}
+}
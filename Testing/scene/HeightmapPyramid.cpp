@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "HeightmapPyramid.hpp"
+#include "HeightmapTesting.hpp"
+using namespace midnight;
+
+TEST(HeightmapPyramid, Levels)
+{
+	Heightmap heightmap = randomHeightmap(17, 9, 1, 1);
+	HeightmapPyramid pyramid(heightmap);
+
+	/// 16x8 cells -> 8x4 -> 4x2 -> 2x1 -> 1x1
+	ASSERT_EQ(5u, pyramid.getLevelCount());
+
+	unsigned char minimum = 255;
+	unsigned char maximum = 0;
+	for(unsigned char sample : heightmap)
+	{
+		minimum = std::min(minimum, sample);
+		maximum = std::max(maximum, sample);
+	}
+	ASSERT_EQ(minimum, pyramid.getMinimum(4, 0, 0));
+	ASSERT_EQ(maximum, pyramid.getMaximum(4, 0, 0));
+}
+
+TEST(HeightmapPyramid, VerticalRay)
+{
+	std::vector<unsigned char> samples(4 * 4, 100);
+	HeightmapPyramid pyramid(Heightmap(4, 4, std::move(samples)));
+
+	HeightmapPyramid::Hit<float> hit;
+	ASSERT_TRUE(pyramid.intersect(Line3F(Point3F(1.5f, 300.0f, 2.25f), Vector3F(0.0f, -1.0f, 0.0f)), hit));
+	ASSERT_FLOAT_EQ(200.0f, hit.distance);
+	ASSERT_FLOAT_EQ(1.5f, hit.point[0]);
+	ASSERT_FLOAT_EQ(100.0f, hit.point[1]);
+	ASSERT_FLOAT_EQ(2.25f, hit.point[2]);
+	ASSERT_FLOAT_EQ(1.0f, hit.normal[1]);
+
+	/// Outside of the heightmap
+	ASSERT_FALSE(pyramid.intersect(Line3F(Point3F(5.0f, 300.0f, 2.0f), Vector3F(0.0f, -1.0f, 0.0f)), hit));
+
+	/// Stopped short of the surface
+	ASSERT_FALSE(pyramid.intersect(Line3F(Point3F(1.5f, 300.0f, 2.25f), Vector3F(0.0f, -1.0f, 0.0f)), hit, 199.0f));
+}
+
+TEST(HeightmapPyramid, MatchesBruteForce)
+{
+	const std::size_t width = 33;
+	const std::size_t height = 21;
+	Heightmap heightmap = randomHeightmap(width, height, 1, 7);
+	HeightmapPyramid pyramid(heightmap);
+
+	/// A single-cell pyramid per cell gives the reference result
+	std::mt19937 generator(11);
+	std::uniform_real_distribution<double> position(-5.0, 40.0);
+	std::uniform_real_distribution<double> elevation(0.0, 400.0);
+	for(int i = 0; i < 500; ++i)
+	{
+		Line3D ray(Point3D(position(generator), elevation(generator), position(generator)),
+				Point3D(position(generator), elevation(generator) - 350.0, position(generator)));
+
+		double nearest = std::numeric_limits<double>::infinity();
+		for(std::size_t z = 0; z < height - 1; ++z)
+		{
+			for(std::size_t x = 0; x < width - 1; ++x)
+			{
+				std::vector<unsigned char> cell =
+				{
+					heightmap.getSample(x, z), heightmap.getSample(x + 1, z),
+					heightmap.getSample(x, z + 1), heightmap.getSample(x + 1, z + 1)
+				};
+				HeightmapPyramid::Hit<double> hit;
+				Line3D local(Point3D(ray.getPoint()[0] - x, ray.getPoint()[1], ray.getPoint()[2] - z), ray.getVector());
+				if(HeightmapPyramid(Heightmap(2, 2, std::move(cell))).intersect(local, hit))
+				{
+					nearest = std::min(nearest, hit.distance);
+				}
+			}
+		}
+
+		HeightmapPyramid::Hit<double> hit;
+		bool intersected = pyramid.intersect(ray, hit);
+		ASSERT_EQ(nearest != std::numeric_limits<double>::infinity(), intersected);
+		if(intersected)
+		{
+			ASSERT_NEAR(nearest, hit.distance, 1e-9);
+		}
+	}
+}
+
+TEST(HeightmapPyramid, Update)
+{
+	Heightmap heightmap = randomHeightmap(37, 29, 1, 3);
+	HeightmapPyramid pyramid(heightmap);
+
+	std::mt19937 generator(5);
+	for(int i = 0; i < 50; ++i)
+	{
+		std::uniform_int_distribution<std::size_t> column(0, 36);
+		std::uniform_int_distribution<std::size_t> row(0, 28);
+		for(int j = 0; j < 4; ++j)
+		{
+			heightmap.setSample(column(generator), row(generator), static_cast<unsigned char>(generator() % 256));
+		}
+		pyramid.update(heightmap, heightmap.getDirtyRegion());
+		heightmap.clearDirtyRegion();
+
+		HeightmapPyramid rebuilt(heightmap);
+		for(std::size_t level = 0; level < rebuilt.getLevelCount(); ++level)
+		{
+			/// 36x28 cells, halved (rounding up) at each level
+			const std::size_t levelWidth = (36 + (1u << level) - 1) >> level;
+			const std::size_t levelHeight = (28 + (1u << level) - 1) >> level;
+			for(std::size_t z = 0; z < levelHeight; ++z)
+			{
+				for(std::size_t x = 0; x < levelWidth; ++x)
+				{
+					ASSERT_EQ(rebuilt.getMinimum(level, x, z), pyramid.getMinimum(level, x, z));
+					ASSERT_EQ(rebuilt.getMaximum(level, x, z), pyramid.getMaximum(level, x, z));
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,31 @@
+#ifndef HEIGHTMAP_TESTING_HPP
+#define HEIGHTMAP_TESTING_HPP
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "Heightmap.hpp"
+
+/// A Heightmap of uniformly random samples, each stride bytes wide
+inline midnight::Heightmap randomHeightmap(std::size_t width, std::size_t height, std::size_t stride, unsigned seed)
+{
+	std::mt19937 generator(seed);
+	std::vector<unsigned char> samples(width * height * stride);
+	for(unsigned char& sample : samples)
+	{
+		sample = static_cast<unsigned char>(generator());
+	}
+	return midnight::Heightmap(width, height, std::move(samples));
+}
+
+/// The wall-clock time that the provided function takes, for the disabled benchmarks
+template<typename F>
+double seconds(F function)
+{
+	const auto start = std::chrono::steady_clock::now();
+	function();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+#endif
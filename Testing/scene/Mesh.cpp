@@ -0,0 +1,23 @@
+#include <gtest/gtest.h>
+
+#include "Mesh.hpp"
+using namespace midnight;
+
+TEST(Mesh, InterleavedVertices)
+{
+	std::vector<Vertex32F> vertices =
+	{
+		Vertex32F(Point3F(1.0f, 2.0f, 3.0f), Vector3F(0.0f, 1.0f, 0.0f), Point2F(0.25f, 0.5f)),
+		Vertex32F(Point3F(4.0f, 5.0f, 6.0f), Vector3F(1.0f, 0.0f, 0.0f), Point2F(0.75f, 1.0f))
+	};
+	Mesh mesh(vertices, {}, {});
+
+	const std::vector<float> expected =
+	{
+		1.0f, 2.0f, 3.0f, 0.0f, 1.0f, 0.0f, 0.25f, 0.5f,
+		4.0f, 5.0f, 6.0f, 1.0f, 0.0f, 0.0f, 0.75f, 1.0f
+	};
+	const std::vector<float> interleaved = mesh.getInterleavedVertices();
+	ASSERT_EQ(expected, interleaved);
+	ASSERT_EQ(vertices.size() * Mesh::INTERLEAVED_SIZE, interleaved.capacity());
+}
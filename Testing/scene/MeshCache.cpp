@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "Platform.hpp"
+#include "IndexBuffer.hpp"
+#include "MeshCache.hpp"
+#include "MeshProvider.hpp"
+using namespace midnight;
+
+namespace
+{
+	Mesh cube()
+	{
+		std::vector<Vertex32F> vertices;
+		for(std::size_t i = 0; i < 8; ++i)
+		{
+			const float x = static_cast<float>(i & 1), y = static_cast<float>((i >> 1) & 1), z = static_cast<float>(i >> 2);
+			vertices.emplace_back(Point3F(x, y, z), Vector3F(x - 0.5f, y - 0.5f, z - 0.5f), Point2F(x, y));
+		}
+		std::vector<Material> materials =
+		{
+			Material(LightingMode::DIFFUSE, CullingMode::CULL_BACK_FACES, false, Color<float, 4>(0.1f, 0.2f, 0.3f, 1.0f)),
+			Material()
+		};
+		std::vector<Mesh::Renderable> renderables = {Mesh::Renderable(1), Mesh::Renderable(0)};
+		renderables[0].indices = {0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5};
+		renderables[1].indices = {0, 4, 5, 0, 5, 1};
+		return Mesh(vertices, materials, renderables);
+	}
+
+	/// Loads every file as the cube, and counts how often it is asked to
+	class CubeProvider : public spi::MeshProvider
+	{
+	  public:
+		std::size_t loads = 0;
+
+		bool isLoadableExtension(const std::string& extension) const noexcept override
+		{
+			return extension == ".cube";
+		}
+
+		Mesh loadMesh(const std::string&) override
+		{
+			++loads;
+			return cube();
+		}
+	};
+
+	void expectEqual(const Mesh& expected, const Mesh& actual)
+	{
+		ASSERT_EQ(expected.getInterleavedVertices(), actual.getInterleavedVertices());
+		ASSERT_EQ(expected.getMeshes().size(), actual.getMeshes().size());
+		for(std::size_t i = 0; i < expected.getMeshes().size(); ++i)
+		{
+			ASSERT_EQ(expected.getMeshes()[i].materialIndex, actual.getMeshes()[i].materialIndex);
+			ASSERT_EQ(expected.getMeshes()[i].indices, actual.getMeshes()[i].indices);
+		}
+		ASSERT_EQ(expected.getMaterials().size(), actual.getMaterials().size());
+		for(std::size_t i = 0; i < expected.getMaterials().size(); ++i)
+		{
+			const Material& a = expected.getMaterials()[i];
+			const Material& b = actual.getMaterials()[i];
+			ASSERT_EQ(a.getLightingMode(), b.getLightingMode());
+			ASSERT_EQ(a.getCullingMode(), b.getCullingMode());
+			ASSERT_EQ(a.autoNormalizes(), b.autoNormalizes());
+			for(std::size_t j = 0; j < 4; ++j)
+			{
+				ASSERT_EQ(a.getAmbience()[j], b.getAmbience()[j]);
+				ASSERT_EQ(a.getDiffusion()[j], b.getDiffusion()[j]);
+			}
+		}
+	}
+}
+
+TEST(MeshCache, FileRoundTrip)
+{
+	const std::string source = testing::TempDir() + "MeshCacheSource.obj";
+	const std::string path = source + MeshCache::EXTENSION;
+	std::ofstream(source) << "v 0 0 0\n";
+
+	const Mesh mesh = cube();
+	ASSERT_FALSE(MeshCache::isCurrent(path, source));
+	MeshCache::write(path, mesh, source);
+	ASSERT_TRUE(MeshCache::isCurrent(path, source));
+
+	MeshCache cache(path);
+	ASSERT_EQ(8u, cache.getVertexCount());
+	ASSERT_EQ(2u, cache.getRenderableCount());
+	ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(cache.getInterleavedVertices()) % MeshCache::ALIGNMENT);
+	ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(cache.getIndices(1)) % MeshCache::ALIGNMENT);
+	expectEqual(mesh, cache.toMesh());
+
+	/// Changing the source invalidates the cache
+	std::ofstream(source, std::ios::app) << "v 1 1 1\n";
+	ASSERT_FALSE(MeshCache::isCurrent(path, source));
+
+	std::remove(path.c_str());
+	std::remove(source.c_str());
+}
+
+TEST(MeshCache, StreamRoundTrip)
+{
+	const Mesh mesh = cube();
+	std::stringstream stream;
+	stream << mesh;
+
+	Mesh result({}, {}, {});
+	ASSERT_TRUE(static_cast<bool>(stream >> result));
+	expectEqual(mesh, result);
+}
+
+TEST(MeshCache, Rejection)
+{
+	std::stringstream stream;
+	stream << cube();
+	const std::string bytes = stream.str();
+
+	/// Wrong version
+	std::string modified = bytes;
+	modified[8] = static_cast<char>(MeshCache::VERSION + 1);
+	std::istringstream versioned(modified);
+	ASSERT_THROW(MeshCache cache(versioned), ResourceException);
+
+	/// Truncated
+	std::istringstream truncated(bytes.substr(0, bytes.size() - 1));
+	ASSERT_THROW(MeshCache cache(truncated), ResourceException);
+
+	/// A section offset that points outside the file
+	modified = bytes;
+	const uint64_t offset = bytes.size() + MeshCache::ALIGNMENT;
+	std::memcpy(&modified[offsetof(midnight::detail::MeshCacheHeader, vertexOffset)], &offset, sizeof(offset));
+	std::istringstream corrupt(modified);
+	ASSERT_THROW(MeshCache cache(corrupt), ResourceException);
+
+	/// Operator >> reports failure through the stream
+	std::istringstream garbage("not a mesh cache");
+	Mesh mesh({}, {}, {});
+	ASSERT_FALSE(static_cast<bool>(garbage >> mesh));
+
+	ASSERT_THROW(MeshCache(testing::TempDir() + "MissingMeshCache" + MeshCache::EXTENSION), ResourceException);
+}
+
+TEST(MeshCache, LoadMeshCache)
+{
+	const std::string source = testing::TempDir() + "MeshCacheSource.cube";
+	const std::string path = source + MeshCache::EXTENSION;
+	std::remove(path.c_str());
+	std::ofstream(source) << "cube";
+	const std::shared_ptr<CubeProvider> provider = std::make_shared<CubeProvider>();
+	spi::meshProviders.push_back(provider);
+
+	/// The normals of the cube are not of unit length, so they are repaired before it is cached
+	Mesh expected = cube();
+	ASSERT_FALSE(expected.hasValidNormals());
+	expected.recomputeNormals();
+
+	/// The first load goes through the provider and writes the cache, which the second one maps
+	expectEqual(expected, io::loadMeshCache(source).toMesh());
+	ASSERT_EQ(1u, provider->loads);
+	ASSERT_TRUE(MeshCache::isCurrent(path, source));
+	const MeshCache cache = io::loadMeshCache(source);
+	ASSERT_EQ(1u, provider->loads);
+	expectEqual(expected, cache.toMesh());
+	expectEqual(expected, io::loadMesh(source));
+	ASSERT_EQ(1u, provider->loads);
+
+	/// A changed source is loaded again
+	std::ofstream(source, std::ios::app) << " again";
+	io::loadMeshCache(source);
+	ASSERT_EQ(2u, provider->loads);
+
+	spi::meshProviders.pop_back();
+	std::remove(path.c_str());
+	std::remove(source.c_str());
+}
+
+TEST(MeshCache, IndexLists)
+{
+	std::stringstream stream;
+	stream << cube();
+	const MeshCache cache(stream);
+	const std::vector<std::pair<const uint32_t*, std::size_t>> lists = cache.getIndexLists();
+	ASSERT_EQ(2u, lists.size());
+
+	/// The sub-meshes are concatenated in order, and narrowed to the smallest type that holds them
+	std::size_t count;
+	ASSERT_EQ(7u, midnight::detail::maxIndex(lists, count));
+	ASSERT_EQ(18u, count);
+	ASSERT_EQ(static_cast<GLenum>(GL_UNSIGNED_BYTE), StaticDrawAdaptiveIndexBuffer::selectType(7));
+	std::vector<uint8_t> narrowed(count);
+	ASSERT_EQ(narrowed.data() + count, midnight::detail::narrowIndices(lists, narrowed.data()));
+	const std::vector<uint8_t> expected = {0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 4, 5, 0, 5, 1};
+	ASSERT_EQ(expected, narrowed);
+
+	/// Wider indices, with an empty list between them
+	const std::vector<uint32_t> low = {1, 300, 2};
+	const std::vector<uint32_t> high = {65535, 0};
+	const std::vector<std::pair<const uint32_t*, std::size_t>> wide = {{low.data(), low.size()}, {nullptr, 0}, {high.data(), high.size()}};
+	ASSERT_EQ(65535u, midnight::detail::maxIndex(wide, count));
+	ASSERT_EQ(5u, count);
+	ASSERT_EQ(static_cast<GLenum>(GL_UNSIGNED_SHORT), StaticDrawAdaptiveIndexBuffer::selectType(65535));
+	std::vector<uint16_t> shorts(count);
+	midnight::detail::narrowIndices(wide, shorts.data());
+	ASSERT_EQ((std::vector<uint16_t>{1, 300, 2, 65535, 0}), shorts);
+
+	ASSERT_EQ(0u, midnight::detail::maxIndex(std::vector<std::pair<const uint32_t*, std::size_t>>(), count));
+	ASSERT_EQ(0u, count);
+}
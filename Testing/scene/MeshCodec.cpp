@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#include "MeshCodec.hpp"
+#include "MeshOptimizer.hpp"
+#include "IllegalArgumentException.hpp"
+#include "ResourceException.hpp"
+using namespace midnight;
+
+namespace
+{
+	/// The interleaved vertices of a wavy grid of size x size quads
+	std::vector<float> grid(std::size_t size)
+	{
+		std::vector<float> vertices;
+		for(std::size_t y = 0; y <= size; ++y)
+		{
+			for(std::size_t x = 0; x <= size; ++x)
+			{
+				const float height = std::sin(x * 0.1f) * std::cos(y * 0.1f);
+				vertices.insert(vertices.end(), {x * 0.5f, height, y * 0.5f, 0.0f, 1.0f, 0.0f,
+					static_cast<float>(x) / size, static_cast<float>(y) / size});
+			}
+		}
+		return vertices;
+	}
+}
+
+TEST(MeshCodec, Indices)
+{
+	std::mt19937 random(7);
+	for(std::size_t count : {0, 1, 15, 16, 17, 1000})
+	{
+		std::vector<uint32_t> indices(count);
+		for(uint32_t& index : indices)
+		{
+			index = random();
+		}
+		const std::vector<uint8_t> encoded = encodeIndices(indices.data(), indices.size());
+		std::vector<uint32_t> decoded(count);
+		ASSERT_EQ(encoded.size(), decodeIndices(encoded.data(), encoded.size(), decoded.data(), count));
+		ASSERT_EQ(indices, decoded);
+	}
+}
+
+TEST(MeshCodec, ScalarDecode)
+{
+	/// Small and large differences of either sign, so that blocks hold many combinations of planes, and every 
+	/// fifth block repeats a value, so that it holds none
+	std::mt19937 random(11);
+	std::vector<uint32_t> values(16 * 64 + 5);
+	uint32_t value = 0;
+	for(std::size_t i = 0; i < values.size(); ++i)
+	{
+		if((i / 16) % 5 != 0)
+		{
+			const uint32_t spread = 1u << (random() % 32);
+			value += random() % spread - spread / 2;
+		}
+		values[i] = value;
+	}
+	std::vector<uint8_t> stream;
+	midnight::detail::encodeDeltaBlocks(values.data(), values.size(), stream);
+
+	const uint8_t* scalarPosition = stream.data();
+	uint32_t scalarPrevious = 0;
+	uint32_t scalar[midnight::detail::CODEC_BLOCK_SIZE];
+#if defined(__SSE2__)
+	const uint8_t* vectorPosition = stream.data();
+	uint32_t vectorPrevious = 0;
+	uint32_t vector[midnight::detail::CODEC_BLOCK_SIZE];
+#endif
+	for(std::size_t first = 0; first < values.size(); first += midnight::detail::CODEC_BLOCK_SIZE)
+	{
+		const uint8_t mask = *scalarPosition;
+		scalarPosition = midnight::detail::decodeDeltaPlanesScalar(mask, scalarPosition + 1, scalarPrevious, scalar);
+		for(std::size_t i = 0; i < midnight::detail::CODEC_BLOCK_SIZE && first + i < values.size(); ++i)
+		{
+			ASSERT_EQ(values[first + i], scalar[i]);
+		}
+#if defined(__SSE2__)
+		vectorPosition = midnight::detail::decodeDeltaPlanesSSE2(*vectorPosition, vectorPosition + 1, vectorPrevious, vector);
+		ASSERT_EQ(scalarPosition, vectorPosition);
+		ASSERT_EQ(scalarPrevious, vectorPrevious);
+		ASSERT_TRUE(std::equal(scalar, scalar + midnight::detail::CODEC_BLOCK_SIZE, vector));
+#endif
+	}
+	ASSERT_EQ(stream.data() + stream.size(), scalarPosition);
+}
+
+TEST(MeshCodec, IndexCompactness)
+{
+	/// A 64x64 grid, optimized and renumbered as Mesh::optimize does, needs about half of its 32-bit indices
+	const std::size_t size = 64;
+	std::vector<std::size_t> triangles;
+	for(std::size_t y = 0; y < size; ++y)
+	{
+		for(std::size_t x = 0; x < size; ++x)
+		{
+			const std::size_t v = y * (size + 1) + x;
+			triangles.insert(triangles.end(), {v, v + 1, v + size + 2, v, v + size + 2, v + size + 1});
+		}
+	}
+	optimizeVertexCache(triangles, (size + 1) * (size + 1));
+
+	std::vector<uint32_t> remap((size + 1) * (size + 1), UINT32_MAX);
+	std::vector<uint32_t> indices;
+	uint32_t next = 0;
+	for(std::size_t index : triangles)
+	{
+		if(remap[index] == UINT32_MAX)
+		{
+			remap[index] = next++;
+		}
+		indices.push_back(remap[index]);
+	}
+	const std::vector<uint8_t> encoded = encodeIndices(indices.data(), indices.size());
+	ASSERT_LT(encoded.size(), indices.size() * sizeof(uint32_t) * 9 / 16);
+}
+
+TEST(MeshCodec, LosslessVertices)
+{
+	std::vector<float> vertices = grid(20);
+	vertices[5] = -0.0f;
+	vertices[13] = std::numeric_limits<float>::quiet_NaN();
+	const std::size_t vertexCount = vertices.size() / Mesh::INTERLEAVED_SIZE;
+
+	const std::vector<uint8_t> encoded = encodeVertices(vertices.data(), vertexCount);
+	std::vector<float> decoded(vertices.size());
+	ASSERT_EQ(encoded.size(), decodeVertices(encoded.data(), encoded.size(), decoded.data(), vertexCount));
+	ASSERT_EQ(0, std::memcmp(vertices.data(), decoded.data(), vertices.size() * sizeof(float)));
+	ASSERT_LT(encoded.size(), vertices.size() * sizeof(float));
+}
+
+TEST(MeshCodec, QuantizedVertices)
+{
+	const std::vector<float> vertices = grid(40);
+	const std::size_t vertexCount = vertices.size() / Mesh::INTERLEAVED_SIZE;
+
+	const std::vector<uint8_t> encoded = encodeVertices(vertices.data(), vertexCount, VertexQuantization(16, 8, 12));
+	std::vector<float> decoded(vertices.size());
+	ASSERT_EQ(encoded.size(), decodeVertices(encoded.data(), encoded.size(), decoded.data(), vertexCount));
+	ASSERT_LT(encoded.size(), vertices.size() * sizeof(float) / 4);
+
+	/// Each attribute is within half a step of its range
+	const float tolerances[] = {20.0f / 65535, 2.0f / 65535, 20.0f / 65535, 0.0f, 0.0f, 0.0f, 1.0f / 4095, 1.0f / 4095};
+	for(std::size_t i = 0; i < vertices.size(); ++i)
+	{
+		ASSERT_NEAR(vertices[i], decoded[i], tolerances[i % Mesh::INTERLEAVED_SIZE] * 0.5f + 1e-6f);
+	}
+}
+
+TEST(MeshCodec, Streams)
+{
+	/// Encoded streams may be concatenated, as each decode reports how much it consumed
+	const uint32_t indices[] = {0, 1, 2, 2, 1, 3};
+	std::vector<uint8_t> encoded = encodeIndices(indices, 6);
+	const std::size_t indexSize = encoded.size();
+	const std::vector<float> vertices = grid(2);
+	const std::vector<uint8_t> encodedVertices = encodeVertices(vertices.data(), 9, VertexQuantization(12, 12, 12));
+	encoded.insert(encoded.end(), encodedVertices.begin(), encodedVertices.end());
+
+	uint32_t decodedIndices[6];
+	std::vector<float> decodedVertices(vertices.size());
+	ASSERT_EQ(indexSize, decodeIndices(encoded.data(), encoded.size(), decodedIndices, 6));
+	ASSERT_EQ(encodedVertices.size(), decodeVertices(encoded.data() + indexSize, encoded.size() - indexSize, decodedVertices.data(), 9));
+	ASSERT_TRUE(std::equal(indices, indices + 6, decodedIndices));
+}
+
+TEST(MeshCodec, InvalidStreams)
+{
+	const std::vector<float> vertices = grid(4);
+	ASSERT_THROW(encodeVertices(vertices.data(), 25, VertexQuantization(25)), IllegalArgumentException);
+
+	const std::vector<uint8_t> encoded = encodeVertices(vertices.data(), 25);
+	std::vector<float> decoded(vertices.size());
+	ASSERT_THROW(decodeVertices(encoded.data(), encoded.size() - 1, decoded.data(), 25), ResourceException);
+
+	const uint8_t corrupt[] = {0xFF};
+	uint32_t index;
+	ASSERT_THROW(decodeIndices(corrupt, 1, &index, 1), ResourceException);
+	ASSERT_THROW(decodeIndices(corrupt, 0, &index, 1), ResourceException);
+}
@@ -0,0 +1,319 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include "Mesh.hpp"
+using namespace midnight;
+
+namespace
+{
+	/// A grid of quads on the xz plane, with its triangles shuffled
+	Mesh shuffledGrid(std::size_t size, unsigned seed)
+	{
+		std::vector<Vertex32F> vertices;
+		for(std::size_t z = 0; z < size; ++z)
+		{
+			for(std::size_t x = 0; x < size; ++x)
+			{
+				vertices.emplace_back(Point3F(static_cast<float>(x), 0.0f, static_cast<float>(z)), Vector3F(0.0f, 1.0f, 0.0f),
+						Point2F(static_cast<float>(x) / size, static_cast<float>(z) / size));
+			}
+		}
+
+		std::vector<std::array<std::size_t, 3>> triangles;
+		for(std::size_t z = 0; z < size - 1; ++z)
+		{
+			for(std::size_t x = 0; x < size - 1; ++x)
+			{
+				const std::size_t v00 = z * size + x;
+				triangles.push_back({{v00, v00 + size, v00 + 1}});
+				triangles.push_back({{v00 + 1, v00 + size, v00 + size + 1}});
+			}
+		}
+		std::shuffle(triangles.begin(), triangles.end(), std::mt19937(seed));
+
+		Mesh::Renderable renderable(0);
+		for(const auto& triangle : triangles)
+		{
+			renderable.indices.insert(renderable.indices.end(), triangle.begin(), triangle.end());
+		}
+		return Mesh(vertices, {}, {renderable});
+	}
+
+	/// The triangles of the provided Mesh by position, each rotated so that its smallest corner comes first
+	std::vector<std::array<float, 9>> triangleSet(const Mesh& mesh)
+	{
+		std::vector<std::array<float, 9>> triangles;
+		const std::vector<std::size_t>& indices = mesh.getMeshes()[0].indices;
+		for(std::size_t i = 0; i < indices.size(); i += 3)
+		{
+			std::array<std::array<float, 3>, 3> corners;
+			for(std::size_t j = 0; j < 3; ++j)
+			{
+				const Point3F& position = mesh.getVertices()[indices[i + j]].getPosition();
+				corners[j] = {{position[0], position[1], position[2]}};
+			}
+			std::rotate(corners.begin(), std::min_element(corners.begin(), corners.end()), corners.end());
+			triangles.push_back({{corners[0][0], corners[0][1], corners[0][2], corners[1][0], corners[1][1], corners[1][2],
+					corners[2][0], corners[2][1], corners[2][2]}});
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+
+	/// Appends a separate grid of size x size quads, spanning the provided axes from the provided corner, and facing 
+	/// along their cross product
+	void appendPatch(std::vector<Vertex32F>& vertices, std::vector<std::size_t>& indices, std::size_t size, const Point3F& corner,
+			const Vector3F& u, const Vector3F& v)
+	{
+		const std::size_t first = vertices.size();
+		const Vector3F normal = cross(u, v);
+		for(std::size_t y = 0; y <= size; ++y)
+		{
+			for(std::size_t x = 0; x <= size; ++x)
+			{
+				const float s = static_cast<float>(x) / size;
+				const float t = static_cast<float>(y) / size;
+				const Point3F position(corner[0] + s * u[0] + t * v[0], corner[1] + s * u[1] + t * v[1], corner[2] + s * u[2] + t * v[2]);
+				vertices.emplace_back(position, normal, Point2F(s, t));
+			}
+		}
+		for(std::size_t y = 0; y < size; ++y)
+		{
+			for(std::size_t x = 0; x < size; ++x)
+			{
+				const std::size_t v00 = first + y * (size + 1) + x;
+				indices.insert(indices.end(), {v00, v00 + 1, v00 + size + 2, v00, v00 + size + 2, v00 + size + 1});
+			}
+		}
+	}
+
+	/// The triangles of the provided triangle list, each rotated so that its smallest index comes first
+	std::vector<std::array<std::size_t, 3>> indexTriangles(const std::vector<std::size_t>& indices)
+	{
+		std::vector<std::array<std::size_t, 3>> triangles;
+		for(std::size_t i = 0; i < indices.size(); i += 3)
+		{
+			std::array<std::size_t, 3> triangle = {{indices[i], indices[i + 1], indices[i + 2]}};
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+			triangles.push_back(triangle);
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+}
+
+TEST(MeshOptimizer, VertexCache)
+{
+	Mesh mesh = shuffledGrid(64, 1);
+	std::vector<std::size_t> indices = mesh.getMeshes()[0].indices;
+	const float before = computeACMR(indices, mesh.getVertices().size());
+	optimizeVertexCache(indices, mesh.getVertices().size());
+	const float after = computeACMR(indices, mesh.getVertices().size());
+
+	/// Shuffled triangles miss almost every time, while a regular grid can approach 0.5 misses per triangle
+	ASSERT_GT(before, 2.5f);
+	ASSERT_LT(after, 0.8f);
+
+	std::vector<std::size_t> sorted = indices;
+	std::vector<std::size_t> original = mesh.getMeshes()[0].indices;
+	std::sort(sorted.begin(), sorted.end());
+	std::sort(original.begin(), original.end());
+	ASSERT_EQ(original, sorted);
+}
+
+TEST(MeshOptimizer, Overdraw)
+{
+	/// Patches facing the centre from x = +-1, listed first, and patches facing away from it at x = +-2 - the latter 
+	/// occlude the former from any viewpoint outside, so should be drawn first
+	std::vector<Vertex32F> vertices;
+	std::vector<std::size_t> indices;
+	appendPatch(vertices, indices, 8, Point3F(1.0f, -1.0f, -1.0f), Vector3F(0.0f, 0.0f, 2.0f), Vector3F(0.0f, 2.0f, 0.0f));
+	appendPatch(vertices, indices, 8, Point3F(-1.0f, -1.0f, -1.0f), Vector3F(0.0f, 2.0f, 0.0f), Vector3F(0.0f, 0.0f, 2.0f));
+	const std::size_t inwardCount = indices.size();
+	appendPatch(vertices, indices, 8, Point3F(2.0f, -1.0f, -1.0f), Vector3F(0.0f, 2.0f, 0.0f), Vector3F(0.0f, 0.0f, 2.0f));
+	appendPatch(vertices, indices, 8, Point3F(-2.0f, -1.0f, -1.0f), Vector3F(0.0f, 0.0f, 2.0f), Vector3F(0.0f, 2.0f, 0.0f));
+	const std::size_t inwardVertices = vertices.size() / 2;
+	ASSERT_EQ(indices.size(), 2 * inwardCount);
+
+	optimizeVertexCache(indices, vertices.size());
+	const std::vector<std::size_t> cached = indices;
+	const float before = computeACMR(indices, vertices.size());
+	optimizeOverdraw(indices, vertices);
+	ASSERT_EQ(indexTriangles(cached), indexTriangles(indices));
+	ASSERT_LE(computeACMR(indices, vertices.size()), before * 1.05f);
+	for(std::size_t i = 0; i < indices.size(); ++i)
+	{
+		ASSERT_EQ(i < inwardCount, indices[i] >= inwardVertices);
+	}
+
+	/// A threshold that no reordering can meet leaves the triangles as they were
+	indices = cached;
+	optimizeOverdraw(indices, vertices, 0.5f);
+	ASSERT_EQ(cached, indices);
+}
+
+TEST(MeshOptimizer, InvalidTriangleList)
+{
+	std::vector<std::size_t> indices = {0, 1};
+	ASSERT_THROW(optimizeVertexCache(indices, 3), IllegalArgumentException);
+	indices = {0, 1, 3};
+	ASSERT_THROW(computeACMR(indices, 3), IllegalArgumentException);
+}
+
+TEST(MeshOptimizer, Optimize)
+{
+	Mesh mesh = shuffledGrid(48, 2);
+	const std::vector<std::array<float, 9>> before = triangleSet(mesh);
+	mesh.optimize();
+	ASSERT_EQ(before, triangleSet(mesh));
+	ASSERT_LT(computeACMR(mesh.getMeshes()[0].indices, mesh.getVertices().size()), 0.8f);
+
+	/// Vertices are fetched in order of first use
+	std::size_t next = 0;
+	for(std::size_t index : mesh.getMeshes()[0].indices)
+	{
+		ASSERT_LE(index, next);
+		next = std::max(next, index + 1);
+	}
+}
+
+TEST(MeshOptimizer, Weld)
+{
+	/// One vertex per triangle corner, as many exporters emit
+	Mesh indexed = shuffledGrid(32, 3);
+	std::vector<Vertex32F> corners;
+	Mesh::Renderable renderable(0);
+	for(std::size_t index : indexed.getMeshes()[0].indices)
+	{
+		Vertex32F vertex = indexed.getVertices()[index];
+		/// Jitter well within the epsilon, away from the grid lines
+		vertex.getTexCoord()[1] += (corners.size() % 5) * 1e-5f;
+		renderable.indices.push_back(corners.size());
+		corners.push_back(vertex);
+	}
+	Mesh mesh(corners, {}, {renderable});
+	const std::vector<std::array<float, 9>> before = triangleSet(mesh);
+
+	/// Exact welding keeps the jittered copies apart
+	std::vector<std::size_t> remap;
+	ASSERT_LT(32u * 32u, weldVertices(mesh.getVertices(), remap, 0.0f));
+
+	ASSERT_EQ(31u * 31u * 6u, mesh.getVertices().size());
+	ASSERT_EQ(32u * 32u, mesh.weld(1.0f / 1024.0f, 4));
+	ASSERT_EQ(32u * 32u, mesh.getVertices().size());
+	ASSERT_EQ(before, triangleSet(mesh));
+}
+
+TEST(MeshOptimizer, WeldThreadCountIndependence)
+{
+	std::mt19937 generator(4);
+	std::uniform_int_distribution<int> coordinate(0, 20);
+	std::vector<Vertex32F> vertices;
+	for(int i = 0; i < 20000; ++i)
+	{
+		vertices.emplace_back(Point3F(static_cast<float>(coordinate(generator)), static_cast<float>(coordinate(generator)), 0.0f),
+				Vector3F(0.0f, 0.0f, 1.0f), Point2F(0.0f, 0.0f));
+	}
+
+	std::vector<std::size_t> single;
+	std::vector<std::size_t> multiple;
+	ASSERT_EQ(21u * 21u, weldVertices(vertices, single, 0.5f, 1));
+	ASSERT_EQ(21u * 21u, weldVertices(vertices, multiple, 0.5f, 8));
+	ASSERT_EQ(single, multiple);
+	ASSERT_THROW(weldVertices(vertices, single, -1.0f), IllegalArgumentException);
+}
+
+namespace
+{
+	/// A unit cube whose faces share its eight corners (vertex i lies at (i & 1, (i >> 1) & 1, i >> 2))
+	Mesh cube()
+	{
+		std::vector<Vertex32F> vertices;
+		for(std::size_t i = 0; i < 8; ++i)
+		{
+			vertices.emplace_back(Point3F(static_cast<float>(i & 1), static_cast<float>((i >> 1) & 1), static_cast<float>(i >> 2)),
+					Vector3F(0.0f, 0.0f, 0.0f), Point2F(0.0f, 0.0f));
+		}
+		Mesh::Renderable renderable(0);
+		renderable.indices =
+		{
+			0, 2, 3, 0, 3, 1,
+			4, 5, 7, 4, 7, 6,
+			0, 4, 6, 0, 6, 2,
+			1, 3, 7, 1, 7, 5,
+			0, 1, 5, 0, 5, 4,
+			2, 6, 7, 2, 7, 3
+		};
+		return Mesh(vertices, {}, {renderable});
+	}
+}
+
+TEST(MeshOptimizer, Normals)
+{
+	/// Angle weighting is independent of how each face is triangulated, so every corner points along its diagonal
+	Mesh mesh = cube();
+	ASSERT_FALSE(mesh.hasValidNormals());
+	mesh.recomputeNormals(NormalWeighting::ANGLE);
+	ASSERT_TRUE(mesh.hasValidNormals());
+	const float diagonal = 1.0f / std::sqrt(3.0f);
+	for(std::size_t i = 0; i < 8; ++i)
+	{
+		const Vector3F& normal = mesh.getVertices()[i].getNormal();
+		ASSERT_NEAR((i & 1) ? diagonal : -diagonal, normal[0], 1e-5f);
+		ASSERT_NEAR(((i >> 1) & 1) ? diagonal : -diagonal, normal[1], 1e-5f);
+		ASSERT_NEAR((i >> 2) ? diagonal : -diagonal, normal[2], 1e-5f);
+	}
+
+	/// Area weighting is not, as vertex 3 touches both triangles of its -z face but one of each other face
+	mesh.recomputeNormals(NormalWeighting::AREA);
+	const Vector3F& normal = mesh.getVertices()[3].getNormal();
+	const float sixth = 1.0f / std::sqrt(6.0f);
+	ASSERT_NEAR(sixth, normal[0], 1e-5f);
+	ASSERT_NEAR(sixth, normal[1], 1e-5f);
+	ASSERT_NEAR(-2.0f * sixth, normal[2], 1e-5f);
+
+	/// A flat grid keeps its normals, and unused vertices keep theirs
+	Mesh grid = shuffledGrid(8, 1);
+	const std::vector<float> normals = computeVertexNormals(grid.getVertices(), {0, 8, 1});
+	ASSERT_FLOAT_EQ(1.0f, normals[1]);
+	ASSERT_FLOAT_EQ(1.0f, normals[2 * 3 + 1]);
+}
+
+TEST(MeshOptimizer, Tangents)
+{
+	const Mesh grid = shuffledGrid(8, 2);
+	const std::vector<float> tangents = grid.computeTangents();
+	ASSERT_EQ(grid.getVertices().size() * 4, tangents.size());
+	for(std::size_t v = 0; v < grid.getVertices().size(); ++v)
+	{
+		/// u increases along +x and v along +z, which is opposite to normal x tangent (-z)
+		ASSERT_NEAR(1.0f, tangents[v * 4], 1e-5f);
+		ASSERT_NEAR(0.0f, tangents[v * 4 + 1], 1e-5f);
+		ASSERT_NEAR(0.0f, tangents[v * 4 + 2], 1e-5f);
+		ASSERT_EQ(-1.0f, tangents[v * 4 + 3]);
+	}
+
+	/// Without texture coordinates, the tangent is still a unit vector perpendicular to the normal
+	Mesh mesh = cube();
+	mesh.recomputeNormals();
+	const std::vector<float> fallback = mesh.computeTangents();
+	for(std::size_t v = 0; v < 8; ++v)
+	{
+		const Vector3F& normal = mesh.getVertices()[v].getNormal();
+		const float* tangent = &fallback[v * 4];
+		ASSERT_NEAR(1.0f, std::sqrt(tangent[0] * tangent[0] + tangent[1] * tangent[1] + tangent[2] * tangent[2]), 1e-5f);
+		ASSERT_NEAR(0.0f, tangent[0] * normal[0] + tangent[1] * normal[1] + tangent[2] * normal[2], 1e-5f);
+	}
+}
+
+TEST(MeshOptimizer, NormalsThreadCountIndependence)
+{
+	const Mesh grid = shuffledGrid(64, 3);
+	std::vector<std::size_t> indices = grid.getMeshes()[0].indices;
+	ASSERT_EQ(computeVertexNormals(grid.getVertices(), indices, NormalWeighting::AREA_AND_ANGLE, 1),
+			computeVertexNormals(grid.getVertices(), indices, NormalWeighting::AREA_AND_ANGLE, 7));
+	ASSERT_EQ(computeVertexTangents(grid.getVertices(), indices, 1), computeVertexTangents(grid.getVertices(), indices, 7));
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <set>
+
+#include "Meshlet.hpp"
+#include "IllegalArgumentException.hpp"
+using namespace midnight;
+
+namespace
+{
+	/// A flat grid of size x size quads in the XY plane, facing +Z
+	void grid(std::size_t size, std::vector<Vertex32F>& vertices, std::vector<std::size_t>& indices)
+	{
+		for(std::size_t y = 0; y <= size; ++y)
+		{
+			for(std::size_t x = 0; x <= size; ++x)
+			{
+				vertices.emplace_back(Point3F(static_cast<float>(x), static_cast<float>(y), 0.0f), Vector3F(0.0f, 0.0f, 1.0f), Point2F(0.0f, 0.0f));
+			}
+		}
+		for(std::size_t y = 0; y < size; ++y)
+		{
+			for(std::size_t x = 0; x < size; ++x)
+			{
+				const std::size_t v = y * (size + 1) + x;
+				indices.insert(indices.end(), {v, v + 1, v + size + 2, v, v + size + 2, v + size + 1});
+			}
+		}
+	}
+
+	std::multiset<std::array<std::size_t, 3>> triangleSet(const std::vector<std::size_t>& indices)
+	{
+		std::multiset<std::array<std::size_t, 3>> triangles;
+		for(std::size_t i = 0; i < indices.size(); i += 3)
+		{
+			triangles.insert({{indices[i], indices[i + 1], indices[i + 2]}});
+		}
+		return triangles;
+	}
+}
+
+TEST(Meshlet, Partition)
+{
+	std::vector<Vertex32F> vertices;
+	std::vector<std::size_t> indices;
+	grid(32, vertices, indices);
+	const std::vector<std::size_t> original = indices;
+
+	const std::vector<Meshlet> meshlets = buildMeshlets(indices, vertices, 64, 48);
+
+	/// Every triangle survives, and the Meshlets tile the indices in order
+	ASSERT_EQ(triangleSet(original), triangleSet(indices));
+	std::size_t next = 0;
+	for(const Meshlet& meshlet : meshlets)
+	{
+		ASSERT_EQ(next, meshlet.firstIndex);
+		ASSERT_GT(meshlet.indexCount, 0u);
+		ASSERT_LE(meshlet.indexCount, 64u * 3);
+		next += meshlet.indexCount;
+
+		const std::set<std::size_t> distinct(indices.begin() + meshlet.firstIndex, indices.begin() + meshlet.firstIndex + meshlet.indexCount);
+		ASSERT_LE(distinct.size(), 48u);
+
+		/// The bounding sphere holds every vertex
+		for(std::size_t vertex : distinct)
+		{
+			const Point3F& position = vertices[vertex].getPosition();
+			const float dx = position[0] - meshlet.center[0];
+			const float dy = position[1] - meshlet.center[1];
+			const float dz = position[2] - meshlet.center[2];
+			ASSERT_LE(std::sqrt(dx * dx + dy * dy + dz * dz), meshlet.radius * 1.0001f);
+		}
+	}
+	ASSERT_EQ(indices.size(), next);
+
+	/// 2048 triangles should need few more than the 32 Meshlets that a perfect packing would
+	ASSERT_LE(meshlets.size(), 48u);
+}
+
+TEST(Meshlet, Culling)
+{
+	std::vector<Vertex32F> vertices;
+	std::vector<std::size_t> indices;
+	grid(4, vertices, indices);
+
+	const std::vector<Meshlet> meshlets = buildMeshlets(indices, vertices);
+	ASSERT_EQ(1u, meshlets.size());
+	const Meshlet& meshlet = meshlets[0];
+	ASSERT_NEAR(1.0f, meshlet.coneAxis[2], 1e-6f);
+	ASSERT_NEAR(0.0f, meshlet.coneCutoff, 1e-3f);
+
+	const float above[3] = {2.0f, 2.0f, 10.0f};
+	const float below[3] = {2.0f, 2.0f, -10.0f};
+	const float beside[3] = {20.0f, 2.0f, -0.5f};
+	ASSERT_FALSE(isBackFacing(meshlet, above));
+	ASSERT_TRUE(isBackFacing(meshlet, below));
+	ASSERT_FALSE(isBackFacing(meshlet, beside));
+
+	const float inside[1][4] = {{1.0f, 0.0f, 0.0f, 0.0f}};
+	const float outside[2][4] = {{0.0f, 0.0f, 1.0f, 0.0f}, {-1.0f, 0.0f, 0.0f, -10.0f}};
+	ASSERT_FALSE(isOutside(meshlet, inside, 1));
+	ASSERT_TRUE(isOutside(meshlet, outside, 2));
+}
+
+TEST(Meshlet, FoldedConeNeverCulls)
+{
+	/// Two triangles facing in opposite directions
+	std::vector<Vertex32F> vertices =
+	{
+		Vertex32F(Point3F(0.0f, 0.0f, 0.0f), Vector3F(), Point2F()),
+		Vertex32F(Point3F(1.0f, 0.0f, 0.0f), Vector3F(), Point2F()),
+		Vertex32F(Point3F(0.0f, 1.0f, 0.0f), Vector3F(), Point2F())
+	};
+	std::vector<std::size_t> indices = {0, 1, 2, 0, 2, 1};
+	const std::vector<Meshlet> meshlets = buildMeshlets(indices, vertices);
+	ASSERT_EQ(1u, meshlets.size());
+	ASSERT_EQ(1.0f, meshlets[0].coneCutoff);
+
+	const float eye[3] = {0.0f, 0.0f, -10.0f};
+	ASSERT_FALSE(isBackFacing(meshlets[0], eye));
+}
+
+TEST(Meshlet, InvalidArguments)
+{
+	std::vector<Vertex32F> vertices;
+	std::vector<std::size_t> indices;
+	grid(1, vertices, indices);
+
+	ASSERT_THROW(buildMeshlets(indices, vertices, 0, 64), IllegalArgumentException);
+	ASSERT_THROW(buildMeshlets(indices, vertices, 64, 2), IllegalArgumentException);
+	indices.push_back(0);
+	ASSERT_THROW(buildMeshlets(indices, vertices), IllegalArgumentException);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include "StaticBatch.hpp"
+#include "StaticBatchNode.hpp"
+using namespace midnight;
+
+namespace
+{
+	/// A unit square in the XY plane facing +Z, split into two sub-meshes of the provided Materials
+	Mesh square(const Material& first, const Material& second)
+	{
+		std::vector<Vertex32F> vertices =
+		{
+			Vertex32F(Point3F(0.0f, 0.0f, 0.0f), Vector3F(0.0f, 0.0f, 1.0f), Point2F(0.0f, 0.0f)),
+			Vertex32F(Point3F(1.0f, 0.0f, 0.0f), Vector3F(0.0f, 0.0f, 1.0f), Point2F(1.0f, 0.0f)),
+			Vertex32F(Point3F(1.0f, 1.0f, 0.0f), Vector3F(0.0f, 0.0f, 1.0f), Point2F(1.0f, 1.0f)),
+			Vertex32F(Point3F(0.0f, 1.0f, 0.0f), Vector3F(0.0f, 0.0f, 1.0f), Point2F(0.0f, 1.0f))
+		};
+		std::vector<Mesh::Renderable> renderables = {Mesh::Renderable(0), Mesh::Renderable(1)};
+		renderables[0].indices = {0, 1, 2};
+		renderables[1].indices = {0, 2, 3};
+		return Mesh(vertices, {first, second}, renderables);
+	}
+
+	Matrix4x4F transformation(float scaleX, float scaleY, float scaleZ, float x, float y, float z)
+	{
+		Matrix4x4F matrix = Matrix4x4F::IDENTITY();
+		matrix(0, 0) = scaleX;
+		matrix(1, 1) = scaleY;
+		matrix(2, 2) = scaleZ;
+		return matrix.translate(Vector<float, 4>(x, y, z, 0.0f));
+	}
+}
+
+TEST(StaticBatch, Groups)
+{
+	const Material red(LightingMode::DIFFUSE, CullingMode::CULL_BACK_FACES, true, Color<float, 4>(1.0f, 0.0f, 0.0f, 1.0f));
+	const Material blue(LightingMode::DIFFUSE, CullingMode::CULL_BACK_FACES, true, Color<float, 4>(0.0f, 0.0f, 1.0f, 1.0f));
+
+	StaticBatch batch;
+	ASSERT_EQ(0u, batch.add(square(red, blue)));
+	ASSERT_EQ(2u, batch.add(square(blue, red), transformation(1.0f, 1.0f, 1.0f, 5.0f, 0.0f, 0.0f)));
+
+	ASSERT_EQ(8u, batch.getVertexCount());
+	ASSERT_EQ(2u, batch.getGroups().size());
+	ASSERT_EQ(4u, batch.getRanges().size());
+
+	/// Each Material gathers one sub-mesh of each square, rebased onto the vertices of its square
+	ASSERT_EQ((std::vector<uint32_t>{0, 1, 2, 4, 6, 7}), batch.getGroups()[0].indices);
+	ASSERT_EQ((std::vector<uint32_t>{0, 2, 3, 4, 5, 6}), batch.getGroups()[1].indices);
+
+	const std::vector<StaticBatch::Range>& ranges = batch.getRanges();
+	ASSERT_EQ(0u, ranges[0].group);
+	ASSERT_EQ(0u, ranges[0].firstIndex);
+	ASSERT_EQ(1u, ranges[2].group);
+	ASSERT_EQ(3u, ranges[2].firstIndex);
+	ASSERT_EQ(3u, ranges[2].indexCount);
+	ASSERT_EQ(0u, ranges[3].group);
+	ASSERT_EQ(3u, ranges[3].firstIndex);
+}
+
+TEST(StaticBatch, Transformation)
+{
+	const Material material;
+
+	StaticBatch batch;
+	batch.add(square(material, material), transformation(2.0f, 4.0f, 1.0f, 10.0f, 20.0f, 30.0f));
+
+	/// The third vertex, (1, 1, 0), is scaled and translated - its normal is unaffected
+	const float* vertex = &batch.getVertices()[2 * Mesh::INTERLEAVED_SIZE];
+	ASSERT_FLOAT_EQ(12.0f, vertex[0]);
+	ASSERT_FLOAT_EQ(24.0f, vertex[1]);
+	ASSERT_FLOAT_EQ(30.0f, vertex[2]);
+	ASSERT_FLOAT_EQ(0.0f, vertex[3]);
+	ASSERT_FLOAT_EQ(0.0f, vertex[4]);
+	ASSERT_FLOAT_EQ(1.0f, vertex[5]);
+	ASSERT_FLOAT_EQ(1.0f, vertex[6]);
+	ASSERT_FLOAT_EQ(1.0f, vertex[7]);
+
+	/// The first triangle spans (10, 20) to (12, 24)
+	const StaticBatch::Range& range = batch.getRanges()[0];
+	ASSERT_FLOAT_EQ(11.0f, range.center[0]);
+	ASSERT_FLOAT_EQ(22.0f, range.center[1]);
+	ASSERT_FLOAT_EQ(30.0f, range.center[2]);
+	ASSERT_FLOAT_EQ(std::sqrt(5.0f), range.radius);
+}
+
+TEST(StaticBatch, Mirroring)
+{
+	const Material material;
+
+	StaticBatch batch;
+	batch.add(square(material, material), transformation(1.0f, 1.0f, -1.0f, 0.0f, 0.0f, 0.0f));
+
+	/// A mirrored square faces -Z and keeps its front faces by reversing its winding
+	const float* vertex = &batch.getVertices()[0];
+	ASSERT_FLOAT_EQ(-1.0f, vertex[5]);
+	ASSERT_EQ((std::vector<uint32_t>{0, 2, 1, 0, 3, 2}), batch.getGroups()[0].indices);
+}
+
+TEST(StaticBatch, VisibleRanges)
+{
+	const Material red(LightingMode::DIFFUSE, CullingMode::CULL_BACK_FACES, true, Color<float, 4>(1.0f, 0.0f, 0.0f, 1.0f));
+	const Material blue(LightingMode::DIFFUSE, CullingMode::CULL_BACK_FACES, true, Color<float, 4>(0.0f, 0.0f, 1.0f, 1.0f));
+
+	/// Red Ranges 0, 2 and 4 hold indices 0 to 8, and blue Ranges 1, 3 and 5 hold indices 9 to 17
+	StaticBatch batch;
+	for(std::size_t i = 0; i < 3; ++i)
+	{
+		batch.add(square(red, blue));
+	}
+	const midnight::detail::StaticBatchRanges ranges(batch);
+	ASSERT_EQ(6u, ranges.getRanges().size());
+
+	/// Every Range is adjacent to the next, across the Groups too
+	std::vector<bool> visible(6, true);
+	DrawCommandBuffer commands;
+	ranges.addDraws(visible, 100, 7, commands);
+	ASSERT_EQ(1u, commands.getCommands().size());
+	ASSERT_EQ(18u, commands.getCommands()[0].count);
+	ASSERT_EQ(100u, commands.getCommands()[0].firstIndex);
+	ASSERT_EQ(7, commands.getCommands()[0].baseVertex);
+
+	/// Hiding a Range splits its run, and the last red Range still continues into the blue ones
+	visible[2] = false;
+	visible[3] = false;
+	commands.clear();
+	ranges.addDraws(visible, 100, 7, commands);
+	ASSERT_EQ(3u, commands.getCommands().size());
+	const GLuint counts[] = {3, 6, 3};
+	const GLuint firstIndices[] = {100, 106, 115};
+	for(std::size_t i = 0; i < 3; ++i)
+	{
+		ASSERT_EQ(counts[i], commands.getCommands()[i].count);
+		ASSERT_EQ(firstIndices[i], commands.getCommands()[i].firstIndex);
+	}
+
+	commands.clear();
+	ranges.addDraws(std::vector<bool>(6, false), 100, 7, commands);
+	ASSERT_TRUE(commands.getCommands().empty());
+}
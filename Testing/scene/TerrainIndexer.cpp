@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include "TerrainIndexer.hpp"
+using namespace midnight;
+
+TEST(TerrainIndexer, TooSmall)
+{
+	ASSERT_THROW(TerrainIndexer(1, 10), IllegalArgumentException);
+	ASSERT_THROW(TerrainIndexer(10, 1), IllegalArgumentException);
+}
+
+TEST(TerrainIndexer, TooWide)
+{
+	ASSERT_THROW(TerrainIndexer(70000, 2), IllegalArgumentException);
+}
+
+TEST(TerrainIndexer, SingleQuad)
+{
+	TerrainIndexer indexer(2, 2);
+	ASSERT_EQ(1u, indexer.getTiles().size());
+	ASSERT_EQ(4u, indexer.getIndices().size());
+	ASSERT_EQ(0u, indexer.getIndices()[0]);
+	ASSERT_EQ(2u, indexer.getIndices()[1]);
+	ASSERT_EQ(1u, indexer.getIndices()[2]);
+	ASSERT_EQ(3u, indexer.getIndices()[3]);
+}
+
+TEST(TerrainIndexer, TilesCoverEveryQuad)
+{
+	const std::size_t width = 300;
+	const std::size_t height = 400;
+	TerrainIndexer indexer(width, height);
+
+	std::vector<unsigned char> covered((width - 1) * (height - 1), 0);
+	std::size_t next = 0;
+	for(const TerrainIndexer::Tile& tile : indexer.getTiles())
+	{
+		/// Tiles are contiguous and end exactly where the indices end
+		ASSERT_EQ(next, tile.first);
+		next = tile.first + tile.count;
+
+		std::size_t strip = tile.first;
+		for(std::size_t i = tile.first; i < tile.first + tile.count; ++i)
+		{
+			if(indexer.getIndices()[i] == TerrainIndexer::RESTART_INDEX)
+			{
+				strip = i + 1;
+				continue;
+			}
+			/// The second index of every column pair closes the quad whose top-left vertex is three indices back
+			if((i - strip) % 2 == 1 && i - strip > 1)
+			{
+				std::size_t vertex = tile.baseVertex + indexer.getIndices()[i - 3];
+				++covered[(vertex / width) * (width - 1) + vertex % width];
+			}
+		}
+	}
+	ASSERT_EQ(indexer.getIndices().size(), next);
+	for(unsigned char count : covered)
+	{
+		ASSERT_EQ(1, count);
+	}
+}
@@ -43,7 +43,8 @@ TESTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}/tests
 # Test Files
 TESTFILES= \
 	${TESTDIR}/TestFiles/f1 \
-	${TESTDIR}/TestFiles/f2
+	${TESTDIR}/TestFiles/f2 \
+	${TESTDIR}/TestFiles/f3
 
 # C Compiler Flags
 CFLAGS=
@@ -79,7 +80,7 @@ ${OBJECTDIR}/main.o: main.cpp
 
 # Build Test Targets
 .build-tests-conf: .build-conf ${TESTFILES}
-${TESTDIR}/TestFiles/f1: ${TESTDIR}/Testing/core/Color.o ${TESTDIR}/Testing/core/Point.o ${TESTDIR}/Testing/core/Tuple.o ${TESTDIR}/Testing/core/Vector.o ${OBJECTFILES:%.o=%_nomain.o}
+${TESTDIR}/TestFiles/f1: ${TESTDIR}/Testing/core/BufferArena.o ${TESTDIR}/Testing/core/Color.o ${TESTDIR}/Testing/core/DirtyRangeSet.o ${TESTDIR}/Testing/core/DrawCommandBuffer.o ${TESTDIR}/Testing/core/IndexBuffer.o ${TESTDIR}/Testing/core/Point.o ${TESTDIR}/Testing/core/RangeAllocator.o ${TESTDIR}/Testing/core/RegionRing.o ${TESTDIR}/Testing/core/Tuple.o ${TESTDIR}/Testing/core/UploadQueue.o ${TESTDIR}/Testing/core/Vector.o ${OBJECTFILES:%.o=%_nomain.o}
 	${MKDIR} -p ${TESTDIR}/TestFiles
 	${LINK.cc}   -o ${TESTDIR}/TestFiles/f1 $^ ${LDLIBSOPTIONS} -LTesting/gtest\ 1.7.0 -lgtest -lpthread `pkg-config --libs gl` `pkg-config --libs glew` `pkg-config --libs glu` -lfreeglut   
 
@@ -87,6 +88,10 @@ ${TESTDIR}/TestFiles/f2: ${TESTDIR}/Testing/glsl/Shader.o ${OBJECTFILES:%.o=%_no
 	${MKDIR} -p ${TESTDIR}/TestFiles
 	${LINK.cc}   -o ${TESTDIR}/TestFiles/f2 $^ ${LDLIBSOPTIONS} -LTesting/gtest\ 1.7.0 -lgtest -lpthread `pkg-config --libs gl` `pkg-config --libs glew` `pkg-config --libs glu` -lfreeglut   
 
+${TESTDIR}/TestFiles/f3: ${TESTDIR}/Testing/scene/Camera.o ${TESTDIR}/Testing/scene/HalfEdgeMesh.o ${TESTDIR}/Testing/scene/Heightmap.o ${TESTDIR}/Testing/scene/HeightmapGenerator.o ${TESTDIR}/Testing/scene/HeightmapPyramid.o ${TESTDIR}/Testing/scene/Mesh.o ${TESTDIR}/Testing/scene/MeshCache.o ${TESTDIR}/Testing/scene/MeshCodec.o ${TESTDIR}/Testing/scene/MeshOptimizer.o ${TESTDIR}/Testing/scene/Meshlet.o ${TESTDIR}/Testing/scene/StaticBatch.o ${TESTDIR}/Testing/scene/TerrainIndexer.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc}   -o ${TESTDIR}/TestFiles/f3 $^ ${LDLIBSOPTIONS} -LTesting/gtest\ 1.7.0 -lgtest -lpthread `pkg-config --libs gl` `pkg-config --libs glew` `pkg-config --libs glu` -lfreeglut   
+
 
 ${TESTDIR}/Testing/core/Color.o: Testing/core/Color.cpp 
 	${MKDIR} -p ${TESTDIR}/Testing/core
@@ -118,6 +123,120 @@ ${TESTDIR}/Testing/glsl/Shader.o: Testing/glsl/Shader.cpp
 	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/glsl/Shader.o Testing/glsl/Shader.cpp
 
 
+${TESTDIR}/Testing/scene/TerrainIndexer.o: Testing/scene/TerrainIndexer.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/scene
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/scene/TerrainIndexer.o Testing/scene/TerrainIndexer.cpp
+
+
+${TESTDIR}/Testing/scene/HeightmapPyramid.o: Testing/scene/HeightmapPyramid.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/scene
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/scene/HeightmapPyramid.o Testing/scene/HeightmapPyramid.cpp
+
+
+${TESTDIR}/Testing/scene/HeightmapGenerator.o: Testing/scene/HeightmapGenerator.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/scene
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/scene/HeightmapGenerator.o Testing/scene/HeightmapGenerator.cpp
+
+
+${TESTDIR}/Testing/scene/Heightmap.o: Testing/scene/Heightmap.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/scene
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/scene/Heightmap.o Testing/scene/Heightmap.cpp
+
+
+${TESTDIR}/Testing/scene/Mesh.o: Testing/scene/Mesh.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/scene
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/scene/Mesh.o Testing/scene/Mesh.cpp
+
+
+${TESTDIR}/Testing/scene/MeshOptimizer.o: Testing/scene/MeshOptimizer.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/scene
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/scene/MeshOptimizer.o Testing/scene/MeshOptimizer.cpp
+
+
+${TESTDIR}/Testing/scene/MeshCache.o: Testing/scene/MeshCache.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/scene
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/scene/MeshCache.o Testing/scene/MeshCache.cpp
+
+
+${TESTDIR}/Testing/core/IndexBuffer.o: Testing/core/IndexBuffer.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/core
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/core/IndexBuffer.o Testing/core/IndexBuffer.cpp
+
+
+${TESTDIR}/Testing/scene/StaticBatch.o: Testing/scene/StaticBatch.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/scene
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/scene/StaticBatch.o Testing/scene/StaticBatch.cpp
+
+
+${TESTDIR}/Testing/scene/Meshlet.o: Testing/scene/Meshlet.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/scene
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/scene/Meshlet.o Testing/scene/Meshlet.cpp
+
+
+${TESTDIR}/Testing/scene/HalfEdgeMesh.o: Testing/scene/HalfEdgeMesh.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/scene
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/scene/HalfEdgeMesh.o Testing/scene/HalfEdgeMesh.cpp
+
+
+${TESTDIR}/Testing/scene/MeshCodec.o: Testing/scene/MeshCodec.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/scene
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/scene/MeshCodec.o Testing/scene/MeshCodec.cpp
+
+
+${TESTDIR}/Testing/scene/Camera.o: Testing/scene/Camera.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/scene
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/scene/Camera.o Testing/scene/Camera.cpp
+
+
+${TESTDIR}/Testing/core/DirtyRangeSet.o: Testing/core/DirtyRangeSet.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/core
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/core/DirtyRangeSet.o Testing/core/DirtyRangeSet.cpp
+
+
+${TESTDIR}/Testing/core/RangeAllocator.o: Testing/core/RangeAllocator.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/core
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/core/RangeAllocator.o Testing/core/RangeAllocator.cpp
+
+
+${TESTDIR}/Testing/core/UploadQueue.o: Testing/core/UploadQueue.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/core
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/core/UploadQueue.o Testing/core/UploadQueue.cpp
+
+
+${TESTDIR}/Testing/core/RegionRing.o: Testing/core/RegionRing.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/core
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/core/RegionRing.o Testing/core/RegionRing.cpp
+
+
+${TESTDIR}/Testing/core/BufferArena.o: Testing/core/BufferArena.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/core
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/core/BufferArena.o Testing/core/BufferArena.cpp
+
+
+${TESTDIR}/Testing/core/DrawCommandBuffer.o: Testing/core/DrawCommandBuffer.cpp 
+	${MKDIR} -p ${TESTDIR}/Testing/core
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -ISource/Interface/core -ISource/Interface/glsl -ISource/Interface/io -ISource/Interface/scene -ISource/Interface/texture -ISource/Interface/util -ISource/Implementation/core -ISource/Implementation/glsl -ISource/Implementation/scene -ITesting/gtest\ 1.7.0/include -I. -std=c++11 -MMD -MP -MF "$@.d" -o ${TESTDIR}/Testing/core/DrawCommandBuffer.o Testing/core/DrawCommandBuffer.cpp
+
+
 ${OBJECTDIR}/main_nomain.o: ${OBJECTDIR}/main.o main.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	@NMOUTPUT=`${NM} ${OBJECTDIR}/main.o`; \
@@ -137,6 +256,7 @@ ${OBJECTDIR}/main_nomain.o: ${OBJECTDIR}/main.o main.cpp
 	then  \
 	    ${TESTDIR}/TestFiles/f1 || true; \
 	    ${TESTDIR}/TestFiles/f2 || true; \
+	    ${TESTDIR}/TestFiles/f3 || true; \
 	else  \
 	    ./${TEST} || true; \
 	fi